@@ -93,7 +93,20 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
         auto cdef = reinterpret_cast<duckdb_libpgquery::PGColumnDef *>(c->data.ptr_value);
         auto centry = BindColumnDefinition(cdef);
         if (cdef->constraints != nullptr) {
-          throw NotImplementedException("constraints not supported");
+          for (auto con = cdef->constraints->head; con != nullptr; con = lnext(con)) {
+            auto constraint = reinterpret_cast<duckdb_libpgquery::PGConstraint *>(con->data.ptr_value);
+            // `USING COMPRESSION dictionary` stores the column as codes into a per-table dictionary
+            if (constraint->contype != duckdb_libpgquery::PG_CONSTR_COMPRESSION) {
+              throw NotImplementedException("constraints not supported");
+            }
+            if (StringUtil::Lower(constraint->compression_name) != "dictionary") {
+              throw NotImplementedException(fmt::format("unsupported compression: {}", constraint->compression_name));
+            }
+            if (centry.GetType() != TypeId::VARCHAR) {
+              throw bustub::Exception("dictionary compression is only supported on varchar columns");
+            }
+            centry.SetDictionaryEncoded(true);
+          }
         }
         columns.push_back(std::move(centry));
         column_count++;
@@ -116,20 +129,40 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
-  std::vector<std::unique_ptr<BoundColumnRef>> cols;
+  std::vector<std::unique_ptr<BoundExpression>> keys;
   auto table = BindBaseTableRef(stmt->relation->relname, std::nullopt);
+  auto ctx_guard = NewContext();
+  scope_ = table.get();
 
   for (auto cell = stmt->indexParams->head; cell != nullptr; cell = cell->next) {
     auto index_element = reinterpret_cast<duckdb_libpgquery::PGIndexElem *>(cell->data.ptr_value);
     if (index_element->name != nullptr) {
-      auto column_ref = ResolveColumn(*table, std::vector{std::string(index_element->name)});
-      cols.emplace_back(std::make_unique<BoundColumnRef>(dynamic_cast<const BoundColumnRef &>(*column_ref)));
+      keys.emplace_back(ResolveColumn(*table, std::vector{std::string(index_element->name)}));
     } else {
-      throw NotImplementedException("create index by expr is not supported yet");
+      keys.emplace_back(BindExpression(index_element->expr));
     }
+    if (keys.back()->HasAggregation()) {
+      throw bustub::Exception("aggregate functions are not allowed in index keys");
+    }
+  }
+
+  // a partial index only holds the rows matching its WHERE clause
+  std::unique_ptr<BoundExpression> where;
+  if (stmt->whereClause != nullptr) {
+    where = BindExpression(stmt->whereClause);
+    if (where->HasAggregation()) {
+      throw bustub::Exception("aggregate functions are not allowed in index predicates");
+    }
+  }
+
+  // an index without a USING clause is a B+ tree
+  std::string index_type = explicit_index_types_.count(stmt) == 0 ? "btree" : stmt->accessMethod;
+  if (index_type != "btree" && index_type != "hash" && index_type != "art") {
+    throw NotImplementedException(fmt::format("index type {} is not supported", index_type));
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(keys), stmt->unique,
+                                          std::move(index_type), std::move(where));
 }
 
 }  // namespace bustub
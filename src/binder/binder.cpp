@@ -20,6 +20,7 @@
 // THE SOFTWARE.
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <unordered_set>
 
@@ -43,6 +44,16 @@ namespace bustub {
 Binder::Binder(const Catalog &catalog) : catalog_(catalog) {}
 
 void Binder::ParseAndSave(const std::string &query) {
+  // without a USING clause the grammar fills in the index type of the database it comes from, so whether CREATE INDEX
+  // picks one is looked up in the query's tokens. The tokenizer resets the parser's memory, it has to run first.
+  std::vector<int32_t> using_locations;
+  for (const auto &token : Tokenize(query)) {
+    if (token.type_ == SimplifiedTokenType::SIMPLIFIED_TOKEN_KEYWORD &&
+        StringUtil::Lower(query.substr(token.start_, 5)) == "using") {
+      using_locations.push_back(token.start_);
+    }
+  }
+
   parser_.Parse(query);
   if (!parser_.success) {
     LOG_INFO("Query failed to parse!");
@@ -56,6 +67,22 @@ void Binder::ParseAndSave(const std::string &query) {
   }
 
   SaveParseTree(parser_.parse_tree);
+
+  for (auto *node : statement_nodes_) {
+    if (node->type != duckdb_libpgquery::T_PGRawStmt) {
+      continue;
+    }
+    auto *raw_stmt = reinterpret_cast<duckdb_libpgquery::PGRawStmt *>(node);
+    if (raw_stmt->stmt->type != duckdb_libpgquery::T_PGIndexStmt) {
+      continue;
+    }
+    int32_t begin = std::max(raw_stmt->stmt_location, 0);
+    auto end = raw_stmt->stmt_len == 0 ? static_cast<int32_t>(query.size()) : begin + raw_stmt->stmt_len;
+    if (std::any_of(using_locations.begin(), using_locations.end(),
+                    [&](int32_t location) { return location >= begin && location < end; })) {
+      explicit_index_types_.insert(reinterpret_cast<duckdb_libpgquery::PGIndexStmt *>(raw_stmt->stmt));
+    }
+  }
 }
 
 auto Binder::IsKeyword(const std::string &text) -> bool { return duckdb::PostgresParser::IsKeyword(text); }
@@ -7,14 +7,20 @@
 namespace bustub {
 
 IndexStatement::IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                               std::vector<std::unique_ptr<BoundColumnRef>> cols)
+                               std::vector<std::unique_ptr<BoundExpression>> keys, bool unique, std::string index_type,
+                               std::unique_ptr<BoundExpression> where)
     : BoundStatement(StatementType::INDEX_STATEMENT),
       index_name_(std::move(index_name)),
       table_(std::move(table)),
-      cols_(std::move(cols)) {}
+      keys_(std::move(keys)),
+      unique_(unique),
+      index_type_(std::move(index_type)),
+      where_(std::move(where)) {}
 
 auto IndexStatement::ToString() const -> std::string {
-  return fmt::format("BoundIndex {{ index_name={}, table={}, cols={} }}", index_name_, *table_, cols_);
+  auto where = where_ == nullptr ? std::string() : fmt::format(", where={}", where_);
+  return fmt::format("BoundIndex {{ index_name={}, table={}, keys={}, unique={}, index_type={}{} }}", index_name_,
+                     *table_, keys_, unique_, index_type_, where);
 }
 
 }  // namespace bustub
@@ -14,6 +14,7 @@
 #include <pthread.h>
 #include <cstddef>
 #include <ostream>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -90,6 +91,10 @@ auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
 
 auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
   std::scoped_lock latch(latch_);
+  // A deleted page may be handed out again, a stale fetch must not give it a frame the next owner does not know about
+  if (disk_manager_->IsFree(page_id)) {
+    return nullptr;
+  }
   // First search for page_id in the buffer pool
   if (page_table_.find(page_id) != page_table_.end()) {
     // find the page
@@ -192,6 +197,7 @@ auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
     return false;
   }
   if (page_table_.find(page_id) == page_table_.end()) {
+    DeallocatePage(page_id);
     return true;
   }
   // If the page is pinned and cannot be deleted, return false immediately
@@ -200,8 +206,35 @@ auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
     return false;
   }
   // delete the page
+  ReleaseFrame(frame_id);
+  DeallocatePage(page_id);
+
+  return true;
+}
+
+auto BufferPoolManager::AllocatePage() -> page_id_t {
+  // an id still in the page table must not get a second frame: drop a stale unpinned copy, skip a pinned one
+  std::vector<page_id_t> skipped;
+  page_id_t page_id = disk_manager_->AllocatePage();
+  while (page_table_.find(page_id) != page_table_.end()) {
+    frame_id_t frame_id = page_table_[page_id];
+    if (pages_[frame_id].GetPinCount() == 0) {
+      ReleaseFrame(frame_id);
+      break;
+    }
+    skipped.push_back(page_id);
+    page_id = disk_manager_->AllocatePage();
+  }
+  for (page_id_t skipped_id : skipped) {
+    DeallocatePage(skipped_id);
+  }
+  return page_id;
+}
+
+void BufferPoolManager::ReleaseFrame(frame_id_t frame_id) {
   // stop tracking the frame in the replacer and add the frame back to the free list
   replacer_->Remove(frame_id);
+  page_table_.erase(pages_[frame_id].page_id_);
 
   pages_[frame_id].ResetMemory();
   pages_[frame_id].is_dirty_ = false;
@@ -209,13 +242,9 @@ auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
   pages_[frame_id].page_id_ = INVALID_PAGE_ID;
 
   free_list_.push_back(frame_id);
-  page_table_.erase(page_id);
-  DeallocatePage(page_id);
-
-  return true;
 }
 
-auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
+void BufferPoolManager::DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
 
 auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard {
   Page *fetchpage = FetchPage(page_id);
@@ -1,6 +1,7 @@
 // DDL (Data Definition Language) statement handling in BusTub, including create table, create index, and set/show
 // variable.
 
+#include <algorithm>
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -27,6 +28,7 @@
 #include "execution/executor_context.h"
 #include "execution/executors/mock_scan_executor.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/column_value_expression.h"
 #include "execution/plans/abstract_plan.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
@@ -36,10 +38,30 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/index/index.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
+namespace {
+
+/** @return the longest VARCHAR column `expr` reads, an upper bound for the length of string expression keys */
+auto MaxVarcharLength(const AbstractExpressionRef &expr, const Schema &schema) -> uint32_t {
+  uint32_t length = 0;
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+    const auto &col = schema.GetColumn(column->GetColIdx());
+    if (col.GetType() == TypeId::VARCHAR) {
+      length = col.GetLength();
+    }
+  }
+  for (const auto &child : expr->GetChildren()) {
+    length = std::max(length, MaxVarcharLength(child, schema));
+  }
+  return length;
+}
+
+}  // namespace
+
 void BustubInstance::HandleCreateStatement(Transaction *txn, const CreateStatement &stmt, ResultWriter &writer) {
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
   auto info = catalog_->CreateTable(txn, stmt.table_, Schema(stmt.columns_));
@@ -52,29 +74,62 @@ void BustubInstance::HandleCreateStatement(Transaction *txn, const CreateStateme
 }
 
 void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement &stmt, ResultWriter &writer) {
+  if (stmt.keys_.empty()) {
+    throw NotImplementedException("index needs at least one column");
+  }
+
+  auto fill_factor = GetIndexFillFactor();
+  std::unique_lock<std::shared_mutex> l(catalog_lock_);
+
+  // Key parts and the predicate are planned against a scan of the table, like the condition of a DELETE. A key part
+  // that is not a plain column becomes a computed key column, EXPRESSION_KEY_ATTR stands in for it in the key
+  // attributes.
+  const auto &schema = stmt.table_->schema_;
+  Planner planner(*catalog_);
+  auto scan = planner.PlanTableRef(*stmt.table_);
   std::vector<uint32_t> col_ids;
-  for (const auto &col : stmt.cols_) {
-    auto idx = stmt.table_->schema_.GetColIdx(col->col_name_.back());
-    col_ids.push_back(idx);
-    if (stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
-      throw NotImplementedException("only support creating index on integer column");
+  std::vector<Column> key_columns;
+  std::vector<AbstractExpressionRef> key_exprs;
+  bool has_key_expr = false;
+  for (const auto &key : stmt.keys_) {
+    auto [_, expr] = planner.PlanExpression(*key, {scan});
+    if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+      col_ids.push_back(column->GetColIdx());
+      key_columns.push_back(schema.GetColumn(column->GetColIdx()));
+    } else {
+      has_key_expr = true;
+      col_ids.push_back(EXPRESSION_KEY_ATTR);
+      auto name = fmt::format("{}", expr);
+      if (expr->GetReturnType() == TypeId::VARCHAR) {
+        key_columns.emplace_back(name, TypeId::VARCHAR, MaxVarcharLength(expr, schema));
+      } else {
+        key_columns.emplace_back(name, expr->GetReturnType());
+      }
     }
+    key_exprs.push_back(std::move(expr));
+  }
+  if (!has_key_expr) {
+    key_exprs.clear();
   }
-  auto key_schema = Schema::CopySchema(&stmt.table_->schema_, col_ids);
+  AbstractExpressionRef predicate;
+  if (stmt.where_ != nullptr) {
+    predicate = std::get<1>(planner.PlanExpression(*stmt.where_, {scan}));
+  }
+  Schema key_schema(key_columns);
 
-  // TODO(spring2023): If you want to support composite index key for leaderboard optimization, remove this assertion
-  // and create index with different key type that can hold multiple keys based on number of index columns.
+  // The catalog picks the key type from the key schema, composite keys are fine as long as they fit into
+  // MAX_INDEX_KEY_SIZE bytes. Indexes not declared UNIQUE accept duplicate keys.
   //
   // You can also create clustered index that directly stores value inside the index by modifying the value type.
 
-  if (col_ids.empty() || col_ids.size() > 2) {
-    throw NotImplementedException("only support creating index with exactly one or two columns");
+  auto index_type = stmt.index_type_ == "hash"  ? IndexType::HashTableIndex
+                    : stmt.index_type_ == "art" ? IndexType::ArtIndex
+                                                : IndexType::BPlusTreeIndex;
+  auto info = catalog_->CreateIndex(txn, stmt.index_name_, stmt.table_->table_, schema, key_schema, col_ids,
+                                    stmt.unique_, fill_factor, index_type, key_exprs, predicate);
+  if (info != nullptr && index_type == IndexType::BPlusTreeIndex && IsIndexBloomFilterEnabled()) {
+    info->index_->EnableBloomFilter();
   }
-
-  std::unique_lock<std::shared_mutex> l(catalog_lock_);
-  auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-      txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
-      IntegerHashFunctionType{});
   l.unlock();
 
   if (info == nullptr) {
@@ -10,13 +10,19 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <optional>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "common/rid.h"
 #include "container/disk/hash/disk_extendible_hash_table.h"
 
@@ -24,9 +30,27 @@ namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                         bool unique_keys)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)),
+      unique_keys_(unique_keys) {
+  // start out with global depth 0: one directory slot pointing at one empty bucket
+  Page *directory_page = buffer_pool_manager_->NewPage(&directory_page_id_);
+  BUSTUB_ENSURE(directory_page != nullptr, "no free frame for the hash table directory");
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  dir_page->SetPageId(directory_page_id_);
+
+  page_id_t bucket_page_id;
+  Page *bucket_page = buffer_pool_manager_->NewPage(&bucket_page_id);
+  BUSTUB_ENSURE(bucket_page != nullptr, "no free frame for the first hash bucket");
+  reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(bucket_page->GetData())->SetOverflowPageId(INVALID_PAGE_ID);
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  dir_page->SetLocalDepth(0, 0);
+
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
 }
 
 /*****************************************************************************
@@ -46,22 +70,101 @@ auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+  return Hash(key) & dir_page->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
+  Page *page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  BUSTUB_ENSURE(page != nullptr, "no free frame for the hash table directory");
+  return reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  BUSTUB_ENSURE(page != nullptr, "no free frame for a hash bucket");
+  return reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::FetchLatchedBucketPage(const KeyType &key, bool exclusive) -> Page * {
+  // merges delete the buckets they unlink only once this guard is gone, so the page fetched below is still a bucket
+  // even if the directory it was read from is already stale
+  ReaderGuard guard(this);
+  while (true) {
+    uint64_t version = dir_version_.load();
+    if ((version & 1) != 0) {
+      // a split or merge is rewriting the directory
+      std::this_thread::yield();
+      continue;
+    }
+    HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+    page_id_t bucket_page_id = KeyToPageId(key, dir_page);
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+
+    Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+    BUSTUB_ENSURE(page != nullptr, "no free frame for a hash bucket");
+    exclusive ? page->WLatch() : page->RLatch();
+    // splits and merges latch the buckets they touch, so once the bucket is latched under an unchanged version the
+    // key cannot move out of it until the latch is released
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (dir_version_.load(std::memory_order_relaxed) == version) {
+      return page;
+    }
+    exclusive ? page->WUnlatch() : page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_TYPE::ReaderGuard::ReaderGuard(DiskExtendibleHashTable *table) {
+  auto start = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  for (size_t i = 0;; i++) {
+    auto &slot = table->reader_versions_[(start + i) % READER_SLOTS];
+    uint64_t expected = 0;
+    if (slot.compare_exchange_strong(expected, table->dir_version_.load())) {
+      slot_ = &slot;
+      return;
+    }
+    if (i % READER_SLOTS == READER_SLOTS - 1) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_TYPE::ReaderGuard::~ReaderGuard() {
+  slot_->store(0);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::WaitForReaders() {
+  // pairs with the slot store and the version load of a starting reader: either this sees its slot, or it sees the
+  // updated directory
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  uint64_t version = dir_version_.load(std::memory_order_relaxed);
+  for (const auto &slot : reader_versions_) {
+    for (uint64_t started = slot.load(); started != 0 && started < version; started = slot.load()) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::BeginDirectoryUpdate() {
+  dir_version_.store(dir_version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::EndDirectoryUpdate() {
+  dir_version_.store(dir_version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
 }
 
 /*****************************************************************************
@@ -69,7 +172,12 @@ auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BU
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  Page *page = FetchLatchedBucketPage(key, false);
+  auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  bool found = ChainGetValue(bucket, key, result);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return found;
 }
 
 /*****************************************************************************
@@ -77,12 +185,211 @@ auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  Page *page = FetchLatchedBucketPage(key, true);
+  auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  std::optional<bool> inserted;
+  if (IsDuplicate(bucket, key, value)) {
+    inserted = false;
+  } else if (!bucket->IsFull()) {
+    inserted = bucket->Insert(key, value, comparator_);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), inserted.value_or(false));
+
+  if (inserted.has_value()) {
+    return *inserted;
+  }
+  // the bucket is full, retry under the table latch so that it can be split
+  return SplitInsert(transaction, key, value);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  // only splits and merges take the table latch, so the directory cannot change under it
+  table_latch_.WLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  bool dir_dirty = false;
+  bool inserted = false;
+
+  // every pass either inserts or splits the bucket the key maps to, which may still be full if all of its entries
+  // landed on the same side
+  while (true) {
+    uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+    BUSTUB_ENSURE(page != nullptr, "no free frame for a hash bucket");
+    page->WLatch();
+    auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+
+    // another insert may have made room, or added the same entry, since the bucket latch was dropped
+    bool duplicate = IsDuplicate(bucket, key, value);
+    if (duplicate || !bucket->IsFull()) {
+      inserted = !duplicate && bucket->Insert(key, value, comparator_);
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+      break;
+    }
+
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    bool grow = local_depth == dir_page->GetGlobalDepth();
+    // the directory cannot double any more, e.g. if the bucket is full of copies of one key
+    if (grow && dir_page->Size() == DIRECTORY_ARRAY_SIZE) {
+      ChainInsert(bucket, key, value);
+      inserted = true;
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+      break;
+    }
+    page_id_t image_page_id = INVALID_PAGE_ID;
+    Page *image_page = buffer_pool_manager_->NewPage(&image_page_id);
+    BUSTUB_ENSURE(image_page != nullptr, "no free frame for a hash bucket");
+    image_page->WLatch();
+    auto *image = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(image_page->GetData());
+    image->SetOverflowPageId(INVALID_PAGE_ID);
+
+    BeginDirectoryUpdate();
+    if (grow) {
+      dir_page->IncrGlobalDepth();
+    }
+    // the slots of the old bucket whose next hash bit is set move over to the split image
+    uint32_t high_bit = 1U << local_depth;
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      if (dir_page->GetBucketPageId(idx) == bucket_page_id) {
+        dir_page->IncrLocalDepth(idx);
+        if ((idx & high_bit) != 0) {
+          dir_page->SetBucketPageId(idx, image_page_id);
+        }
+      }
+    }
+    dir_dirty = true;
+
+    for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE && bucket->IsOccupied(slot); slot++) {
+      if (bucket->IsReadable(slot) && (Hash(bucket->KeyAt(slot)) & high_bit) != 0) {
+        image->Insert(bucket->KeyAt(slot), bucket->ValueAt(slot), comparator_);
+        bucket->RemoveAt(slot);
+      }
+    }
+    // a bucket merged back below the largest depth may still have overflow pages, their entries are dealt out anew
+    page_id_t overflow_page_id = bucket->GetOverflowPageId();
+    bucket->SetOverflowPageId(INVALID_PAGE_ID);
+    while (overflow_page_id != INVALID_PAGE_ID) {
+      auto *overflow = FetchBucketPage(overflow_page_id);
+      for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE && overflow->IsOccupied(slot); slot++) {
+        if (overflow->IsReadable(slot)) {
+          auto *target = (Hash(overflow->KeyAt(slot)) & high_bit) != 0 ? image : bucket;
+          ChainInsert(target, overflow->KeyAt(slot), overflow->ValueAt(slot));
+        }
+      }
+      page_id_t next_page_id = overflow->GetOverflowPageId();
+      buffer_pool_manager_->UnpinPage(overflow_page_id, false);
+      buffer_pool_manager_->DeletePage(overflow_page_id);
+      overflow_page_id = next_page_id;
+    }
+    image_page->WUnlatch();
+    page->WUnlatch();
+    EndDirectoryUpdate();
+
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  }
+
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+  table_latch_.WUnlock();
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::IsDuplicate(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value) -> bool {
+  std::vector<ValueType> values;
+  ChainGetValue(bucket, key, &values);
+  if (unique_keys_) {
+    return !values.empty();
+  }
+  return std::find(values.begin(), values.end(), value) != values.end();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ChainGetValue(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, std::vector<ValueType> *result)
+    -> bool {
+  bool found = bucket->GetValue(key, comparator_, result);
+  page_id_t page_id = bucket->GetOverflowPageId();
+  while (page_id != INVALID_PAGE_ID) {
+    auto *overflow = FetchBucketPage(page_id);
+    found = overflow->GetValue(key, comparator_, result) || found;
+    page_id_t next_page_id = overflow->GetOverflowPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::ChainInsert(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value) {
+  if (bucket->Insert(key, value, comparator_)) {
+    return;
+  }
+  // `last` is the page the chain ends at so far, it is pinned here unless it is the primary bucket
+  HASH_TABLE_BUCKET_TYPE *last = bucket;
+  page_id_t last_page_id = INVALID_PAGE_ID;
+  auto unpin_last = [&](bool is_dirty) {
+    if (last_page_id != INVALID_PAGE_ID) {
+      buffer_pool_manager_->UnpinPage(last_page_id, is_dirty);
+    }
+  };
+  page_id_t page_id = bucket->GetOverflowPageId();
+  while (page_id != INVALID_PAGE_ID) {
+    auto *overflow = FetchBucketPage(page_id);
+    unpin_last(false);
+    last = overflow;
+    last_page_id = page_id;
+    if (overflow->Insert(key, value, comparator_)) {
+      unpin_last(true);
+      return;
+    }
+    page_id = overflow->GetOverflowPageId();
+  }
+
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  BUSTUB_ENSURE(page != nullptr, "no free frame for a hash overflow page");
+  auto *overflow = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  overflow->SetOverflowPageId(INVALID_PAGE_ID);
+  overflow->Insert(key, value, comparator_);
+  last->SetOverflowPageId(page_id);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  unpin_last(true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ChainRemove(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value)
+    -> bool {
+  if (bucket->Remove(key, value, comparator_)) {
+    return true;
+  }
+  HASH_TABLE_BUCKET_TYPE *prev = bucket;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  page_id_t page_id = bucket->GetOverflowPageId();
+  bool removed = false;
+  while (page_id != INVALID_PAGE_ID && !removed) {
+    auto *overflow = FetchBucketPage(page_id);
+    removed = overflow->Remove(key, value, comparator_);
+    page_id_t next_page_id = overflow->GetOverflowPageId();
+    if (removed && overflow->IsEmpty()) {
+      prev->SetOverflowPageId(next_page_id);
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      break;
+    }
+    if (prev_page_id != INVALID_PAGE_ID) {
+      buffer_pool_manager_->UnpinPage(prev_page_id, false);
+    }
+    prev = overflow;
+    prev_page_id = page_id;
+    page_id = next_page_id;
+  }
+  if (prev_page_id != INVALID_PAGE_ID) {
+    buffer_pool_manager_->UnpinPage(prev_page_id, removed);
+  }
+  return removed;
 }
 
 /*****************************************************************************
@@ -90,26 +397,101 @@ auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  Page *page = FetchLatchedBucketPage(key, true);
+  auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  bool removed = ChainRemove(bucket, key, value);
+  bool empty = bucket->IsEmpty() && bucket->GetOverflowPageId() == INVALID_PAGE_ID;
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
+
+  if (removed && empty) {
+    Merge(transaction, key, value);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  bool dir_dirty = false;
+
+  // folding a bucket into its image can leave the image empty with an image of its own, keep going until a merge
+  // condition fails
+  while (true) {
+    uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == 0) {
+      break;
+    }
+    uint32_t image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    if (dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = dir_page->GetBucketPageId(image_idx);
+
+    // the bucket stays latched until no directory slot points at it, so no insert can slip in and get lost
+    Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+    BUSTUB_ENSURE(page != nullptr, "no free frame for a hash bucket");
+    page->WLatch();
+    auto *bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+    if (!bucket->IsEmpty() || bucket->GetOverflowPageId() != INVALID_PAGE_ID) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      break;
+    }
+
+    BeginDirectoryUpdate();
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      page_id_t page_id = dir_page->GetBucketPageId(idx);
+      if (page_id == bucket_page_id || page_id == image_page_id) {
+        dir_page->SetBucketPageId(idx, image_page_id);
+        dir_page->DecrLocalDepth(idx);
+      }
+    }
+    while (dir_page->CanShrink()) {
+      dir_page->DecrGlobalDepth();
+    }
+    page->WUnlatch();
+    EndDirectoryUpdate();
+    dir_dirty = true;
+
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    // a reader that read the old directory may be about to fetch the bucket, it must not get the page once it is
+    // reused. Readers that latched it already unpin it without needing the table latch
+    WaitForReaders();
+    while (!buffer_pool_manager_->DeletePage(bucket_page_id)) {
+      std::this_thread::yield();
+    }
+  }
+
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+  table_latch_.WUnlock();
+}
 
 /*****************************************************************************
- * GETGLOBALDEPTH - DO NOT TOUCH
+ * GETGLOBALDEPTH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetGlobalDepth() -> uint32_t {
-  table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  uint32_t global_depth = dir_page->GetGlobalDepth();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-  table_latch_.RUnlock();
-  return global_depth;
+  while (true) {
+    uint64_t version = dir_version_.load(std::memory_order_acquire);
+    if ((version & 1) != 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+    uint32_t global_depth = dir_page->GetGlobalDepth();
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (dir_version_.load(std::memory_order_relaxed) == version) {
+      return global_depth;
+    }
+  }
 }
 
 /*****************************************************************************
@@ -132,7 +514,15 @@ template class DiskExtendibleHashTable<int, int, IntComparator>;
 template class DiskExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>;
 template class DiskExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
 template class DiskExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class DiskExtendibleHashTable<GenericKey<24>, RID, GenericComparator<24>>;
 template class DiskExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class DiskExtendibleHashTable<GenericKey<40>, RID, GenericComparator<40>>;
+template class DiskExtendibleHashTable<GenericKey<48>, RID, GenericComparator<48>>;
 template class DiskExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+template class DiskExtendibleHashTable<GenericKey<96>, RID, GenericComparator<96>>;
+template class DiskExtendibleHashTable<GenericKey<8>, RID, IntegerComparator<8, int32_t>>;
+template class DiskExtendibleHashTable<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+template class DiskExtendibleHashTable<GenericKey<16>, RID, IntegerComparator<16, int32_t>>;
+template class DiskExtendibleHashTable<GenericKey<16>, RID, IntegerComparator<16, int64_t>>;
 
 }  // namespace bustub
@@ -29,10 +29,33 @@ AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const Aggreg
 
 void AggregationExecutor::Init() {
   child_->Init();
-  Tuple tuple{};
-  RID rid{};
-  while (child_->Next(&tuple, &rid)) {
-    aht_.InsertCombine(MakeAggregateKey(&tuple), MakeAggregateValue(&tuple));
+  const auto &child_schema = child_->GetOutputSchema();
+  const auto &group_bys = plan_->GetGroupBys();
+  const auto &aggregates = plan_->GetAggregates();
+  TupleBatch batch;
+  std::vector<std::vector<Value>> keys(group_bys.size());
+  std::vector<std::vector<Value>> vals(aggregates.size());
+  while (child_->NextBatch(&batch)) {
+    // evaluate the group bys and aggregate inputs a column at a time, then combine row by row
+    for (size_t i = 0; i < group_bys.size(); i++) {
+      group_bys[i]->EvaluateBatch(batch, child_schema, &keys[i]);
+    }
+    for (size_t i = 0; i < aggregates.size(); i++) {
+      aggregates[i]->EvaluateBatch(batch, child_schema, &vals[i]);
+    }
+    for (size_t row = 0; row < batch.Size(); row++) {
+      AggregateKey agg_key;
+      agg_key.group_bys_.reserve(keys.size());
+      for (const auto &key_column : keys) {
+        agg_key.group_bys_.push_back(key_column[row]);
+      }
+      AggregateValue agg_val;
+      agg_val.aggregates_.reserve(vals.size());
+      for (const auto &val_column : vals) {
+        agg_val.aggregates_.push_back(val_column[row]);
+      }
+      aht_.InsertCombine(agg_key, agg_val);
+    }
   }
   if (aht_.Begin() == aht_.End() && plan_->group_bys_.empty()) {
     aht_.InsertInitCombine();
@@ -52,6 +75,18 @@ auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   return true;
 }
 
+auto AggregationExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(GetOutputSchema().GetColumnCount());
+  std::vector<Value> values;
+  for (; aht_iterator_ != aht_.End() && !batch->IsFull(); ++aht_iterator_) {
+    values.clear();
+    values.insert(values.end(), aht_iterator_.Key().group_bys_.begin(), aht_iterator_.Key().group_bys_.end());
+    values.insert(values.end(), aht_iterator_.Val().aggregates_.begin(), aht_iterator_.Val().aggregates_.end());
+    batch->AppendRow(values, RID{});
+  }
+  return !batch->IsEmpty();
+}
+
 auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_.get(); }
 
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executors/delete_executor.h"
 
@@ -33,6 +34,8 @@ auto DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
     return false;
   }
   int deleted_count = 0;
+  // index entries are removed per index once all tuples are marked, so that large deletes take one pass per index
+  std::vector<std::vector<std::pair<Tuple, RID>>> index_entries(table_indexes_.size());
   while (child_executor_->Next(tuple, rid)) {
     auto tuplemeta = table_info_->table_->GetTupleMeta(*rid);
     tuplemeta.is_deleted_ = true;
@@ -43,16 +46,22 @@ auto DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
 
     // delete index
     deleted_count++;
-    for (auto indexes : table_indexes_) {
-      auto key_attr = indexes->index_->GetKeyAttrs();
-      auto delete_tuple = tuple->KeyFromTuple(table_info_->schema_, *(indexes->index_->GetKeySchema()), key_attr);
-      indexes->index_->DeleteEntry(delete_tuple, *rid, exec_ctx_->GetTransaction());
+    for (size_t i = 0; i < table_indexes_.size(); i++) {
+      auto indexes = table_indexes_[i];
+      if (!indexes->index_->IsIndexed(*tuple, table_info_->schema_)) {
+        continue;
+      }
+      auto delete_tuple = indexes->index_->KeyFromTuple(*tuple, table_info_->schema_);
+      index_entries[i].emplace_back(delete_tuple, *rid);
 
       auto idx_write_record = IndexWriteRecord(*rid, table_info_->oid_, WType::DELETE, delete_tuple,
                                                indexes->index_oid_, exec_ctx_->GetCatalog());
       exec_ctx_->GetTransaction()->AppendIndexWriteRecord(idx_write_record);
     }
   }
+  for (size_t i = 0; i < table_indexes_.size(); i++) {
+    table_indexes_[i]->index_->DeleteEntries(index_entries[i], exec_ctx_->GetTransaction());
+  }
 
   std::vector<Value> values{Value(INTEGER, deleted_count)};
   *tuple = Tuple(values, &GetOutputSchema());
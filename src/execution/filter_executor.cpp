@@ -31,4 +31,24 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
 }
 
+auto FilterExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &filter_expr = plan_->GetPredicate();
+  std::vector<Value> values;
+  std::vector<bool> keep;
+
+  // pull until some row survives, so that an empty batch always means the end
+  while (child_executor_->NextBatch(batch)) {
+    filter_expr->EvaluateBatch(*batch, child_executor_->GetOutputSchema(), &values);
+    keep.resize(values.size());
+    for (size_t row = 0; row < values.size(); row++) {
+      keep[row] = !values[row].IsNull() && values[row].GetAs<bool>();
+    }
+    batch->Select(keep);
+    if (!batch->IsEmpty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace bustub
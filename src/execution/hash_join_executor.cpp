@@ -35,91 +35,144 @@ HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlan
 }
 
 void HashJoinExecutor::Init() {
-  // Hashjoin is a Pipeline Breaker, we need to get all data at the init phase
+  // Hashjoin is a Pipeline Breaker, we build the hash table on the right side at the init phase
   left_executor_->Init();
   right_executor_->Init();
-  Tuple tuple{};
-  RID rid{};
-  std::unordered_map<hash_t, std::vector<Tuple>> right_join_ht{};
-  std::unordered_map<hash_t, std::vector<std::vector<Value>>> right_join_value_ht{};
-  while (right_executor_->Next(&tuple, &rid)) {
-    std::vector<Value> values{};
-    auto key = hash_t{};
-    for (const auto &right_expr : plan_->RightJoinKeyExpressions()) {
-      auto val = right_expr->Evaluate(&tuple, right_executor_->GetOutputSchema());
-      values.push_back(val);
-      key = HashUtil::CombineHashes(key, HashUtil::HashValue(&val));
+  right_rows_.clear();
+  right_keys_.clear();
+  right_ht_.clear();
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  const auto &right_exprs = plan_->RightJoinKeyExpressions();
+  TupleBatch batch;
+  std::vector<std::vector<Value>> keys(right_exprs.size());
+  while (right_executor_->NextBatch(&batch)) {
+    for (size_t i = 0; i < right_exprs.size(); i++) {
+      right_exprs[i]->EvaluateBatch(batch, right_schema, &keys[i]);
     }
-    right_join_ht[key].emplace_back(tuple);
-    right_join_value_ht[key].emplace_back(values);
+    for (size_t row = 0; row < batch.Size(); row++) {
+      std::vector<Value> key_values{};
+      auto key = hash_t{};
+      for (const auto &key_column : keys) {
+        key_values.push_back(key_column[row]);
+        key = HashUtil::CombineHashes(key, HashUtil::HashValue(&key_column[row]));
+      }
+      std::vector<Value> values{};
+      values.reserve(right_schema.GetColumnCount());
+      for (uint32_t id = 0; id < right_schema.GetColumnCount(); id++) {
+        values.push_back(batch.GetValue(row, id));
+      }
+      right_ht_[key].push_back(right_rows_.size());
+      right_keys_.emplace_back(std::move(key_values));
+      right_rows_.emplace_back(std::move(values));
+    }
+  }
+
+  // the left side is streamed through the probe
+  left_batch_.Reset(left_executor_->GetOutputSchema().GetColumnCount());
+  left_row_ = 0;
+  match_pos_ = 0;
+  left_matched_ = false;
+  left_done_ = false;
+  out_batch_.Reset(GetOutputSchema().GetColumnCount());
+  out_pos_ = 0;
+}
+
+auto HashJoinExecutor::FetchLeftBatch() -> bool {
+  if (left_done_ || !left_executor_->NextBatch(&left_batch_)) {
+    left_done_ = true;
+    left_row_ = 0;
+    return false;
   }
-  while (left_executor_->Next(&tuple, &rid)) {
-    auto left_key = hash_t{};
-    std::vector<Value> left_value{};
-    for (const auto &left_expr : plan_->LeftJoinKeyExpressions()) {
-      auto val = left_expr->Evaluate(&tuple, left_executor_->GetOutputSchema());
-      left_value.push_back(val);
-      left_key = HashUtil::CombineHashes(left_key, HashUtil::HashValue(&val));
+  const auto &left_exprs = plan_->LeftJoinKeyExpressions();
+  left_keys_.resize(left_exprs.size());
+  for (size_t i = 0; i < left_exprs.size(); i++) {
+    left_exprs[i]->EvaluateBatch(left_batch_, left_executor_->GetOutputSchema(), &left_keys_[i]);
+  }
+  left_hashes_.assign(left_batch_.Size(), hash_t{});
+  for (const auto &key_column : left_keys_) {
+    for (size_t row = 0; row < left_batch_.Size(); row++) {
+      left_hashes_[row] = HashUtil::CombineHashes(left_hashes_[row], HashUtil::HashValue(&key_column[row]));
     }
-    if (right_join_ht.find(left_key) != right_join_ht.end()) {
-      // std::cout<<"judge inner join"<<std::endl;
-      const auto &righttuples = right_join_ht[left_key];
-      const auto &rightvalues = right_join_value_ht[left_key];
-      // get right tuples and values
-      auto rightvaluessize = rightvalues.size();
-      for (uint32_t index = 0; index < rightvaluessize; index++) {
-        const auto &righttuple = righttuples[index];
-        const auto &rightvalue = rightvalues[index];
-        if (rightvalue.size() != left_value.size()) {
-          // std::cout<<"rightvalue.size()!=left_value.size()"<<std::endl;
-          continue;
-        }
+  }
+  left_row_ = 0;
+  match_pos_ = 0;
+  left_matched_ = false;
+  return true;
+}
+
+auto HashJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &left_schema = left_executor_->GetOutputSchema();
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  batch->Reset(GetOutputSchema().GetColumnCount());
+  std::vector<Value> values{};
+  values.reserve(GetOutputSchema().GetColumnCount());
+  auto emit = [&](const std::vector<Value> &right_values) {
+    values.clear();
+    for (uint32_t id = 0; id < left_schema.GetColumnCount(); id++) {
+      values.push_back(left_batch_.GetValue(left_row_, id));
+    }
+    values.insert(values.end(), right_values.begin(), right_values.end());
+    batch->AppendRow(values, RID{});
+  };
+  // the right side of a left row that matches nothing
+  std::vector<Value> right_nulls{};
+  if (plan_->join_type_ == JoinType::LEFT) {
+    for (uint32_t id = 0; id < right_schema.GetColumnCount(); id++) {
+      right_nulls.push_back(ValueFactory::GetNullValueByType(right_schema.GetColumn(id).GetType()));
+    }
+  }
+
+  // a left row whose matches do not fit is picked up again by the next call
+  while (!batch->IsFull()) {
+    if (left_row_ == left_batch_.Size()) {
+      if (!FetchLeftBatch()) {
+        break;
+      }
+      continue;
+    }
+    auto bucket = right_ht_.find(left_hashes_[left_row_]);
+    if (bucket != right_ht_.end()) {
+      const auto &matches = bucket->second;
+      for (; match_pos_ < matches.size() && !batch->IsFull(); match_pos_++) {
+        const auto &right_key = right_keys_[matches[match_pos_]];
         bool judgeequel = true;
-        for (uint32_t i = 0; i < left_value.size(); i++) {
-          const auto &leftval = left_value[i];
-          const auto &rightval = rightvalue[i];
-          if (leftval.CompareEquals(rightval) != CmpBool::CmpTrue) {
-            // std::cout<<"not equal"<<std::endl;
+        for (size_t i = 0; i < right_key.size(); i++) {
+          if (left_keys_[i][left_row_].CompareEquals(right_key[i]) != CmpBool::CmpTrue) {
             judgeequel = false;
             break;
           }
         }
         if (judgeequel) {
-          std::vector<Value> values{};
-          for (uint32_t id = 0; id < left_executor_->GetOutputSchema().GetColumnCount(); id++) {
-            values.push_back(tuple.GetValue(&left_executor_->GetOutputSchema(), id));
-          }
-          for (uint32_t id = 0; id < right_executor_->GetOutputSchema().GetColumnCount(); id++) {
-            values.push_back(righttuple.GetValue(&right_executor_->GetOutputSchema(), id));
-          }
-          // std::cout<<"tupleres inner join add"<<std::endl;
-          tupleres_.emplace_back(values, &GetOutputSchema());
+          emit(right_rows_[matches[match_pos_]]);
+          left_matched_ = true;
         }
       }
-    } else if (plan_->join_type_ == JoinType::LEFT) {
-      // right is empty, but the join_type is leftjoin
-      std::vector<Value> values{};
-      for (uint32_t id = 0; id < left_executor_->GetOutputSchema().GetColumnCount(); id++) {
-        values.push_back(tuple.GetValue(&left_executor_->GetOutputSchema(), id));
+      if (match_pos_ < matches.size()) {
+        break;
       }
-      // the right is empty
-      for (uint32_t id = 0; id < right_executor_->GetOutputSchema().GetColumnCount(); id++) {
-        values.push_back(ValueFactory::GetNullValueByType(right_executor_->GetOutputSchema().GetColumn(id).GetType()));
+    }
+    if (!left_matched_ && plan_->join_type_ == JoinType::LEFT) {
+      // no right tuple matches, but the join_type is leftjoin
+      if (batch->IsFull()) {
+        break;
       }
-      // std::cout<<"tupleres leftjoin add"<<std::endl;
-      tupleres_.emplace_back(values, &GetOutputSchema());
+      emit(right_nulls);
     }
+    left_row_++;
+    match_pos_ = 0;
+    left_matched_ = false;
   }
-  // std::cout<<tupleres_.size()<<std::endl;
-  tupleres_iter_ = tupleres_.begin();
+  return !batch->IsEmpty();
 }
 
 auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (tupleres_iter_ == tupleres_.end()) {
-    return false;
+  if (out_pos_ == out_batch_.Size()) {
+    if (!NextBatch(&out_batch_)) {
+      return false;
+    }
+    out_pos_ = 0;
   }
-  *tuple = *tupleres_iter_;
-  ++tupleres_iter_;
+  *tuple = out_batch_.ToTuple(out_pos_++, GetOutputSchema());
   return true;
 }
 
@@ -11,35 +11,161 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 #include <memory>
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction.h"
 #include "type/type_id.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
     : AbstractExecutor(exec_ctx),
       plan_(plan),
       index_info_(exec_ctx_->GetCatalog()->GetIndex(plan_->index_oid_)),
-      table_info_(exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_)),
-      index_iter_(dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(index_info_->index_.get())->GetBeginIterator()) {}
+      table_info_(exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_)) {}
 
-void IndexScanExecutor::Init() {}
+void IndexScanExecutor::Init() {
+  // rows are locked like a sequential scan locks them, under an IS lock on the table
+  auto *txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED &&
+      txn->GetExclusiveTableLockSet()->count(table_info_->oid_) == 0 &&
+      txn->GetIntentionExclusiveTableLockSet()->count(table_info_->oid_) == 0) {
+    try {
+      bool lock_success =
+          exec_ctx_->GetLockManager()->LockTable(txn, LockManager::LockMode::INTENTION_SHARED, table_info_->oid_);
+      if (!lock_success) {
+        throw ExecutionException("IndexScanExecutor try to get IS lock failed");
+      }
+    } catch (TransactionAbortException &e) {
+      throw ExecutionException("IndexScan table Transaction Abort");
+    }
+  }
+  // drop the old cursor first, it holds latches of the index
+  cursor_.reset();
+  cursor_ = index_info_->index_->ScanRange(plan_->range_, plan_->descending_);
+  if (plan_->index_only_) {
+    key_positions_.assign(GetOutputSchema().GetColumnCount(), -1);
+    const auto &key_attrs = index_info_->index_->GetKeyAttrs();
+    for (size_t i = 0; i < key_attrs.size(); i++) {
+      if (key_attrs[i] != EXPRESSION_KEY_ATTR) {
+        key_positions_[key_attrs[i]] = static_cast<int>(i);
+      }
+    }
+  }
+}
+
+auto IndexScanExecutor::MakeTupleFromKey() -> Tuple {
+  auto key_values = cursor_->GetKeyValues();
+  const auto &schema = GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(schema.GetColumnCount());
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    values.push_back(key_positions_[i] == -1 ? ValueFactory::GetNullValueByType(schema.GetColumn(i).GetType())
+                                             : key_values[key_positions_[i]]);
+  }
+  return {values, &schema};
+}
 
 auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   while (true) {
-    if (index_iter_.IsEnd()) {
+    if (cursor_->IsEnd()) {
+      UnlockTable();
       return false;
     }
-    auto index_rid = (*index_iter_).second;
+    auto index_rid = cursor_->GetRID();
+    LockRow(index_rid);
+    if (plan_->index_only_) {
+      // deletes remove the index entry together with the tuple, so every entry still points at a live tuple
+      auto key_tuple = MakeTupleFromKey();
+      if (plan_->filter_predicate_ != nullptr) {
+        auto value = plan_->filter_predicate_->Evaluate(&key_tuple, GetOutputSchema());
+        if (value.IsNull() || !value.GetAs<bool>()) {
+          UnlockRow(index_rid, true);
+          cursor_->Next();
+          continue;
+        }
+      }
+      *tuple = std::move(key_tuple);
+      *rid = index_rid;
+      break;
+    }
     auto index_tp = table_info_->table_->GetTuple(index_rid);
     if (index_tp.first.is_deleted_) {
-      ++index_iter_;
+      UnlockRow(index_rid, true);
+      cursor_->Next();
       continue;
     }
+    // the range only covers the first key column, the rest of the predicate is checked here
+    if (plan_->filter_predicate_ != nullptr) {
+      auto value = plan_->filter_predicate_->Evaluate(&index_tp.second, GetOutputSchema());
+      if (value.IsNull() || !value.GetAs<bool>()) {
+        UnlockRow(index_rid, true);
+        cursor_->Next();
+        continue;
+      }
+    }
     *tuple = index_tp.second;
     *rid = index_rid;
     break;
   }
-  ++index_iter_;
+  // read committed only needs the row while it is read
+  if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
+    UnlockRow(*rid, false);
+  }
+  cursor_->Next();
   return true;
 }
 
+auto IndexScanExecutor::HoldsExclusiveRowLock(const RID &rid) -> bool {
+  auto *row_locks = exec_ctx_->GetTransaction()->GetExclusiveRowLockSet().get();
+  auto it = row_locks->find(table_info_->oid_);
+  return it != row_locks->end() && it->second.count(rid) > 0;
+}
+
+void IndexScanExecutor::LockRow(const RID &rid) {
+  auto *txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() == IsolationLevel::READ_UNCOMMITTED || HoldsExclusiveRowLock(rid)) {
+    return;
+  }
+  try {
+    bool lock_success =
+        exec_ctx_->GetLockManager()->LockRow(txn, LockManager::LockMode::SHARED, table_info_->oid_, rid);
+    if (!lock_success) {
+      throw ExecutionException("IndexScanExecutor lockrow try to get S lock failed");
+    }
+  } catch (TransactionAbortException &e) {
+    throw ExecutionException("IndexScan row Transaction Abort");
+  }
+}
+
+void IndexScanExecutor::UnlockRow(const RID &rid, bool force) {
+  auto *txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() == IsolationLevel::READ_UNCOMMITTED || HoldsExclusiveRowLock(rid)) {
+    return;
+  }
+  try {
+    bool unlock_success = exec_ctx_->GetLockManager()->UnlockRow(txn, table_info_->oid_, rid, force);
+    if (!unlock_success) {
+      throw ExecutionException("IndexScanExecutor try to unlock row failed");
+    }
+  } catch (TransactionAbortException &e) {
+    throw ExecutionException("Unlock IndexScan row Transaction Abort");
+  }
+}
+
+void IndexScanExecutor::UnlockTable() {
+  auto *txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() != IsolationLevel::READ_COMMITTED ||
+      txn->GetIntentionSharedTableLockSet()->count(table_info_->oid_) == 0) {
+    return;
+  }
+  try {
+    bool unlock_success = exec_ctx_->GetLockManager()->UnlockTable(txn, table_info_->oid_);
+    if (!unlock_success) {
+      throw ExecutionException("IndexScanExecutor try to unlock failed");
+    }
+  } catch (TransactionAbortException &e) {
+    throw ExecutionException("Unlock IndexScan table Transaction Abort");
+  }
+}
+
 }  // namespace bustub
@@ -66,8 +66,10 @@ auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
       exec_ctx_->GetTransaction()->AppendTableWriteRecord(tbl_write_record);
 
       for (auto indexes : table_indexes_) {
-        auto key_attr = indexes->index_->GetKeyAttrs();
-        auto index_tuple = tuple->KeyFromTuple(table_info_->schema_, *(indexes->index_->GetKeySchema()), key_attr);
+        if (!indexes->index_->IsIndexed(*tuple, table_info_->schema_)) {
+          continue;
+        }
+        auto index_tuple = indexes->index_->KeyFromTuple(*tuple, table_info_->schema_);
         indexes->index_->InsertEntry(index_tuple, *rid, exec_ctx_->GetTransaction());
 
         auto idx_write_record = IndexWriteRecord(*rid, table_info_->oid_, WType::INSERT, index_tuple,
@@ -35,4 +35,13 @@ auto LimitExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   return true;
 }
 
+auto LimitExecutor::NextBatch(TupleBatch *batch) -> bool {
+  if (count_ == limit_count_ || !child_executor_->NextBatch(batch)) {
+    return false;
+  }
+  batch->Truncate(limit_count_ - count_);
+  count_ += batch->Size();
+  return true;
+}
+
 }  // namespace bustub
@@ -11,20 +11,192 @@
 //===----------------------------------------------------------------------===//
 
 #include "execution/executors/nested_index_join_executor.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      index_info_(exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid())),
+      table_info_(exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid())) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2023 Spring: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void NestIndexJoinExecutor::Init() { throw NotImplementedException("NestIndexJoinExecutor is not implemented"); }
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  // inner rows are locked like an index scan locks them, under an IS lock on the inner table
+  auto *txn = exec_ctx_->GetTransaction();
+  auto oid = table_info_->oid_;
+  if (txn->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED &&
+      txn->GetExclusiveTableLockSet()->count(oid) == 0 &&
+      txn->GetIntentionExclusiveTableLockSet()->count(oid) == 0 && txn->GetSharedTableLockSet()->count(oid) == 0 &&
+      txn->GetSharedIntentionExclusiveTableLockSet()->count(oid) == 0) {
+    try {
+      bool lock_success = exec_ctx_->GetLockManager()->LockTable(txn, LockManager::LockMode::INTENTION_SHARED, oid);
+      if (!lock_success) {
+        throw ExecutionException("NestIndexJoinExecutor try to get IS lock failed");
+      }
+    } catch (TransactionAbortException &e) {
+      throw ExecutionException("NestIndexJoin table Transaction Abort");
+    }
+  }
+  outer_batch_.clear();
+  matches_.clear();
+  outer_pos_ = 0;
+  match_pos_ = 0;
+  matched_ = false;
+}
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto NestIndexJoinExecutor::FetchBatch() -> bool {
+  outer_batch_.clear();
+  outer_pos_ = 0;
+  match_pos_ = 0;
+  matched_ = false;
+  Tuple outer;
+  RID outer_rid;
+  while (outer_batch_.size() < INDEX_JOIN_BATCH_SIZE && child_executor_->Next(&outer, &outer_rid)) {
+    outer_batch_.push_back(std::move(outer));
+  }
+  if (outer_batch_.empty()) {
+    return false;
+  }
+
+  // probing the whole batch at once lets the index visit the keys in order instead of descending once per tuple
+  std::vector<Tuple> keys;
+  std::vector<bool> null_keys;
+  keys.reserve(outer_batch_.size());
+  null_keys.reserve(outer_batch_.size());
+  auto key_type = index_info_->key_schema_.GetColumn(0).GetType();
+  for (const auto &tuple : outer_batch_) {
+    auto value = plan_->KeyPredicate()->Evaluate(&tuple, child_executor_->GetOutputSchema());
+    null_keys.push_back(value.IsNull());
+    if (!value.IsNull() && value.GetTypeId() != key_type) {
+      value = value.CastAs(key_type);
+    }
+    keys.emplace_back(std::vector<Value>{value}, &index_info_->key_schema_);
+  }
+  index_info_->index_->ScanKeys(keys, &matches_, exec_ctx_->GetTransaction());
+  for (size_t i = 0; i < null_keys.size(); i++) {
+    // NULL never equals anything
+    if (null_keys[i]) {
+      matches_[i].clear();
+    }
+  }
+  return true;
+}
+
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  const auto &inner_schema = plan_->InnerTableSchema();
+  while (true) {
+    if (outer_pos_ == outer_batch_.size() && !FetchBatch()) {
+      UnlockTable();
+      return false;
+    }
+    const auto &outer = outer_batch_[outer_pos_];
+    const auto &rids = matches_[outer_pos_];
+    std::vector<Value> values;
+    values.reserve(GetOutputSchema().GetColumnCount());
+    while (match_pos_ < rids.size()) {
+      auto inner_rid = rids[match_pos_++];
+      LockRow(inner_rid);
+      auto [meta, inner] = table_info_->table_->GetTuple(inner_rid);
+      if (meta.is_deleted_) {
+        UnlockRow(inner_rid, true);
+        continue;
+      }
+      // read committed only needs the row while it is read
+      if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
+        UnlockRow(inner_rid, false);
+      }
+      for (uint32_t index = 0; index < outer_schema.GetColumnCount(); index++) {
+        values.push_back(outer.GetValue(&outer_schema, index));
+      }
+      for (uint32_t index = 0; index < inner_schema.GetColumnCount(); index++) {
+        values.push_back(inner.GetValue(&inner_schema, index));
+      }
+      *tuple = Tuple(values, &GetOutputSchema());
+      matched_ = true;
+      return true;
+    }
+    bool emit_null = !matched_ && plan_->GetJoinType() == JoinType::LEFT;
+    if (emit_null) {
+      for (uint32_t index = 0; index < outer_schema.GetColumnCount(); index++) {
+        values.push_back(outer.GetValue(&outer_schema, index));
+      }
+      for (uint32_t index = 0; index < inner_schema.GetColumnCount(); index++) {
+        values.push_back(ValueFactory::GetNullValueByType(inner_schema.GetColumn(index).GetType()));
+      }
+      *tuple = Tuple(values, &GetOutputSchema());
+    }
+    outer_pos_++;
+    match_pos_ = 0;
+    matched_ = false;
+    if (emit_null) {
+      return true;
+    }
+  }
+}
+
+auto NestIndexJoinExecutor::HoldsExclusiveRowLock(const RID &rid) -> bool {
+  auto *row_locks = exec_ctx_->GetTransaction()->GetExclusiveRowLockSet().get();
+  auto it = row_locks->find(table_info_->oid_);
+  return it != row_locks->end() && it->second.count(rid) > 0;
+}
+
+void NestIndexJoinExecutor::LockRow(const RID &rid) {
+  auto *txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() == IsolationLevel::READ_UNCOMMITTED || HoldsExclusiveRowLock(rid)) {
+    return;
+  }
+  try {
+    bool lock_success =
+        exec_ctx_->GetLockManager()->LockRow(txn, LockManager::LockMode::SHARED, table_info_->oid_, rid);
+    if (!lock_success) {
+      throw ExecutionException("NestIndexJoinExecutor lockrow try to get S lock failed");
+    }
+  } catch (TransactionAbortException &e) {
+    throw ExecutionException("NestIndexJoin row Transaction Abort");
+  }
+}
+
+void NestIndexJoinExecutor::UnlockRow(const RID &rid, bool force) {
+  auto *txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() == IsolationLevel::READ_UNCOMMITTED || HoldsExclusiveRowLock(rid)) {
+    return;
+  }
+  try {
+    bool unlock_success = exec_ctx_->GetLockManager()->UnlockRow(txn, table_info_->oid_, rid, force);
+    if (!unlock_success) {
+      throw ExecutionException("NestIndexJoinExecutor try to unlock row failed");
+    }
+  } catch (TransactionAbortException &e) {
+    throw ExecutionException("Unlock NestIndexJoin row Transaction Abort");
+  }
+}
+
+void NestIndexJoinExecutor::UnlockTable() {
+  auto *txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() != IsolationLevel::READ_COMMITTED ||
+      txn->GetIntentionSharedTableLockSet()->count(table_info_->oid_) == 0) {
+    return;
+  }
+  try {
+    bool unlock_success = exec_ctx_->GetLockManager()->UnlockTable(txn, table_info_->oid_);
+    if (!unlock_success) {
+      throw ExecutionException("NestIndexJoinExecutor try to unlock failed");
+    }
+  } catch (TransactionAbortException &e) {
+    throw ExecutionException("Unlock NestIndexJoin table Transaction Abort");
+  }
+}
 
 }  // namespace bustub
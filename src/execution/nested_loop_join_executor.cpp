@@ -42,7 +42,7 @@ void NestedLoopJoinExecutor::Init() {
   Tuple tuple{};
   RID rid{};
   while (right_executor_->Next(&tuple, &rid)) {
-    right_tuples_.push_back(tuple);
+    right_tuples_.push_back(std::move(tuple));
   }
 }
 
@@ -33,4 +33,28 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
 
   return true;
 }
+
+auto ProjectionExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(GetOutputSchema().GetColumnCount());
+  if (!child_executor_->NextBatch(&child_batch_)) {
+    return false;
+  }
+
+  // Compute expressions a column at a time, the output holds only the selected child rows
+  const auto &exprs = plan_->GetExpressions();
+  for (uint32_t i = 0; i < exprs.size(); i++) {
+    std::vector<Value> values;
+    exprs[i]->EvaluateBatch(child_batch_, child_executor_->GetOutputSchema(), &values);
+    batch->SetColumn(i, std::move(values));
+  }
+  std::vector<RID> rids;
+  rids.reserve(child_batch_.Size());
+  for (size_t row = 0; row < child_batch_.Size(); row++) {
+    rids.push_back(child_batch_.GetRid(row));
+  }
+  batch->SetRids(std::move(rids));
+
+  return true;
+}
+
 }  // namespace bustub
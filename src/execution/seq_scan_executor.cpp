@@ -16,6 +16,9 @@
 #include "common/config.h"
 #include "concurrency/lock_manager.h"
 #include "concurrency/transaction.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
 #include "storage/table/table_iterator.h"
 #include "type/value_factory.h"
 
@@ -56,17 +59,194 @@ void SeqScanExecutor::Init() {
       }
     }
   }
-  table_iter_ = std::make_unique<TableIterator>(table_info->table_->MakeEagerIterator());
+  // with a dictionary the page bytes hold codes, so predicates are evaluated against the storage schema
+  dictionary_ = table_info->table_->GetDictionary();
+  schema_ = dictionary_ != nullptr ? &dictionary_->GetStorageSchema() : &table_info->schema_;
+  scan_predicate_ = plan_->filter_predicate_;
+  filter_after_decode_ = false;
+  if (dictionary_ != nullptr && scan_predicate_ != nullptr) {
+    scan_predicate_ = RewriteForDictionary(plan_->filter_predicate_);
+    filter_after_decode_ = scan_predicate_ == nullptr;
+  }
+  zone_map_ = table_info->table_->GetZoneMap();
+  zone_predicates_.clear();
+  zone_checked_page_ = INVALID_PAGE_ID;
+  if (zone_map_ != nullptr && plan_->filter_predicate_ != nullptr) {
+    CollectZonePredicates(plan_->filter_predicate_);
+  }
+  // an update or delete appends new tuple versions while it scans, it must stop at the tuples that were there before
+  table_iter_ = std::make_unique<TableIterator>(exec_ctx_->IsDelete() ? table_info->table_->MakeIterator()
+                                                                     : table_info->table_->MakeEagerIterator());
+}
+
+auto SeqScanExecutor::RewriteForDictionary(const AbstractExpressionRef &expr) const -> AbstractExpressionRef {
+  auto is_encoded_column = [this](const AbstractExpressionRef &child) {
+    const auto *column = dynamic_cast<const ColumnValueExpression *>(child.get());
+    return column != nullptr && dictionary_->IsEncoded(column->GetColIdx());
+  };
+  // a string constant becomes its code, a string never stored gets a code no tuple can have
+  auto encode_constant = [this](const AbstractExpressionRef &child) -> AbstractExpressionRef {
+    const auto *constant = dynamic_cast<const ConstantValueExpression *>(child.get());
+    if (constant == nullptr || constant->val_.GetTypeId() != TypeId::VARCHAR) {
+      return nullptr;
+    }
+    if (constant->val_.IsNull()) {
+      return std::make_shared<ConstantValueExpression>(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+    }
+    auto code = dictionary_->Lookup(constant->val_.ToString());
+    return std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(code.value_or(-1)));
+  };
+
+  if (is_encoded_column(expr)) {
+    // only equality can be answered on codes
+    return nullptr;
+  }
+  if (const auto *comparison = dynamic_cast<const ComparisonExpression *>(expr.get());
+      comparison != nullptr &&
+      (comparison->comp_type_ == ComparisonType::Equal || comparison->comp_type_ == ComparisonType::NotEqual)) {
+    const auto &left = comparison->GetChildAt(0);
+    const auto &right = comparison->GetChildAt(1);
+    bool left_encoded = is_encoded_column(left);
+    bool right_encoded = is_encoded_column(right);
+    if (left_encoded || right_encoded) {
+      auto new_left = left_encoded ? left : encode_constant(left);
+      auto new_right = right_encoded ? right : encode_constant(right);
+      if (new_left == nullptr || new_right == nullptr) {
+        return nullptr;
+      }
+      return comparison->CloneWithChildren({new_left, new_right});
+    }
+  }
+  std::vector<AbstractExpressionRef> children;
+  for (const auto &child : expr->GetChildren()) {
+    auto new_child = RewriteForDictionary(child);
+    if (new_child == nullptr) {
+      return nullptr;
+    }
+    children.push_back(std::move(new_child));
+  }
+  return expr->CloneWithChildren(std::move(children));
 }
 
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+void SeqScanExecutor::CollectZonePredicates(const AbstractExpressionRef &expr) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get());
+      logic != nullptr && logic->logic_type_ == LogicType::And) {
+    CollectZonePredicates(logic->GetChildAt(0));
+    CollectZonePredicates(logic->GetChildAt(1));
+    return;
+  }
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (comparison == nullptr) {
+    return;
+  }
+  auto comp_type = comparison->comp_type_;
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+  if (column == nullptr || constant == nullptr) {
+    // try `constant <op> column`, flipping the operator
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+    if (column == nullptr || constant == nullptr) {
+      return;
+    }
+    switch (comp_type) {
+      case ComparisonType::LessThan:
+        comp_type = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        comp_type = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        comp_type = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        comp_type = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  if (column->GetTupleIdx() != 0 || !zone_map_->IsTracked(column->GetColIdx()) || constant->val_.IsNull()) {
+    return;
+  }
+  // only compare values of the same family, booleans against booleans and numbers against numbers
+  auto column_type = schema_->GetColumn(column->GetColIdx()).GetType();
+  auto constant_type = constant->val_.GetTypeId();
+  if ((column_type == TypeId::BOOLEAN) != (constant_type == TypeId::BOOLEAN) || constant_type == TypeId::VARCHAR) {
+    return;
+  }
+  zone_predicates_.push_back({column->GetColIdx(), comp_type, constant->val_});
+}
+
+auto SeqScanExecutor::CanSkipPage(page_id_t page_id) const -> bool {
+  for (const auto &pred : zone_predicates_) {
+    auto zone = zone_map_->GetColumnZone(page_id, pred.col_idx_);
+    if (!zone.has_value()) {
+      continue;
+    }
+    if (!zone->has_range_) {
+      // only NULLs on this page, no comparison can be true
+      return true;
+    }
+    const auto &value = pred.value_;
+    switch (pred.comp_type_) {
+      case ComparisonType::Equal:
+        if (value.CompareLessThan(zone->min_) == CmpBool::CmpTrue ||
+            value.CompareGreaterThan(zone->max_) == CmpBool::CmpTrue) {
+          return true;
+        }
+        break;
+      case ComparisonType::NotEqual:
+        if (value.CompareEquals(zone->min_) == CmpBool::CmpTrue &&
+            value.CompareEquals(zone->max_) == CmpBool::CmpTrue) {
+          return true;
+        }
+        break;
+      case ComparisonType::LessThan:
+        if (zone->min_.CompareGreaterThanEquals(value) == CmpBool::CmpTrue) {
+          return true;
+        }
+        break;
+      case ComparisonType::LessThanOrEqual:
+        if (zone->min_.CompareGreaterThan(value) == CmpBool::CmpTrue) {
+          return true;
+        }
+        break;
+      case ComparisonType::GreaterThan:
+        if (zone->max_.CompareLessThanEquals(value) == CmpBool::CmpTrue) {
+          return true;
+        }
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        if (zone->max_.CompareLessThan(value) == CmpBool::CmpTrue) {
+          return true;
+        }
+        break;
+    }
+  }
+  return false;
+}
+
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return ScanNext(tuple, rid, nullptr); }
+
+auto SeqScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(GetOutputSchema().GetColumnCount());
+  Tuple tuple{};
+  RID rid{};
+  while (!batch->IsFull() && ScanNext(&tuple, &rid, batch)) {
+    // ScanNext has appended the tuple to the batch
+  }
+  return !batch->IsEmpty();
+}
+
+auto SeqScanExecutor::ScanNext(Tuple *tuple, RID *rid, TupleBatch *batch) -> bool {
   while (true) {
     if (table_iter_->IsEnd()) {
       // is the end
       if (!exec_ctx_->IsDelete() &&
           exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
-        // unlock all slock
-        if (exec_ctx_->GetTransaction()->GetIntentionExclusiveTableLockSet()->count(plan_->GetTableOid()) == 0) {
+        // unlock all slock, once: a batch consumer asks again after the scan has ended
+        if (exec_ctx_->GetTransaction()->GetIntentionSharedTableLockSet()->count(plan_->GetTableOid()) != 0) {
           try {
             bool unlock_success =
                 exec_ctx_->GetLockManager()->UnlockTable(exec_ctx_->GetTransaction(), plan_->GetTableOid());
@@ -81,12 +261,21 @@ auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
       return false;
     }
 
+    // skip whole pages whose zone cannot satisfy the predicate, without reading or locking their tuples
+    if (!zone_predicates_.empty() && table_iter_->GetRID().GetPageId() != zone_checked_page_) {
+      zone_checked_page_ = table_iter_->GetRID().GetPageId();
+      if (CanSkipPage(zone_checked_page_)) {
+        table_iter_->SkipPage();
+        continue;
+      }
+    }
+
     // judge is delete or not
-    *tuple = table_iter_->GetTuple().second;
+    RID cur_rid = table_iter_->GetRID();
     if (exec_ctx_->IsDelete()) {
       try {
         bool lock_success = exec_ctx_->GetLockManager()->LockRow(
-            exec_ctx_->GetTransaction(), LockManager::LockMode::EXCLUSIVE, plan_->GetTableOid(), tuple->GetRid());
+            exec_ctx_->GetTransaction(), LockManager::LockMode::EXCLUSIVE, plan_->GetTableOid(), cur_rid);
         if (!lock_success) {
           throw ExecutionException("SeqScanExecutor lockrow try to get X lock failed in delete mode");
         }
@@ -97,11 +286,10 @@ auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
       // get slock
       if (exec_ctx_->GetTransaction()->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED) {
         if (exec_ctx_->GetTransaction()->GetExclusiveRowLockSet()->count(plan_->GetTableOid()) == 0 ||
-            exec_ctx_->GetTransaction()->GetExclusiveRowLockSet()->at(plan_->GetTableOid()).count(tuple->GetRid()) ==
-                0) {
+            exec_ctx_->GetTransaction()->GetExclusiveRowLockSet()->at(plan_->GetTableOid()).count(cur_rid) == 0) {
           try {
             bool lock_success = exec_ctx_->GetLockManager()->LockRow(
-                exec_ctx_->GetTransaction(), LockManager::LockMode::SHARED, plan_->GetTableOid(), tuple->GetRid());
+                exec_ctx_->GetTransaction(), LockManager::LockMode::SHARED, plan_->GetTableOid(), cur_rid);
             if (!lock_success) {
               throw ExecutionException("SeqScanExecutor lockrow try to get S lock failed");
             }
@@ -112,19 +300,43 @@ auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
       }
     }
 
-    // tuple is deleted, continue
-    if (table_iter_->GetTuple().first.is_deleted_ ||
-        (plan_->filter_predicate_ != nullptr &&
-         plan_->filter_predicate_->Evaluate(tuple, exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())->schema_)
-                 .CompareEquals(ValueFactory::GetBooleanValue(false)) == CmpBool::CmpTrue)) {
+    // Evaluate the predicate directly on the page bytes and only copy out the tuples that survive it. The page guard
+    // must be dropped before returning, since the parent executor may write to the same page.
+    // Without a dictionary a batch takes its values straight from the page bytes.
+    bool skip;
+    bool appended = false;
+    {
+      ReadPageGuard guard;
+      auto [meta, view] = table_iter_->GetTupleView(&guard);
+      skip = meta.is_deleted_;
+      if (!skip && scan_predicate_ != nullptr) {
+        auto value = scan_predicate_->EvaluateView(view, *schema_);
+        skip = value.IsNull() || !value.GetAs<bool>();
+      }
+      if (!skip && batch != nullptr && dictionary_ == nullptr) {
+        batch->AppendRow(view, *schema_);
+        appended = true;
+      } else if (!skip) {
+        *tuple = view.Materialize();
+      }
+    }
+    if (!skip && dictionary_ != nullptr) {
+      *tuple = dictionary_->DecodeTuple(*tuple);
+      if (filter_after_decode_) {
+        auto value = plan_->filter_predicate_->Evaluate(tuple, GetOutputSchema());
+        skip = value.IsNull() || !value.GetAs<bool>();
+      }
+    }
+
+    // tuple is deleted or filtered out, continue
+    if (skip) {
       if (exec_ctx_->IsDelete() ||
           exec_ctx_->GetTransaction()->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED) {
         if (exec_ctx_->GetTransaction()->GetExclusiveRowLockSet()->count(plan_->GetTableOid()) == 0 ||
-            exec_ctx_->GetTransaction()->GetExclusiveRowLockSet()->at(plan_->GetTableOid()).count(tuple->GetRid()) ==
-                0) {
+            exec_ctx_->GetTransaction()->GetExclusiveRowLockSet()->at(plan_->GetTableOid()).count(cur_rid) == 0) {
           try {
             bool unlock_success = exec_ctx_->GetLockManager()->UnlockRow(exec_ctx_->GetTransaction(),
-                                                                         plan_->GetTableOid(), tuple->GetRid(), true);
+                                                                         plan_->GetTableOid(), cur_rid, true);
             if (!unlock_success) {
               throw ExecutionException("SeqScanExecutor try to unlock row failed");
             }
@@ -139,10 +351,10 @@ auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
 
     if (!exec_ctx_->IsDelete() && exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
       if (exec_ctx_->GetTransaction()->GetExclusiveRowLockSet()->count(plan_->GetTableOid()) == 0 ||
-          exec_ctx_->GetTransaction()->GetExclusiveRowLockSet()->at(plan_->GetTableOid()).count(tuple->GetRid()) == 0) {
+          exec_ctx_->GetTransaction()->GetExclusiveRowLockSet()->at(plan_->GetTableOid()).count(cur_rid) == 0) {
         try {
-          bool unlock_success = exec_ctx_->GetLockManager()->UnlockRow(exec_ctx_->GetTransaction(),
-                                                                       plan_->GetTableOid(), tuple->GetRid());
+          bool unlock_success =
+              exec_ctx_->GetLockManager()->UnlockRow(exec_ctx_->GetTransaction(), plan_->GetTableOid(), cur_rid);
           if (!unlock_success) {
             throw ExecutionException("SeqScanExecutor try to unlock Slock failed");
           }
@@ -152,8 +364,10 @@ auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
       }
     }
 
-    *tuple = table_iter_->GetTuple().second;
-    *rid = table_iter_->GetRID();
+    if (batch != nullptr && !appended) {
+      batch->AppendRow(*tuple, GetOutputSchema(), cur_rid);
+    }
+    *rid = cur_rid;
     break;
   }
 
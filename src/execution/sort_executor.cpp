@@ -17,7 +17,7 @@ void SortExecutor::Init() {
   Tuple tuple{};
   RID rid{};
   while (child_executor_->Next(&tuple, &rid)) {
-    tupleres_.push_back(tuple);
+    tupleres_.push_back(std::move(tuple));
   }
   std::sort(tupleres_.begin(), tupleres_.end(), [&](const Tuple &t1, const Tuple &t2) -> bool {
     for (auto [order_by_type, expr] : plan_->GetOrderBy()) {
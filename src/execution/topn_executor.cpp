@@ -41,7 +41,7 @@ void TopNExecutor::Init() {
   };
   std::priority_queue<Tuple, std::vector<Tuple>, decltype(cmp)> pq{cmp};
   while (child_executor_->Next(&tuple, &rid)) {
-    pq.push(tuple);
+    pq.push(std::move(tuple));
     if (pq.size() > plan_->GetN()) {
       pq.pop();
     }
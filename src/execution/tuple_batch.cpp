@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+void TupleBatch::Reset(uint32_t column_count) {
+  columns_.resize(column_count);
+  for (auto &column : columns_) {
+    column.clear();
+  }
+  rids_.clear();
+  selection_.clear();
+  all_selected_ = true;
+}
+
+void TupleBatch::AppendRow(const Tuple &tuple, const Schema &schema, RID rid) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].push_back(tuple.GetValue(&schema, i));
+  }
+  rids_.push_back(rid);
+}
+
+void TupleBatch::AppendRow(const TupleView &view, const Schema &schema) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].push_back(view.GetValue(&schema, i));
+  }
+  rids_.push_back(view.GetRid());
+}
+
+void TupleBatch::AppendRow(const std::vector<Value> &values, RID rid) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].push_back(values[i]);
+  }
+  rids_.push_back(rid);
+}
+
+void TupleBatch::SetRids(std::vector<RID> rids) {
+  rids_ = std::move(rids);
+  selection_.clear();
+  all_selected_ = true;
+}
+
+void TupleBatch::Select(const std::vector<bool> &keep) {
+  std::vector<uint32_t> selection;
+  selection.reserve(keep.size());
+  for (size_t row = 0; row < keep.size(); row++) {
+    if (keep[row]) {
+      selection.push_back(static_cast<uint32_t>(RowAt(row)));
+    }
+  }
+  selection_ = std::move(selection);
+  all_selected_ = false;
+}
+
+void TupleBatch::Truncate(size_t count) {
+  if (count >= Size()) {
+    return;
+  }
+  if (all_selected_) {
+    // the rows past `count` are never read again, so they can go
+    for (auto &column : columns_) {
+      column.resize(count);
+    }
+    rids_.resize(count);
+  } else {
+    selection_.resize(count);
+  }
+}
+
+auto TupleBatch::ToTuple(size_t row, const Schema &schema, TupleArena *arena) const -> Tuple {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  auto physical = RowAt(row);
+  for (const auto &column : columns_) {
+    values.push_back(column[physical]);
+  }
+  return {std::move(values), &schema, arena};
+}
+
+}  // namespace bustub
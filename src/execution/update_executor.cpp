@@ -63,10 +63,22 @@ auto UpdateExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
       continue;
     }
     updated_count++;
+    // the new version lives at a new RID, so the entry of the old one goes in any case
     for (auto indexes : table_indexes_) {
-      auto key_attr = indexes->index_->GetKeyAttrs();
-      auto index_tuple = inserted_tuple.KeyFromTuple(table_info_->schema_, indexes->key_schema_, key_attr);
-      indexes->index_->InsertEntry(index_tuple, inserted_tuple_rid.value(), exec_ctx_->GetTransaction());
+      if (indexes->index_->IsIndexed(*tuple, table_info_->schema_)) {
+        auto delete_tuple = indexes->index_->KeyFromTuple(*tuple, table_info_->schema_);
+        indexes->index_->DeleteEntry(delete_tuple, *rid, exec_ctx_->GetTransaction());
+        auto idx_write_record = IndexWriteRecord(*rid, table_info_->oid_, WType::DELETE, delete_tuple,
+                                                 indexes->index_oid_, exec_ctx_->GetCatalog());
+        exec_ctx_->GetTransaction()->AppendIndexWriteRecord(idx_write_record);
+      }
+      if (indexes->index_->IsIndexed(inserted_tuple, table_info_->schema_)) {
+        auto index_tuple = indexes->index_->KeyFromTuple(inserted_tuple, table_info_->schema_);
+        indexes->index_->InsertEntry(index_tuple, inserted_tuple_rid.value(), exec_ctx_->GetTransaction());
+        auto idx_write_record = IndexWriteRecord(*inserted_tuple_rid, table_info_->oid_, WType::INSERT, index_tuple,
+                                                 indexes->index_oid_, exec_ctx_->GetCatalog());
+        exec_ctx_->GetTransaction()->AppendIndexWriteRecord(idx_write_record);
+      }
     }
   }
 
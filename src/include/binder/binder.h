@@ -32,6 +32,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <string>
@@ -237,6 +238,9 @@ class Binder {
   /** Store all statement parse node */
   std::vector<duckdb_libpgquery::PGNode *> statement_nodes_;
 
+  /** CREATE INDEX statements that pick their index type with a USING clause */
+  std::unordered_set<const duckdb_libpgquery::PGIndexStmt *> explicit_index_types_;
+
  private:
   /** Catalog will be used during the binding process. USERS SHOULD ENSURE IT OUTLIVES THE BINDER,
    * otherwise it's a dangling reference.
@@ -21,7 +21,8 @@ namespace bustub {
 class IndexStatement : public BoundStatement {
  public:
   explicit IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                          std::vector<std::unique_ptr<BoundColumnRef>> cols);
+                          std::vector<std::unique_ptr<BoundExpression>> keys, bool unique, std::string index_type,
+                          std::unique_ptr<BoundExpression> where);
 
   /** Name of the index */
   std::string index_name_;
@@ -29,8 +30,17 @@ class IndexStatement : public BoundStatement {
   /** Create on which table */
   std::unique_ptr<BoundBaseTableRef> table_;
 
-  /** Name of the columns */
-  std::vector<std::unique_ptr<BoundColumnRef>> cols_;
+  /** Key parts, each a column or an expression over the columns of the table */
+  std::vector<std::unique_ptr<BoundExpression>> keys_;
+
+  /** Whether the index was declared UNIQUE */
+  bool unique_;
+
+  /** Access method of the index, `btree`, `hash` or `art` */
+  std::string index_type_;
+
+  /** Only rows satisfying this predicate are indexed, nullptr for a full index */
+  std::unique_ptr<BoundExpression> where_;
 
   auto ToString() const -> std::string override;
 };
@@ -181,13 +181,10 @@ class BufferPoolManager {
  private:
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
-  /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
-
   /** Array of buffer pool pages. */
   Page *pages_;
-  /** Pointer to the disk manager. */
-  DiskManager *disk_manager_ __attribute__((__unused__));
+  /** Pointer to the disk manager, it also decides which page ids are free. */
+  DiskManager *disk_manager_;
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
   /** Page table for keeping track of buffer pool pages. */
@@ -206,12 +203,18 @@ class BufferPoolManager {
   auto AllocatePage() -> page_id_t;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Deallocate a page on disk, later allocations may reuse it. Caller should acquire the latch before calling
+   * this function.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id);
+
+  /**
+   * @brief Forget the page held by an unpinned frame and put the frame back on the free list. Caller should acquire
+   * the latch before calling this function.
+   * @param frame_id id of the frame to release
+   */
+  void ReleaseFrame(frame_id_t frame_id);
 
   // TODO(student): You may add additional private members and helper functions
 };
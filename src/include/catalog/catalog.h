@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -20,7 +21,9 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "common/exception.h"
 #include "container/hash/hash_function.h"
+#include "storage/index/art_index.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
@@ -58,6 +61,16 @@ struct TableInfo {
   const table_oid_t oid_;
 };
 
+/** The data structures an index can be built on. */
+enum class IndexType {
+  /** Ordered, answers point lookups and range scans */
+  BPlusTreeIndex,
+  /** Extendible hash table, answers point lookups on the whole key only */
+  HashTableIndex,
+  /** In-memory adaptive radix tree, ordered like the B+ tree but off the buffer pool */
+  ArtIndex,
+};
+
 /**
  * The IndexInfo class maintains metadata about a index.
  */
@@ -70,15 +83,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The data structure of the index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,6 +106,8 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The data structure of the index */
+  const IndexType index_type_;
 };
 
 /**
@@ -137,6 +154,11 @@ class Catalog {
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
       table = std::make_unique<TableHeap>(bpm_);
+      table->EnableZoneMap(schema);
+      const auto &columns = schema.GetColumns();
+      if (std::any_of(columns.begin(), columns.end(), [](const Column &col) { return col.IsDictionaryEncoded(); })) {
+        table->EnableDictionary(schema);
+      }
     }
 
     // Fetch the table OID for the new table
@@ -196,58 +218,131 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param fill_factor Fraction of each index page filled when the index is built from existing tuples
+   * @param is_unique Whether a key may be stored at most once, otherwise B+ trees append the RID to every key
+   * @param index_type The data structure to build the index on
+   * @param key_exprs The expression computing each key column, empty if key_attrs are all table columns
+   * @param predicate Only tuples satisfying it are indexed, nullptr to index every tuple
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
-    // Reject the creation request for nonexistent table
-    if (table_names_.find(table_name) == table_names_.end()) {
+                   HashFunction<KeyType> hash_function, double fill_factor = INDEX_FILL_FACTOR, bool is_unique = true,
+                   IndexType index_type = IndexType::BPlusTreeIndex,
+                   const std::vector<AbstractExpressionRef> &key_exprs = {},
+                   const AbstractExpressionRef &predicate = nullptr) -> IndexInfo * {
+    // Reject the creation request for nonexistent table or an index name already in use
+    if (!CanCreateIndex(index_name, table_name)) {
       return NULL_INDEX_INFO;
     }
 
-    // If the table exists, an entry for the table should already be present in index_names_
-    BUSTUB_ASSERT((index_names_.find(table_name) != index_names_.end()), "Broken Invariant");
-
-    // Determine if the requested index already exists for this table
-    auto &table_indexes = index_names_.find(table_name)->second;
-    if (table_indexes.find(index_name) != table_indexes.end()) {
-      // The requested index already exists for this table
-      return NULL_INDEX_INFO;
+    // Construct the index, take ownership of metadata, and populate it with all tuples in the table heap
+    auto meta = MakeIndexMetadata(index_name, table_name, schema, key_schema, key_attrs, is_unique, key_exprs,
+                                  predicate);
+    std::unique_ptr<Index> index;
+    if (index_type == IndexType::HashTableIndex) {
+      index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                            hash_function);
+      InsertTableTuples(index.get(), table_name, schema, txn);
+    } else {
+      // sorted and loaded bottom-up
+      auto tree_index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+      tree_index->BulkLoad(GetTable(table_name)->table_.get(), schema, fill_factor, txn);
+      index = std::move(tree_index);
     }
+    return RegisterIndex(std::move(index), table_name, key_schema, keysize, index_type);
+  }
 
-    // Construct index metdata
-    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
-
-    // Construct the index, take ownership of metadata
-    // TODO(Kyle): We should update the API for CreateIndex
-    // to allow specification of the index type itself, not
-    // just the key, value, and comparator types
-
-    // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
-
-    // Populate the index with all tuples in table heap
-    auto *table_meta = GetTable(table_name);
-    for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
-      auto [meta, tuple] = iter.GetTuple();
-      index->InsertEntry(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid(), txn);
+  /**
+   * Create a new index, choosing the key and comparator instantiation from the shape of `key_schema`. Keys of one or
+   * two INTEGER columns or a single BIGINT column get a comparator that works on the raw key bytes, any other key goes
+   * into the smallest GenericKey that holds its widest possible value. B+ tree pages drop the trailing zero padding
+   * of their keys, but a page that cannot compress its keys still holds only as many as fit at the full width, so
+   * the size classes are spaced 8 bytes apart up to 48 bytes to keep that worst case close to the key's own size.
+   * The 64 and 96 byte classes above them take keys up to a VARCHAR(64) column. Non-unique B+ tree indexes
+   * need 8 more bytes per key for the RID that tells duplicates apart, hash buckets keep duplicates as separate
+   * entries and do not. ART indexes key on byte strings and skip the size classes.
+   * @param txn The transaction in which the table is being created
+   * @param index_name The name of the new index
+   * @param table_name The name of the table
+   * @param schema The schema of the table
+   * @param key_schema The schema of the key
+   * @param key_attrs Key attributes
+   * @param is_unique Whether a key may be stored at most once
+   * @param fill_factor Fraction of each index page filled when the index is built from existing tuples
+   * @param index_type The data structure to build the index on
+   * @param key_exprs The expression computing each key column, empty if key_attrs are all table columns
+   * @param predicate Only tuples satisfying it are indexed, nullptr to index every tuple
+   * @return A (non-owning) pointer to the metadata of the new table
+   */
+  auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
+                   const Schema &key_schema, const std::vector<uint32_t> &key_attrs, bool is_unique,
+                   double fill_factor = INDEX_FILL_FACTOR, IndexType index_type = IndexType::BPlusTreeIndex,
+                   const std::vector<AbstractExpressionRef> &key_exprs = {},
+                   const AbstractExpressionRef &predicate = nullptr) -> IndexInfo * {
+    if (index_type == IndexType::ArtIndex) {
+      return CreateArtIndex(txn, index_name, table_name, schema, key_schema, key_attrs, is_unique, key_exprs,
+                            predicate);
     }
-
-    // Get the next OID for the new index
-    const auto index_oid = next_index_oid_.fetch_add(1);
-
-    // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
-    auto *tmp = index_info.get();
-
-    // Update internal tracking
-    indexes_.emplace(index_oid, std::move(index_info));
-    table_indexes.emplace(index_name, index_oid);
-
-    return tmp;
+    bool rid_suffix = !is_unique && index_type == IndexType::BPlusTreeIndex;
+    if (IntegerComparatorType::Supports(key_schema)) {
+      return rid_suffix ? CreateIntegerIndex<INTEGER_RID_KEY_SIZE, int32_t>(txn, index_name, table_name, schema,
+                                                                             key_schema, key_attrs, fill_factor,
+                                                                             is_unique, index_type,
+                                                                             key_exprs, predicate)
+                        : CreateIntegerIndex<TWO_INTEGER_SIZE, int32_t>(txn, index_name, table_name, schema,
+                                                                         key_schema, key_attrs, fill_factor,
+                                                                         is_unique, index_type, key_exprs, predicate);
+    }
+    if (BigintComparatorType::Supports(key_schema)) {
+      return rid_suffix ? CreateIntegerIndex<INTEGER_RID_KEY_SIZE, int64_t>(txn, index_name, table_name, schema,
+                                                                             key_schema, key_attrs, fill_factor,
+                                                                             is_unique, index_type,
+                                                                             key_exprs, predicate)
+                        : CreateIntegerIndex<TWO_INTEGER_SIZE, int64_t>(txn, index_name, table_name, schema,
+                                                                         key_schema, key_attrs, fill_factor,
+                                                                         is_unique, index_type, key_exprs, predicate);
+    }
+    // a key tuple is the fixed-size part followed by a length-prefixed, null-terminated copy of each string
+    size_t key_size = key_schema.GetLength() + (rid_suffix ? sizeof(int64_t) : 0);
+    for (auto idx : key_schema.GetUnlinedColumns()) {
+      key_size += sizeof(uint32_t) + key_schema.GetColumn(idx).GetVariableLength() + 1;
+    }
+    if (key_size <= 8) {
+      return CreateGenericIndex<8>(txn, index_name, table_name, schema, key_schema, key_attrs, fill_factor, is_unique,
+                                   index_type, key_exprs, predicate);
+    }
+    if (key_size <= 16) {
+      return CreateGenericIndex<16>(txn, index_name, table_name, schema, key_schema, key_attrs, fill_factor,
+                                    is_unique, index_type, key_exprs, predicate);
+    }
+    if (key_size <= 24) {
+      return CreateGenericIndex<24>(txn, index_name, table_name, schema, key_schema, key_attrs, fill_factor,
+                                    is_unique, index_type, key_exprs, predicate);
+    }
+    if (key_size <= 32) {
+      return CreateGenericIndex<32>(txn, index_name, table_name, schema, key_schema, key_attrs, fill_factor,
+                                    is_unique, index_type, key_exprs, predicate);
+    }
+    if (key_size <= 40) {
+      return CreateGenericIndex<40>(txn, index_name, table_name, schema, key_schema, key_attrs, fill_factor,
+                                    is_unique, index_type, key_exprs, predicate);
+    }
+    if (key_size <= 48) {
+      return CreateGenericIndex<48>(txn, index_name, table_name, schema, key_schema, key_attrs, fill_factor,
+                                    is_unique, index_type, key_exprs, predicate);
+    }
+    if (key_size <= 64) {
+      return CreateGenericIndex<64>(txn, index_name, table_name, schema, key_schema, key_attrs, fill_factor,
+                                    is_unique, index_type, key_exprs, predicate);
+    }
+    if (key_size <= MAX_INDEX_KEY_SIZE) {
+      return CreateGenericIndex<MAX_INDEX_KEY_SIZE>(txn, index_name, table_name, schema, key_schema, key_attrs,
+                                                    fill_factor, is_unique, index_type, key_exprs, predicate);
+    }
+    throw NotImplementedException(
+        fmt::format("index key of up to {} bytes is wider than {} bytes", key_size, MAX_INDEX_KEY_SIZE));
   }
 
   /**
@@ -298,7 +393,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
@@ -342,6 +437,96 @@ class Catalog {
   }
 
  private:
+  /** @return whether table `table_name` exists and has no index named `index_name` yet */
+  auto CanCreateIndex(const std::string &index_name, const std::string &table_name) const -> bool {
+    if (table_names_.find(table_name) == table_names_.end()) {
+      return false;
+    }
+
+    // If the table exists, an entry for the table should already be present in index_names_
+    auto table_indexes = index_names_.find(table_name);
+    BUSTUB_ASSERT((table_indexes != index_names_.end()), "Broken Invariant");
+    return table_indexes->second.find(index_name) == table_indexes->second.end();
+  }
+
+  static auto MakeIndexMetadata(const std::string &index_name, const std::string &table_name, const Schema &schema,
+                                const Schema &key_schema, const std::vector<uint32_t> &key_attrs, bool is_unique,
+                                const std::vector<AbstractExpressionRef> &key_exprs,
+                                const AbstractExpressionRef &predicate) -> std::unique_ptr<IndexMetadata> {
+    if (key_exprs.empty() && predicate == nullptr) {
+      return std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs, is_unique);
+    }
+    return std::make_unique<IndexMetadata>(index_name, table_name, key_schema, key_attrs, is_unique, key_exprs,
+                                           predicate);
+  }
+
+  /** Insert every live tuple of the table that belongs in `index`, one at a time. */
+  void InsertTableTuples(Index *index, const std::string &table_name, const Schema &schema, Transaction *txn) {
+    for (auto iter = GetTable(table_name)->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
+      auto [tuple_meta, tuple] = iter.GetTuple();
+      if (!tuple_meta.is_deleted_ && index->IsIndexed(tuple, schema)) {
+        index->InsertEntry(index->KeyFromTuple(tuple, schema), iter.GetRID(), txn);
+      }
+    }
+  }
+
+  /** Give a populated index its OID and make it visible on its table. */
+  auto RegisterIndex(std::unique_ptr<Index> &&index, const std::string &table_name, const Schema &key_schema,
+                     size_t keysize, IndexType index_type) -> IndexInfo * {
+    // Get the next OID for the new index
+    const auto index_oid = next_index_oid_.fetch_add(1);
+    auto index_name = index->GetName();
+
+    // Construct index information; IndexInfo takes ownership of the Index itself
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
+    auto *tmp = index_info.get();
+
+    // Update internal tracking
+    indexes_.emplace(index_oid, std::move(index_info));
+    index_names_.find(table_name)->second.emplace(index_name, index_oid);
+
+    return tmp;
+  }
+
+  /** Create an ART index, which keys on encoded byte strings of any length and needs no key type. */
+  auto CreateArtIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                      const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
+                      bool is_unique, const std::vector<AbstractExpressionRef> &key_exprs,
+                      const AbstractExpressionRef &predicate) -> IndexInfo * {
+    if (!CanCreateIndex(index_name, table_name)) {
+      return NULL_INDEX_INFO;
+    }
+    auto index = std::make_unique<ArtIndex>(
+        MakeIndexMetadata(index_name, table_name, schema, key_schema, key_attrs, is_unique, key_exprs, predicate));
+    InsertTableTuples(index.get(), table_name, schema, txn);
+    return RegisterIndex(std::move(index), table_name, key_schema, key_schema.GetLength(), IndexType::ArtIndex);
+  }
+
+  /** Create an index over GenericKey<KeySize> compared through Value. */
+  template <size_t KeySize>
+  auto CreateGenericIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
+                          double fill_factor, bool is_unique, IndexType index_type,
+                          const std::vector<AbstractExpressionRef> &key_exprs, const AbstractExpressionRef &predicate)
+      -> IndexInfo * {
+    return CreateIndex<GenericKey<KeySize>, RID, GenericComparator<KeySize>>(
+        txn, index_name, table_name, schema, key_schema, key_attrs, KeySize, HashFunction<GenericKey<KeySize>>{},
+        fill_factor, is_unique, index_type, key_exprs, predicate);
+  }
+
+  /** Create an index over GenericKey<KeySize> holding packed integers of type IntType. */
+  template <size_t KeySize, typename IntType>
+  auto CreateIntegerIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
+                          double fill_factor, bool is_unique, IndexType index_type,
+                          const std::vector<AbstractExpressionRef> &key_exprs, const AbstractExpressionRef &predicate)
+      -> IndexInfo * {
+    return CreateIndex<GenericKey<KeySize>, RID, IntegerComparator<KeySize, IntType>>(
+        txn, index_name, table_name, schema, key_schema, key_attrs, KeySize, HashFunction<GenericKey<KeySize>>{},
+        fill_factor, is_unique, index_type, key_exprs, predicate);
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
@@ -93,6 +93,15 @@ class Column {
   /** @return true if column is inlined, false otherwise */
   auto IsInlined() const -> bool { return column_type_ != TypeId::VARCHAR; }
 
+  /** @return true if the table heap stores this column as a dictionary code */
+  auto IsDictionaryEncoded() const -> bool { return dictionary_encoded_; }
+
+  /** Store this VARCHAR column as a dictionary code, see TableDictionary. */
+  void SetDictionaryEncoded(bool dictionary_encoded) {
+    BUSTUB_ASSERT(!dictionary_encoded || column_type_ == TypeId::VARCHAR, "Only VARCHAR columns can be encoded.");
+    dictionary_encoded_ = dictionary_encoded;
+  }
+
   /** @return a string representation of this column */
   auto ToString(bool simplified = true) const -> std::string;
 
@@ -136,6 +145,9 @@ class Column {
 
   /** Column offset in the tuple. */
   uint32_t column_offset_{0};
+
+  /** Whether the table heap stores this column as a dictionary code. */
+  bool dictionary_encoded_{false};
 };
 
 }  // namespace bustub
@@ -17,6 +17,7 @@
 #include <optional>
 #include <shared_mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -24,6 +25,7 @@
 
 #include "catalog/catalog.h"
 #include "common/config.h"
+#include "common/exception.h"
 #include "common/util/string_util.h"
 #include "execution/check_options.h"
 #include "libfort/lib/fort.hpp"
@@ -275,6 +277,30 @@ class BustubInstance {
     return variable == "1" || variable == "true" || variable == "yes";
   }
 
+  /** Fill factor for indexes built by CREATE INDEX, set by `set index_fill_factor=0.7`. */
+  auto GetIndexFillFactor() -> double {
+    auto variable = GetSessionVariable("index_fill_factor");
+    if (variable.empty()) {
+      return INDEX_FILL_FACTOR;
+    }
+    double fill_factor = 0;
+    try {
+      fill_factor = std::stod(variable);
+    } catch (const std::logic_error &e) {
+      throw Exception("invalid index_fill_factor: " + variable);
+    }
+    if (!(fill_factor > 0 && fill_factor <= 1)) {
+      throw Exception("index_fill_factor must be in (0, 1]: " + variable);
+    }
+    return fill_factor;
+  }
+
+  /** Whether CREATE INDEX gives B+ tree indexes a Bloom filter, set by `set index_bloom_filter=true`. */
+  auto IsIndexBloomFilterEnabled() -> bool {
+    auto variable = StringUtil::Lower(GetSessionVariable("index_bloom_filter"));
+    return variable == "1" || variable == "true" || variable == "yes";
+  }
+
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
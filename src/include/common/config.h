@@ -36,6 +36,11 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr double INDEX_FILL_FACTOR = 0.9;  // fill factor of B+ tree pages built by CREATE INDEX
+static constexpr size_t INDEX_JOIN_BATCH_SIZE = 1024;  // outer tuples probed together by an index join
+static constexpr size_t INDEX_BULK_LOAD_MAX_KEYS = 1 << 18;  // keys CREATE INDEX sorts in memory, the rest is inserted
+static constexpr size_t INDEX_BULK_DELETE_MIN_KEYS = 64;  // smallest batch a B+ tree index removes in a single pass
+static constexpr size_t EXECUTION_BATCH_SIZE = 1024;  // rows an executor hands to its parent per NextBatch call
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
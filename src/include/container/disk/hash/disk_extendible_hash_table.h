@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <queue>
 #include <string>
 #include <vector>
@@ -30,6 +32,11 @@ namespace bustub {
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table grows/shrinks dynamically as buckets become full/empty.
+ *
+ * A full bucket that cannot be split because the directory is at its largest
+ * size grows a chain of overflow pages. The chain is only read or changed
+ * while the primary bucket page is latched, so overflow pages are pinned but
+ * never latched themselves.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class DiskExtendibleHashTable {
@@ -40,9 +47,12 @@ class DiskExtendibleHashTable {
    * @param buffer_pool_manager buffer pool manager to be used
    * @param comparator comparator for keys
    * @param hash_fn the hash function
+   * @param unique_keys whether a key may be stored at most once, otherwise only exact key-value duplicates are
+   * rejected
    */
   explicit DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                   bool unique_keys = false);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -136,6 +146,40 @@ class DiskExtendibleHashTable {
    */
   auto FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE *;
 
+  /**
+   * Fetches and latches the bucket page `key` maps to without taking the table latch. The directory is read
+   * optimistically: if a split or merge changed it before the bucket was latched, the lookup starts over.
+   *
+   * @param key the key for lookup
+   * @param exclusive whether to take the bucket's write latch instead of its read latch
+   * @return the pinned and latched bucket page
+   */
+  auto FetchLatchedBucketPage(const KeyType &key, bool exclusive) -> Page *;
+
+  /** Make the directory version odd, optimistic readers wait or retry until EndDirectoryUpdate(). */
+  void BeginDirectoryUpdate();
+
+  /** Make the directory version even again, publishing the changes made since BeginDirectoryUpdate(). */
+  void EndDirectoryUpdate();
+
+  /** Marks an optimistic directory read as running, so that the bucket it may still pin is not deleted under it. */
+  class ReaderGuard {
+   public:
+    explicit ReaderGuard(DiskExtendibleHashTable *table);
+    ~ReaderGuard();
+    ReaderGuard(const ReaderGuard &) = delete;
+    auto operator=(const ReaderGuard &) -> ReaderGuard & = delete;
+
+   private:
+    std::atomic<uint64_t> *slot_;
+  };
+
+  /**
+   * Wait until every optimistic reader that started before the last EndDirectoryUpdate() is done, after which no one
+   * can reach a bucket that update unlinked. The caller holds the table latch, so no new update can start meanwhile.
+   */
+  void WaitForReaders();
+
   /**
    * Performs insertion with an optional bucket splitting.
    *
@@ -161,14 +205,46 @@ class DiskExtendibleHashTable {
    */
   void Merge(Transaction *transaction, const KeyType &key, const ValueType &value);
 
+  /**
+   * @return whether inserting the pair into `bucket` would violate uniqueness: the key is there already if keys are
+   * unique, the exact pair is there otherwise
+   */
+  auto IsDuplicate(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value) -> bool;
+
+  /**
+   * Collect the values of `key` from `bucket` and its overflow pages.
+   * @return true if at least one key matched
+   */
+  auto ChainGetValue(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, std::vector<ValueType> *result) -> bool;
+
+  /**
+   * Insert the pair into the first page of the chain of `bucket` that has a free slot, appending an overflow page if
+   * every page is full. Uniqueness must have been checked already.
+   */
+  void ChainInsert(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value);
+
+  /**
+   * Remove the pair from `bucket` or its overflow pages, an overflow page left empty is unlinked and deleted.
+   * @return true if the pair was found
+   */
+  auto ChainRemove(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value) -> bool;
+
   // member variables
   page_id_t directory_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writers are splits and merges
+  // Taken in write mode by splits and merges, which rewrite the directory, and in read mode by VerifyIntegrity.
+  // Lookups, inserts and removes do not take it, they validate their directory reads against dir_version_
   ReaderWriterLatch table_latch_;
+  // Incremented before and after every directory change, odd while a change is in progress. It starts above 0, which
+  // marks a free reader slot
+  std::atomic<uint64_t> dir_version_{2};
+  static constexpr size_t READER_SLOTS = 64;
+  // The directory version each running optimistic reader started at, 0 for a free slot
+  std::array<std::atomic<uint64_t>, READER_SLOTS> reader_versions_{};
   HashFunction<KeyType> hash_fn_;
+  bool unique_keys_;
 };
 
 }  // namespace bustub
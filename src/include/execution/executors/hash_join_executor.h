@@ -13,13 +13,16 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "common/util/hash_util.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/hash_join_plan.h"
 #include "storage/table/tuple.h"
+#include "type/value.h"
 
 namespace bustub {
 
@@ -49,6 +52,13 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The tuples produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the join */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
@@ -58,8 +68,29 @@ class HashJoinExecutor : public AbstractExecutor {
   std::unique_ptr<AbstractExecutor> left_executor_;
   std::unique_ptr<AbstractExecutor> right_executor_;
 
-  std::vector<Tuple> tupleres_;
-  std::vector<Tuple>::iterator tupleres_iter_{tupleres_.begin()};
+  /** Pull the next batch of the left child and compute the join keys of its rows */
+  auto FetchLeftBatch() -> bool;
+
+  /** The values of every right tuple */
+  std::vector<std::vector<Value>> right_rows_;
+  /** The join key values of every right tuple */
+  std::vector<std::vector<Value>> right_keys_;
+  /** The right tuples by the hash of their join keys */
+  std::unordered_map<hash_t, std::vector<size_t>> right_ht_;
+
+  /** The left batch being probed, with the join keys (one vector per key expression) and key hash of its rows */
+  TupleBatch left_batch_;
+  std::vector<std::vector<Value>> left_keys_;
+  std::vector<hash_t> left_hashes_;
+  /** The left row being probed, and how far into its bucket the probe got */
+  size_t left_row_{0};
+  size_t match_pos_{0};
+  bool left_matched_{false};
+  bool left_done_{false};
+
+  /** Rows handed out one at a time by Next() */
+  TupleBatch out_batch_;
+  size_t out_pos_{0};
 };
 
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "common/rid.h"
@@ -43,10 +44,28 @@ class IndexScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** @return a tuple of the output schema holding the key values of the current index entry */
+  auto MakeTupleFromKey() -> Tuple;
+
+  /** @return whether the transaction already holds an X lock on the row */
+  auto HoldsExclusiveRowLock(const RID &rid) -> bool;
+
+  /** Take an S lock on the row unless the isolation level or an X lock held on it make that unnecessary. */
+  void LockRow(const RID &rid);
+
+  /** Release the S lock taken by LockRow(), `force` releases it without the transaction leaving its growing phase. */
+  void UnlockRow(const RID &rid, bool force);
+
+  /** Under read committed, release the IS lock on the table once the scan is done. */
+  void UnlockTable();
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
   IndexInfo *index_info_;
   const TableInfo *table_info_;
-  BPlusTreeIndexIteratorForTwoIntegerColumn index_iter_;
+  /** Cursor over the index, opened in Init() */
+  std::unique_ptr<IndexScanCursor> cursor_;
+  /** For index-only scans, the position of each output column in the index key, or -1 if it is not a key column */
+  std::vector<int> key_positions_;
 };
 }  // namespace bustub
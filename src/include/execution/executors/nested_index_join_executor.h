@@ -22,6 +22,7 @@
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/nested_index_join_plan.h"
+#include "storage/index/index.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
@@ -48,7 +49,32 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Pull the next batch of outer tuples and probe the index for all of them at once. */
+  auto FetchBatch() -> bool;
+
+  /** @return whether the transaction already holds an X lock on the inner row */
+  auto HoldsExclusiveRowLock(const RID &rid) -> bool;
+
+  /** Take an S lock on the inner row unless the isolation level or an X lock held on it make that unnecessary. */
+  void LockRow(const RID &rid);
+
+  /** Release the S lock taken by LockRow(), `force` releases it without the transaction leaving its growing phase. */
+  void UnlockRow(const RID &rid, bool force);
+
+  /** Under read committed, release the IS lock on the inner table once the join is done. */
+  void UnlockTable();
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  const IndexInfo *index_info_;
+  const TableInfo *table_info_;
+  /** The current batch of outer tuples and the RIDs of their inner matches */
+  std::vector<Tuple> outer_batch_;
+  std::vector<std::vector<RID>> matches_;
+  /** Position in the batch: the outer tuple, its next match, and whether it has been joined yet */
+  size_t outer_pos_{0};
+  size_t match_pos_{0};
+  bool matched_{false};
 };
 }  // namespace bustub
@@ -17,9 +17,12 @@
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/comparison_expression.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/table_dictionary.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
@@ -46,12 +49,57 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the sequential scan.
+   * @param[out] batch The tuples produced by the scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /**
+   * Advance to the next visible tuple that satisfies the predicate, taking and releasing its row locks.
+   * @param[out] batch If not nullptr the tuple is appended to it, and `tuple` may be left unset
+   */
+  auto ScanNext(Tuple *tuple, RID *rid, TupleBatch *batch) -> bool;
+
+  /** A `column <op> constant` conjunct of the scan predicate that can be checked against a zone map */
+  struct ZonePredicate {
+    uint32_t col_idx_;
+    ComparisonType comp_type_;
+    Value value_;
+  };
+
+  /**
+   * Rewrite `expr` so that it can be evaluated on the stored codes of a dictionary-encoded table.
+   * @return the rewritten predicate, or nullptr if it needs the decoded strings
+   */
+  auto RewriteForDictionary(const AbstractExpressionRef &expr) const -> AbstractExpressionRef;
+
+  /** Collect the conjuncts of `expr` that the zone map can answer */
+  void CollectZonePredicates(const AbstractExpressionRef &expr);
+
+  /** @return true if no tuple on `page_id` can satisfy the scan predicate */
+  auto CanSkipPage(page_id_t page_id) const -> bool;
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
   std::unique_ptr<TableIterator> table_iter_;
+  /** The schema tuples are stored with, used to evaluate the pushed-down predicate */
+  const Schema *schema_{nullptr};
+  /** The dictionary of the scanned table, nullptr if no column is encoded */
+  const TableDictionary *dictionary_{nullptr};
+  /** The predicate evaluated on the stored tuples, nullptr if there is none or it needs decoded strings */
+  AbstractExpressionRef scan_predicate_;
+  /** Whether the predicate has to be evaluated after decoding */
+  bool filter_after_decode_{false};
+  /** The zone map of the scanned table, nullptr if it has none */
+  const ZoneMap *zone_map_{nullptr};
+  std::vector<ZonePredicate> zone_predicates_;
+  /** The last page that was checked against the zone map */
+  page_id_t zone_checked_page_{INVALID_PAGE_ID};
 };
 }  // namespace bustub
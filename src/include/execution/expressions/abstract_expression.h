@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
 
@@ -54,6 +55,32 @@ class AbstractExpression {
   /** @return The value obtained by evaluating the tuple with the given schema */
   virtual auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value = 0;
 
+  /**
+   * Evaluate the expression on a tuple view without materializing it. Expressions that only read columns should
+   * override this; the default falls back to copying the viewed tuple.
+   * @return The value obtained by evaluating the viewed tuple with the given schema
+   */
+  virtual auto EvaluateView(const TupleView &view, const Schema &schema) const -> Value {
+    auto tuple = view.Materialize();
+    return Evaluate(&tuple, schema);
+  }
+
+  /**
+   * Evaluate the expression on every selected row of a batch. Expressions should override this to work a column at a
+   * time; the default falls back to building each row as a tuple.
+   * @param batch The rows to evaluate on
+   * @param schema The schema of the batch's columns
+   * @param[out] result One value per selected row of `batch`
+   */
+  virtual void EvaluateBatch(const TupleBatch &batch, const Schema &schema, std::vector<Value> *result) const {
+    result->clear();
+    result->reserve(batch.Size());
+    for (size_t row = 0; row < batch.Size(); row++) {
+      auto tuple = batch.ToTuple(row, schema);
+      result->push_back(Evaluate(&tuple, schema));
+    }
+  }
+
   /**
    * Returns the value obtained by evaluating a JOIN.
    * @param left_tuple The left tuple
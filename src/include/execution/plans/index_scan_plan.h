@@ -29,9 +29,20 @@ class IndexScanPlanNode : public AbstractPlanNode {
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
    * @param table_oid the identifier of table to be scanned
+   * @param range bounds on the first key column, the default range scans the whole index
+   * @param filter_predicate the predicate every emitted tuple must satisfy, may be nullptr
+   * @param descending whether to emit the tuples in descending key order
+   * @param index_only whether to build the tuples from the index keys alone, without reading the table
    */
-  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
-      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, IndexKeyRange range = {},
+                    AbstractExpressionRef filter_predicate = nullptr, bool descending = false,
+                    bool index_only = false)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        range_(std::move(range)),
+        filter_predicate_(std::move(filter_predicate)),
+        descending_(descending),
+        index_only_(index_only) {}
 
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
@@ -43,11 +54,37 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** Only the index entries within this range are visited. */
+  IndexKeyRange range_;
+
+  /** The predicate the tuples found through the index are checked against, may be nullptr. */
+  AbstractExpressionRef filter_predicate_;
+
+  /** Whether the index is walked from the largest key down. */
+  bool descending_;
+
+  /**
+   * Whether the plan above only reads key columns. The emitted tuples then carry the key values and NULL in every
+   * other column, and the table heap is never touched.
+   */
+  bool index_only_;
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    auto result = fmt::format("IndexScan {{ index_oid={}", index_oid_);
+    if (!range_.IsFull()) {
+      result += fmt::format(", range={}", range_.ToString());
+    }
+    if (filter_predicate_ != nullptr) {
+      result += fmt::format(", filter={}", filter_predicate_);
+    }
+    if (descending_) {
+      result += ", descending";
+    }
+    if (index_only_) {
+      result += ", index_only";
+    }
+    return result + " }";
   }
 };
 
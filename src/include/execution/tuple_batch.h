@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * A batch of rows handed from an executor to its parent by NextBatch(). Values are stored column by column, and a
+ * selection vector lists the rows that are still part of the batch, so that a filter drops rows without moving any
+ * values. Row positions taken by the accessors below are positions in the selection, not physical rows.
+ */
+class TupleBatch {
+ public:
+  TupleBatch() = default;
+
+  /** Drop all rows and shape the batch for `column_count` columns. */
+  void Reset(uint32_t column_count);
+
+  /** Append a row decoded from a tuple laid out with `schema`. */
+  void AppendRow(const Tuple &tuple, const Schema &schema, RID rid);
+
+  /** Append a row decoded straight from page bytes laid out with `schema`. */
+  void AppendRow(const TupleView &view, const Schema &schema);
+
+  /** Append a row given as one value per column. */
+  void AppendRow(const std::vector<Value> &values, RID rid);
+
+  /** Replace a whole column, `values` holds one value per physical row. */
+  void SetColumn(uint32_t col_idx, std::vector<Value> values) { columns_[col_idx] = std::move(values); }
+
+  /** Replace the RIDs, which also sets the number of physical rows and selects all of them. */
+  void SetRids(std::vector<RID> rids);
+
+  /** Keep only the selected rows for which `keep` (one entry per selected row) is true. */
+  void Select(const std::vector<bool> &keep);
+
+  /** Keep only the first `count` selected rows. */
+  void Truncate(size_t count);
+
+  /** @return the number of selected rows */
+  auto Size() const -> size_t { return all_selected_ ? rids_.size() : selection_.size(); }
+
+  /** @return true if no row is selected */
+  auto IsEmpty() const -> bool { return Size() == 0; }
+
+  /** @return true if no more rows should be appended */
+  auto IsFull() const -> bool { return rids_.size() >= EXECUTION_BATCH_SIZE; }
+
+  auto GetColumnCount() const -> uint32_t { return static_cast<uint32_t>(columns_.size()); }
+
+  /** @return the physical row of the `row`'th selected row */
+  auto RowAt(size_t row) const -> size_t { return all_selected_ ? row : selection_[row]; }
+
+  /** @return all values of a column, indexed by physical row */
+  auto GetColumn(uint32_t col_idx) const -> const std::vector<Value> & { return columns_[col_idx]; }
+
+  auto GetValue(size_t row, uint32_t col_idx) const -> const Value & { return columns_[col_idx][RowAt(row)]; }
+
+  auto GetRid(size_t row) const -> RID { return rids_[RowAt(row)]; }
+
+  /** @return the `row`'th selected row as a tuple laid out with `schema` */
+  auto ToTuple(size_t row, const Schema &schema, TupleArena *arena = nullptr) const -> Tuple;
+
+ private:
+  /** One vector per column, each holding a value for every physical row */
+  std::vector<std::vector<Value>> columns_;
+  /** The RID of every physical row */
+  std::vector<RID> rids_;
+  /** Physical rows that are selected, in order; unused while all rows are selected */
+  std::vector<uint32_t> selection_;
+  bool all_selected_{true};
+};
+
+}  // namespace bustub
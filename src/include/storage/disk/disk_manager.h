@@ -16,6 +16,7 @@
 #include <fstream>
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
+#include <set>
 #include <string>
 
 #include "common/config.h"
@@ -58,6 +59,25 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Allocate a page in the database file. Freed pages are reused before the file grows, the lowest one first.
+   * @return the id of the allocated page
+   */
+  auto AllocatePage() -> page_id_t;
+
+  /**
+   * Give a page back for reuse by later allocations. Pages that are not allocated are ignored, so freeing a page twice
+   * does not hand it out twice.
+   * @param page_id id of the page
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /** @return true iff the page was allocated before and has been given back since */
+  auto IsFree(page_id_t page_id) -> bool;
+
+  /** @return the number of pages the database file spans, free ones included */
+  auto GetNumPages() -> page_id_t;
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -106,6 +126,13 @@ class DiskManager {
   std::future<void> *flush_log_f_{nullptr};
   // With multiple buffer pool instances, need to protect file access
   std::mutex db_io_latch_;
+  // protects next_page_id_ and free_pages_, allocations do not wait for file I/O
+  std::mutex alloc_latch_;
+  page_id_t next_page_id_{0};
+  // one past the highest page ever allocated, pages between next_page_id_ and it were freed off the end of the file
+  page_id_t allocated_end_{0};
+  // freed pages below next_page_id_, kept ordered so that the front of the file fills up first
+  std::set<page_id_t> free_pages_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.h
+//
+// Identification: src/include/storage/index/art_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "storage/index/index.h"
+
+namespace bustub {
+
+struct ArtNode;
+struct ArtLeaf;
+class ArtIndexCursor;
+
+/**
+ * In-memory index on an adaptive radix tree. Keys are turned into byte strings that sort like the key tuples, and the
+ * tree branches on one byte per level. Inner nodes come in four sizes (4, 16, 48 and 256 children) and grow or shrink
+ * with their fan-out, and single-child paths are compressed into the prefix of the node below them. Nothing goes
+ * through the buffer pool, so the index is lost on restart like every other catalog object.
+ *
+ * Concurrency uses optimistic lock coupling: readers take no latches and validate a per-node version after reading
+ * it, writers lock only the one or two nodes they change. Unlinked nodes are freed once no operation that started
+ * before the unlink is still running.
+ */
+class ArtIndex : public Index {
+ public:
+  explicit ArtIndex(std::unique_ptr<IndexMetadata> &&metadata);
+
+  ~ArtIndex() override;
+
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  auto ScanRange(const IndexKeyRange &range, bool descending) -> std::unique_ptr<IndexScanCursor> override;
+
+ private:
+  friend class ArtIndexCursor;
+
+  /**
+   * Bounds on encoded keys with the semantics of a bound on a leading key column: an inclusive bound also admits every
+   * key that starts with it, an exclusive one rules all of them out.
+   */
+  struct ByteRange {
+    std::optional<std::string> low_;
+    bool low_inclusive_{true};
+    std::optional<std::string> high_;
+    bool high_inclusive_{true};
+  };
+
+  /** Marks an operation as running, so that nodes it may still read are not freed under it. */
+  class EpochGuard {
+   public:
+    explicit EpochGuard(ArtIndex *index);
+    ~EpochGuard();
+    EpochGuard(const EpochGuard &) = delete;
+    auto operator=(const EpochGuard &) -> EpochGuard & = delete;
+
+   private:
+    std::atomic<uint64_t> *slot_;
+  };
+
+  /** @return the byte string of the key columns of `key`, it compares like the key tuples */
+  auto EncodeKey(const Tuple &key) const -> std::string;
+
+  /** Each returns std::nullopt if it ran into a concurrent change and has to start over. */
+  auto TryInsert(const std::string &key, const Tuple &tuple, RID rid) -> std::optional<bool>;
+  auto TryRemove(const std::string &key) -> std::optional<bool>;
+  auto TryLookup(const std::string &key, RID *rid) -> std::optional<bool>;
+  auto TryCollect(ArtNode *node, uint64_t version, std::string *path, const ByteRange &range, bool low_checked,
+                  bool high_checked, bool descending, size_t limit, std::vector<const ArtLeaf *> *leaves, bool *done)
+      -> bool;
+
+  /**
+   * @return the first `limit` leaves whose keys lie in `range`, in key order or in reverse if descending; valid until
+   * the caller's EpochGuard goes away
+   */
+  auto CollectRange(const ByteRange &range, bool descending = false,
+                    size_t limit = std::numeric_limits<size_t>::max()) -> std::vector<const ArtLeaf *>;
+
+  /** Hand over a node that is no longer reachable from the root, it is freed once no reader can hold it. */
+  void Retire(ArtNode *node);
+
+  static constexpr size_t EPOCH_SLOTS = 64;
+  static constexpr size_t RECLAIM_THRESHOLD = 256;
+
+  /** A fixed Node256 with an empty prefix, it is never replaced */
+  ArtNode *root_;
+  std::atomic<uint64_t> global_epoch_{1};
+  /** The epoch each running operation started in, 0 for a free slot */
+  std::array<std::atomic<uint64_t>, EPOCH_SLOTS> active_epochs_{};
+  std::mutex retired_latch_;
+  /** Unlinked nodes with the epoch they were unlinked in */
+  std::vector<std::pair<uint64_t, ArtNode *>> retired_;
+  /** Size of retired_ at which the next reclamation runs, it backs off while a long operation holds nodes back */
+  size_t next_reclaim_at_{RECLAIM_THRESHOLD};
+};
+
+/**
+ * Cursor over a range scan of an ART index. It copies a few entries at a time out of the tree and finds the next ones
+ * by searching again from the last key it copied, so it holds no node between calls and a scan that stops early
+ * never visits the rest of the range.
+ */
+class ArtIndexCursor : public IndexScanCursor {
+ public:
+  /**
+   * @param bytes the range on encoded keys
+   * @param value_range bounds to check on the first key column as well, for bounds that cannot be encoded like it
+   */
+  ArtIndexCursor(ArtIndex *index, ArtIndex::ByteRange bytes, std::optional<IndexKeyRange> value_range,
+                 bool descending);
+
+  auto IsEnd() -> bool override { return pos_ == entries_.size(); }
+
+  auto GetRID() -> RID override { return entries_[pos_].second; }
+
+  auto GetKeyValues() -> std::vector<Value> override;
+
+  void Next() override;
+
+ private:
+  /** Copy out the next entries of the range after the ones already visited, none if the scan is over. */
+  void Fill();
+
+  static constexpr size_t FILL_SIZE = 64;
+
+  ArtIndex *index_;
+  /** The part of the range not copied out yet, its bound on the visited side moves along with the scan */
+  ArtIndex::ByteRange bytes_;
+  std::optional<IndexKeyRange> value_range_;
+  bool descending_;
+  /** Whether bytes_ has no entries left */
+  bool exhausted_{false};
+  std::vector<std::pair<Tuple, RID>> entries_;
+  size_t pos_{0};
+};
+
+}  // namespace bustub
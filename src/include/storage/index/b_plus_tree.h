@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <functional>
 #include <iostream>
 #include <optional>
 #include <queue>
@@ -55,9 +56,24 @@ class Context {
 
   std::deque<page_id_t> sibling_stack_;
 
+  // Pages merged away, they go back to the buffer pool once every latch above is released.
+  std::vector<page_id_t> freed_pages_;
+
   // std::deque<int> indexes_;
 
   auto IsRootPage(page_id_t page_id) -> bool { return page_id == root_page_id_; }
+
+  // The page just latched cannot propagate a change upwards, so every latch above it can be given up.
+  void ReleaseAncestors(bool keep_header = false) {
+    if (!keep_header) {
+      header_page_ = std::nullopt;
+    }
+    write_set_.clear();
+    // keep only the sibling of the page itself, the stack is aligned with write_set_
+    while (sibling_stack_.size() > 1) {
+      sibling_stack_.pop_front();
+    }
+  }
 };
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
@@ -70,8 +86,8 @@ class BPlusTree {
 
  public:
   explicit BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
-                     const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
-                     int internal_max_size = INTERNAL_PAGE_SIZE);
+                     const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_MAX_SIZE,
+                     int internal_max_size = INTERNAL_PAGE_MAX_SIZE);
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
@@ -79,6 +95,13 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   auto Insert(const KeyType &key, const ValueType &value, Transaction *txn = nullptr) -> bool;
 
+  // Build an empty tree bottom-up from `entries`, filling pages to `fill_factor` of their capacity. Duplicate keys keep
+  // the first value like repeated Insert calls do. Returns false if the tree is not empty.
+  auto BulkLoad(std::vector<std::pair<KeyType, ValueType>> entries, double fill_factor = 1.0) -> bool;
+
+  // descend with read latches and return the write-latched leaf for `key`, std::nullopt if the tree is empty
+  auto FindLeafOptimistic(const KeyType &key) -> std::optional<WritePageGuard>;
+
   // InsertKey find leafnode
   auto FindLeafNode(page_id_t page_id, const KeyType &key, const ValueType &value, Transaction *txn, Context *ctx)
       -> bool;
@@ -87,14 +110,17 @@ class BPlusTree {
   auto InsertIntoNode(LeafPage *leafpage, page_id_t leaf_id, const KeyType &key, const ValueType &value,
                       Transaction *txn, Context *ctx) -> bool;
 
-  // divide the leafnode
-  auto DivideLeafNode(LeafPage *leafpage, LeafPage **buddy) -> page_id_t;
+  // divide the leafnode, the new page is kept pinned by buddy_guard
+  auto DivideLeafNode(LeafPage *leafpage, BasicPageGuard *buddy_guard) -> page_id_t;
 
-  // divide the internalnode
-  auto DivideInternalNode(InternalPage *internalpage, InternalPage **buddy) -> page_id_t;
+  // divide the internalnode, the new page is kept pinned by buddy_guard and `separator` receives the key between them
+  auto DivideInternalNode(InternalPage *internalpage, BasicPageGuard *buddy_guard, KeyType *separator) -> page_id_t;
 
   // make newrootnode
-  void MakeNewRootNode(page_id_t pg1_id, page_id_t pg2_id, const KeyType &key1, const KeyType &key2, Context *ctx);
+  void MakeNewRootNode(page_id_t pg1_id, page_id_t pg2_id, const KeyType &separator, Context *ctx);
+
+  // the shortest key that sorts after `left` and not after `right`, used to separate the pages holding them
+  auto Separator(const KeyType &left, const KeyType &right) const -> KeyType;
 
   // update internalnode
   void InsertKeyToInternalNode(const KeyType &key, page_id_t value, Context *ctx);
@@ -102,6 +128,24 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *txn);
 
+  /**
+   * Remove every key that is neither before nor after a range, given by monotone predicates as in BeginAt and
+   * RBeginAt; a null predicate leaves that side open. Instead of one descent per key, the affected leaves are visited
+   * from left to right in a single top-down pass: the keys in range are cut out of a leaf in one shift, subtrees lying
+   * completely inside the range are freed without reading their keys, and each parent is fixed up once after all of
+   * its children are done. The header page stays write-latched throughout, so other operations wait for the pass.
+   * @return the number of removed keys
+   */
+  auto RemoveRange(const std::function<bool(const KeyType &)> &is_before,
+                   const std::function<bool(const KeyType &)> &is_after, Transaction *txn = nullptr) -> size_t;
+
+  /**
+   * Remove many keys in one pass like RemoveRange, but only the given keys; subtrees holding none of them are skipped.
+   * @param keys the keys to remove, in any order and possibly repeated; keys that are not in the tree are ignored
+   * @return the number of removed keys
+   */
+  auto RemoveKeys(std::vector<KeyType> keys, Transaction *txn = nullptr) -> size_t;
+
   // borrow node from left of right page from the same parent
   auto Borrow(WritePageGuard &parent_wg, WritePageGuard &child_wg, int childindex, bool isChildLeaf) -> bool;
 
@@ -111,10 +155,17 @@ class BPlusTree {
   // Return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
 
-  auto CompareAndGetPageId(BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *internal, const KeyType &key)
-      -> page_id_t;
+  /**
+   * Look up many keys in one walk of the tree. The keys are visited in sorted order and the latched path of the last
+   * lookup is reused, so consecutive keys on the same leaf cost one binary search and each leaf is read at most once.
+   * @param keys the keys to look up, in any order and possibly repeated
+   * @param[out] result resized to keys.size(), (*result)[i] receives the values of keys[i]
+   */
+  void GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *result,
+                 Transaction *txn = nullptr);
 
-  void ReplaceParentKey(const KeyType &originKey, const KeyType &replaceKey, page_id_t replacePageId, Context *ctx);
+  auto CompareAndGetPageId(const BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *internal,
+                           const KeyType &key) -> page_id_t;
 
   void RemoveTrack(page_id_t page_id, const KeyType &key, Transaction *txn, Context *ctx);
 
@@ -124,7 +175,13 @@ class BPlusTree {
 
   auto CalculateMinTolerantSize(BPlusTreePage *page) -> int;
 
-  void RemoveKeyFromParent(const KeyType &key, Context *ctx, page_id_t removed_id);
+  // whether inserting `key` below `page` can leave every ancestor of `page` untouched
+  auto IsSafeForInsert(BPlusTreePage *page, const KeyType &key) -> bool;
+
+  // whether removing `key` below `page` can leave every ancestor of `page` untouched
+  auto IsSafeForRemove(BPlusTreePage *page, const KeyType &key) -> bool;
+
+  void RemoveKeyFromParent(Context *ctx, page_id_t removed_id);
 
   // Return the page id of the root node
   auto GetRootPageId() -> page_id_t;
@@ -136,6 +193,22 @@ class BPlusTree {
 
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
 
+  /**
+   * Position an iterator at the first key for which `is_before` is false. `is_before` must be monotone over the key
+   * order (true for a prefix of the keys, false for the rest), which lets range scans seek on a bound that is not a
+   * full key, e.g. on the first column of a composite key.
+   */
+  auto BeginAt(const std::function<bool(const KeyType &)> &is_before) -> INDEXITERATOR_TYPE;
+
+  // Reverse index iterator, starting at the largest key
+  auto RBegin() -> REVERSE_INDEXITERATOR_TYPE;
+
+  /**
+   * Position a reverse iterator at the last key for which `is_after` is false. `is_after` must be false for a prefix
+   * of the keys and true for the rest.
+   */
+  auto RBeginAt(const std::function<bool(const KeyType &)> &is_after) -> REVERSE_INDEXITERATOR_TYPE;
+
   // Print the B+ tree
   void Print(BufferPoolManager *bpm);
 
@@ -162,6 +235,45 @@ class BPlusTree {
   void RemoveFromFile(const std::string &file_name, Transaction *txn = nullptr);
 
  private:
+  /** State of a RemoveRange or RemoveKeys pass. */
+  struct RemoveRangeContext {
+    std::function<bool(const KeyType &)> is_before_;
+    std::function<bool(const KeyType &)> is_after_;
+    // the sorted keys to remove for RemoveKeys, nullptr if every key in range goes
+    const std::vector<KeyType> *keys_{nullptr};
+    // the first of keys_ that may still be ahead, leaves are visited in key order
+    size_t next_key_{0};
+    // the leaf before the next one to visit, which has to be relinked if that one is dropped; after a skipped
+    // subtree it is only latched when needed, as the rightmost leaf of prev_subtree_
+    std::optional<WritePageGuard> prev_leaf_;
+    page_id_t prev_subtree_{INVALID_PAGE_ID};
+    // unlinked pages, deleted from the buffer pool once every latch is released
+    std::vector<page_id_t> freed_;
+    size_t removed_{0};
+  };
+
+  // run a RemoveRange or RemoveKeys pass over the whole tree
+  auto RemoveInRange(RemoveRangeContext *ctx) -> size_t;
+
+  // remove the keys in range from the leaf, in one shift
+  void RemoveFromLeaf(LeafPage *leaf, RemoveRangeContext *ctx);
+
+  // remove the keys in range below the internal page and fix up its children, which may leave it with one child or
+  // none for its parent to handle; `lower` bounds the keys of the page from below, std::nullopt if nothing does
+  void RemoveFromInternal(WritePageGuard &guard, const std::optional<KeyType> &lower, RemoveRangeContext *ctx);
+
+  // unlink an emptied leaf from the leaf chain
+  void DropLeaf(WritePageGuard &guard, RemoveRangeContext *ctx);
+
+  // free a subtree that lies completely inside the range
+  void FreeSubtree(page_id_t page_id, RemoveRangeContext *ctx);
+
+  // the leaf before the next one to visit, nullptr if that one is the first leaf of the tree
+  auto PrevLeaf(RemoveRangeContext *ctx) -> LeafPage *;
+
+  // merge an internal child left with a single child into a sibling, or borrow a child from the sibling
+  void FixSingleChild(InternalPage *parent, page_id_t child_id, RemoveRangeContext *ctx);
+
   /* Debug Routines for FREE!! */
   void ToGraph(page_id_t page_id, const BPlusTreePage *page, std::ofstream &out);
 
@@ -11,14 +11,20 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
+#include <optional>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/bloom_filter.h"
 #include "storage/index/index.h"
+#include "storage/table/table_heap.h"
 
 namespace bustub {
 
@@ -35,6 +41,33 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                Transaction *transaction) override;
+
+  /** Large batches are removed in one pass over the tree that frees emptied leaves as a whole. */
+  void DeleteEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) override;
+
+  auto ScanRange(const IndexKeyRange &range, bool descending) -> std::unique_ptr<IndexScanCursor> override;
+
+  /**
+   * Build a Bloom filter from the keys in the index and keep it up to date from now on. Inserts add to it, and it is
+   * rebuilt twice as large once it holds more keys than it was sized for, which also drops the keys deleted since.
+   */
+  void EnableBloomFilter() override;
+
+  /**
+   * Build the still empty index from all live tuples of `table` with a sort-based bottom-up load instead of one
+   * insert per tuple. An enabled Bloom filter is rebuilt from the loaded keys. The keys are sorted in memory, so only
+   * the first `max_keys` tuples are loaded that way and the tuples after them are inserted one at a time. Of tuples
+   * with equal keys, the first in table order is indexed.
+   * @param table the indexed table
+   * @param table_schema the schema of `table`
+   * @param fill_factor fraction of each page to fill, the rest is left for later inserts
+   * @param max_keys most keys held in memory at once
+   */
+  void BulkLoad(TableHeap *table, const Schema &table_schema, double fill_factor, Transaction *transaction,
+                size_t max_keys = INDEX_BULK_LOAD_MAX_KEYS);
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -42,21 +75,106 @@ class BPlusTreeIndex : public Index {
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
  protected:
-  // comparator for key
+  /** @return whether `key`, plus the RID of a non-unique index, fits into KeyType */
+  auto KeyFits(const Tuple &key) const -> bool;
+
+  /** @return the stored form of `key`, with `rid` appended if the index is non-unique */
+  auto MakeIndexKey(const Tuple &key, RID rid) const -> KeyType;
+
+  /** @return the Bloom filter hash of the key columns of `key` */
+  auto BloomHash(const Tuple &key) const -> hash_t;
+
+  /** @return the Bloom filter hash of the key columns of a stored key, the RID suffix is left out */
+  auto BloomHash(const KeyType &key) const -> hash_t;
+
+  /** @return false if the Bloom filter rules `key` out, true if it may be in the index or there is no filter */
+  auto MayContain(const Tuple &key) -> bool;
+
+  /**
+   * Replace the Bloom filter with one sized for at least `expected_keys` keys, filled from the index.
+   * @param replaced if given, the rebuild is skipped unless this is still the current filter
+   */
+  void RebuildBloomFilter(size_t expected_keys, const BloomFilter *replaced = nullptr);
+
+  // comparator for key, breaking ties on the appended RID if the index is non-unique
   KeyComparator comparator_;
+  // comparator for the key columns only
+  KeyComparator key_comparator_;
   // container
   std::shared_ptr<BPlusTree<KeyType, ValueType, KeyComparator>> container_;
+  // filter for lookups of absent keys, nullptr unless enabled; inserts hold bloom_latch_ shared until the key is in
+  // the tree, so a rebuild under the exclusive latch cannot miss a key
+  std::unique_ptr<BloomFilter> bloom_filter_;
+  std::shared_mutex bloom_latch_;
+  // lets lookups skip bloom_latch_ while there is no filter
+  std::atomic<bool> has_bloom_filter_{false};
 };
 
-/** We only support index table with one integer key for now in BusTub. Hardcode everything here. */
+/**
+ * Scan cursor over a BPlusTreeIndex, a thin wrapper of its forward or reverse index iterator. The iterator is already
+ * positioned at the start of the range; the cursor stops at the first key `is_past` accepts instead of walking to the
+ * last leaf.
+ */
+template <typename KeyType, typename IteratorType>
+class BPlusTreeIndexCursor : public IndexScanCursor {
+ public:
+  BPlusTreeIndexCursor(IteratorType &&iter, std::function<bool(const KeyType &)> is_past, Schema *key_schema)
+      : iter_(std::move(iter)), is_past_(std::move(is_past)), key_schema_(key_schema) {
+    CheckPast();
+  }
+
+  auto IsEnd() -> bool override { return !iter_.has_value() || iter_->IsEnd(); }
+
+  auto GetRID() -> RID override { return (**iter_).second; }
+
+  auto GetKeyValues() -> std::vector<Value> override {
+    std::vector<Value> values;
+    values.reserve(key_schema_->GetColumnCount());
+    for (uint32_t i = 0; i < key_schema_->GetColumnCount(); i++) {
+      values.push_back((**iter_).first.ToValue(key_schema_, i));
+    }
+    return values;
+  }
+
+  void Next() override {
+    ++*iter_;
+    CheckPast();
+  }
+
+ private:
+  // the iterator goes as soon as it is past the range, together with the entries it copied out of its leaf
+  void CheckPast() {
+    if (is_past_ && !iter_->IsEnd() && is_past_((**iter_).first)) {
+      iter_.reset();
+    }
+  }
+
+  std::optional<IteratorType> iter_;
+  std::function<bool(const KeyType &)> is_past_;
+  Schema *key_schema_;
+};
+
+/** Indexes on one or two integer columns compare their keys as raw integers. */
 
 constexpr static const auto TWO_INTEGER_SIZE = 8;
 using IntegerKeyType = GenericKey<TWO_INTEGER_SIZE>;
 using IntegerValueType = RID;
-using IntegerComparatorType = GenericComparator<TWO_INTEGER_SIZE>;
+using IntegerComparatorType = IntegerComparator<TWO_INTEGER_SIZE, int32_t>;
 using BPlusTreeIndexForTwoIntegerColumn = BPlusTreeIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using BPlusTreeIndexIteratorForTwoIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using IntegerHashFunctionType = HashFunction<IntegerKeyType>;
 
+/** Indexes on a single BIGINT column. */
+using BigintComparatorType = IntegerComparator<TWO_INTEGER_SIZE, int64_t>;
+
+/** Non-unique indexes append the RID to the key, which takes integer keys to the next size class. */
+constexpr static const auto INTEGER_RID_KEY_SIZE = 16;
+
+/**
+ * Every other key is compared column by column through Value, in the smallest GenericKey that holds it. The widest
+ * class fits a VARCHAR(64) key (12 inline bytes, a 4-byte length, the string and its terminator) plus the RID suffix.
+ */
+constexpr static const size_t MAX_INDEX_KEY_SIZE = 96;
+
 }  // namespace bustub
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/storage/index/bloom_filter.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "common/util/hash_util.h"
+
+namespace bustub {
+
+/**
+ * BloomFilter is a blocked Bloom filter over key hashes. All probe bits of a key fall into one cache-line sized block,
+ * so a lookup costs a single cache miss. Bits are only ever set, a key that was removed from the indexed structure
+ * keeps answering "maybe" until the filter is rebuilt. Insert and MayContain may run concurrently.
+ */
+class BloomFilter {
+ public:
+  /**
+   * Create an empty filter.
+   * @param expected_keys number of keys the filter is sized for, it gets about BITS_PER_KEY bits for each
+   */
+  explicit BloomFilter(size_t expected_keys);
+
+  /** Add the key with hash `hash`. */
+  void Insert(hash_t hash);
+
+  /** @return false if the key with hash `hash` was never inserted, true if it may have been */
+  auto MayContain(hash_t hash) const -> bool;
+
+  /** @return whether more keys went in than the filter is sized for, its false positive rate then climbs quickly */
+  auto IsOverloaded() const -> bool { return insert_count_.load(std::memory_order_relaxed) > expected_keys_; }
+
+  /** @return the number of keys the filter is sized for */
+  auto GetExpectedKeys() const -> size_t { return expected_keys_; }
+
+  static constexpr size_t BITS_PER_KEY = 10;
+  static constexpr size_t MIN_EXPECTED_KEYS = 1024;
+
+ private:
+  static constexpr size_t BLOCK_WORDS = 8;
+  static constexpr uint32_t NUM_PROBES = 6;
+
+  /** @return the first word of the block `hash` maps to */
+  auto BlockOf(hash_t hash) const -> size_t;
+
+  size_t expected_keys_;
+  size_t num_blocks_;
+  std::vector<std::atomic<uint64_t>> words_;
+  std::atomic<size_t> insert_count_{0};
+};
+
+}  // namespace bustub
@@ -15,6 +15,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/disk/hash/disk_extendible_hash_table.h"
@@ -25,6 +26,31 @@ namespace bustub {
 
 #define HASH_TABLE_INDEX_TYPE ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>
 
+/** Cursor over the RIDs found by a single hash probe. */
+class HashIndexCursor : public IndexScanCursor {
+ public:
+  HashIndexCursor(std::vector<RID> rids, std::vector<Value> key_values)
+      : rids_(std::move(rids)), key_values_(std::move(key_values)) {}
+
+  auto IsEnd() -> bool override { return pos_ == rids_.size(); }
+
+  auto GetRID() -> RID override { return rids_[pos_]; }
+
+  /** Every entry of a point lookup has the probed key. */
+  auto GetKeyValues() -> std::vector<Value> override { return key_values_; }
+
+  void Next() override { pos_++; }
+
+ private:
+  std::vector<RID> rids_;
+  std::vector<Value> key_values_;
+  size_t pos_{0};
+};
+
+/**
+ * Index backed by a disk extendible hash table. It only answers equality lookups on the whole key, in exchange a
+ * probe reads the directory and a single bucket page instead of a root-to-leaf path.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class ExtendibleHashTableIndex : public Index {
  public:
@@ -39,7 +65,16 @@ class ExtendibleHashTableIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /**
+   * Only point ranges on a single-column key can be answered by a hash probe.
+   * @return a cursor over the entries equal to range.low_, in no particular order
+   */
+  auto ScanRange(const IndexKeyRange &range, bool descending) -> std::unique_ptr<IndexScanCursor> override;
+
  protected:
+  /** @return whether `key` fits into KeyType, longer strings than the column declares would overflow it */
+  auto KeyFits(const Tuple &key) const -> bool { return key.GetLength() <= sizeof(KeyType); }
+
   // comparator for key
   KeyComparator comparator_;
   // container
@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstring>
+#include <type_traits>
 
+#include "common/macros.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -35,6 +38,26 @@ class GenericKey {
     memcpy(data_, tuple.GetData(), tuple.GetLength());
   }
 
+  /**
+   * Store `rid` in the last 8 bytes of the key. Non-unique indexes keep these bytes free of key data and compare them
+   * after the key columns, so equal keys become distinct entries ordered by RID.
+   */
+  inline void SetRid(const RID &rid) {
+    if constexpr (KeySize >= sizeof(int64_t)) {
+      int64_t value = rid.Get();
+      memcpy(data_ + RID_OFFSET, &value, sizeof(int64_t));
+    }
+  }
+
+  /** @return the RID stored by SetRid() */
+  inline auto GetRid() const -> RID {
+    int64_t value = 0;
+    if constexpr (KeySize >= sizeof(int64_t)) {
+      memcpy(&value, data_ + RID_OFFSET, sizeof(int64_t));
+    }
+    return RID(value);
+  }
+
   // NOTE: for test purpose only
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
@@ -66,10 +89,24 @@ class GenericKey {
     return os;
   }
 
+  /** Offset of the RID appended to the keys of non-unique indexes */
+  static constexpr size_t RID_OFFSET = KeySize >= sizeof(int64_t) ? KeySize - sizeof(int64_t) : 0;
+
   // actual location of data, extends past the end.
   char data_[KeySize];
 };
 
+/** Compare the RIDs appended by GenericKey::SetRid(). */
+template <size_t KeySize>
+inline auto CompareKeyRids(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) -> int {
+  int64_t lhs_rid = lhs.GetRid().Get();
+  int64_t rhs_rid = rhs.GetRid().Get();
+  if (lhs_rid != rhs_rid) {
+    return lhs_rid < rhs_rid ? -1 : 1;
+  }
+  return 0;
+}
+
 /**
  * Function object returns true if lhs < rhs, used for trees
  */
@@ -91,16 +128,91 @@ class GenericComparator {
       }
     }
     // equals
-    return 0;
+    return rid_suffix_ ? CompareKeyRids(lhs, rhs) : 0;
+  }
+
+  /**
+   * Separators may drop trailing bytes of a key (see BPlusTree), which must not cut into what locates the data of
+   * variable-length columns. @return how many leading bytes of `key` a shortened key keeps at least
+   */
+  inline auto TruncationFloor(const GenericKey<KeySize> &key) const -> size_t {
+    size_t floor = 0;
+    for (const auto &col : key_schema_->GetColumns()) {
+      if (!col.IsInlined()) {
+        int32_t offset;
+        memcpy(&offset, key.data_ + col.GetOffset(), sizeof(int32_t));
+        floor = std::max({floor, col.GetOffset() + sizeof(int32_t), offset + sizeof(uint32_t)});
+      }
+    }
+    return std::min(floor, KeySize);
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, rid_suffix_{other.rid_suffix_} {}
 
-  // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  // constructor, `rid_suffix` breaks ties between equal keys on the RID stored by GenericKey::SetRid()
+  explicit GenericComparator(Schema *key_schema, bool rid_suffix = false)
+      : key_schema_(key_schema), rid_suffix_(rid_suffix) {}
 
  private:
   Schema *key_schema_;
+  bool rid_suffix_;
+};
+
+/**
+ * Comparator for keys made only of integer columns of one width (INTEGER for int32_t, BIGINT for int64_t). Such keys
+ * are serialized as packed native integers, so they are compared straight from the key bytes without building a
+ * Value per column. NULL is stored as the smallest integer and therefore sorts first.
+ */
+template <size_t KeySize, typename IntType>
+class IntegerComparator {
+  static_assert(std::is_same_v<IntType, int32_t> || std::is_same_v<IntType, int64_t>, "unsupported integer key type");
+
+ public:
+  inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    for (uint32_t i = 0; i < column_count_; i++) {
+      IntType lhs_value;
+      IntType rhs_value;
+      memcpy(&lhs_value, lhs.data_ + i * sizeof(IntType), sizeof(IntType));
+      memcpy(&rhs_value, rhs.data_ + i * sizeof(IntType), sizeof(IntType));
+      if (lhs_value != rhs_value) {
+        return lhs_value < rhs_value ? -1 : 1;
+      }
+    }
+    // equals
+    return rid_suffix_ ? CompareKeyRids(lhs, rhs) : 0;
+  }
+
+  /** Any prefix of an integer key is a valid key, see GenericComparator::TruncationFloor() */
+  inline auto TruncationFloor(const GenericKey<KeySize> &key) const -> size_t { return 0; }
+
+  // `rid_suffix` breaks ties between equal keys on the RID stored by GenericKey::SetRid()
+  explicit IntegerComparator(Schema *key_schema, bool rid_suffix = false)
+      : column_count_(key_schema->GetColumnCount()), rid_suffix_(rid_suffix) {
+    BUSTUB_ASSERT(Supports(*key_schema), "key schema does not match the integer comparator");
+    BUSTUB_ASSERT(!rid_suffix || column_count_ * sizeof(IntType) <= GenericKey<KeySize>::RID_OFFSET,
+                  "no room for the RID after the key");
+  }
+
+  /** @return whether keys of `key_schema` can be compared by this comparator */
+  static auto Supports(const Schema &key_schema) -> bool {
+    const TypeId type = std::is_same_v<IntType, int32_t> ? TypeId::INTEGER : TypeId::BIGINT;
+    uint32_t column_count = key_schema.GetColumnCount();
+    if (column_count == 0 || column_count * sizeof(IntType) > KeySize) {
+      return false;
+    }
+    for (uint32_t i = 0; i < column_count; i++) {
+      const auto &col = key_schema.GetColumn(i);
+      if (col.GetType() != type || col.GetOffset() != i * sizeof(IntType)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  uint32_t column_count_;
+  bool rid_suffix_;
 };
 
 }  // namespace bustub
@@ -12,12 +12,16 @@
 
 #pragma once
 
+#include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/exception.h"
+#include "execution/expressions/abstract_expression.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -25,6 +29,9 @@ namespace bustub {
 
 class Transaction;
 
+/** Stands in the key attributes for a key column that is computed by an expression */
+static constexpr uint32_t EXPRESSION_KEY_ATTR = std::numeric_limits<uint32_t>::max();
+
 /**
  * class IndexMetadata - Holds metadata of an index object.
  *
@@ -43,13 +50,38 @@ class IndexMetadata {
    * @param table_name The name of the table on which the index is created
    * @param tuple_schema The schema of the indexed key
    * @param key_attrs The mapping from indexed columns to base table columns
+   * @param is_unique Whether a key may be stored at most once
    */
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, bool is_unique = true)
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        is_unique_(is_unique) {
     key_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, key_attrs_));
   }
 
+  /**
+   * Construct the metadata of an expression or partial index.
+   * @param index_name The name of the index
+   * @param table_name The name of the table on which the index is created
+   * @param key_schema The schema of the indexed key
+   * @param key_attrs The base table column of each key column, EXPRESSION_KEY_ATTR for computed ones
+   * @param is_unique Whether a key may be stored at most once
+   * @param key_exprs One expression over the table tuple per key column, or empty if key_attrs are all columns
+   * @param predicate Only tuples satisfying it are indexed, nullptr to index every tuple
+   */
+  IndexMetadata(std::string index_name, std::string table_name, const Schema &key_schema,
+                std::vector<uint32_t> key_attrs, bool is_unique, std::vector<AbstractExpressionRef> key_exprs,
+                AbstractExpressionRef predicate)
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        key_schema_(std::make_shared<Schema>(key_schema)),
+        is_unique_(is_unique),
+        key_exprs_(std::move(key_exprs)),
+        predicate_(std::move(predicate)) {}
+
   ~IndexMetadata() = default;
 
   /** @return The name of the index */
@@ -72,6 +104,37 @@ class IndexMetadata {
   /** @return The mapping relation between indexed columns and base table columns */
   inline auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return key_attrs_; }
 
+  /** @return Whether a key may be stored at most once */
+  inline auto IsUnique() const -> bool { return is_unique_; }
+
+  /** @return The expression computing each key column, empty if every key column is a table column */
+  inline auto GetKeyExpressions() const -> const std::vector<AbstractExpressionRef> & { return key_exprs_; }
+
+  /** @return The predicate a tuple has to satisfy to be indexed, nullptr if every tuple is */
+  inline auto GetPredicate() const -> const AbstractExpressionRef & { return predicate_; }
+
+  /** @return Whether `tuple` of the indexed table has an entry in the index */
+  auto IsIndexed(const Tuple &tuple, const Schema &table_schema) const -> bool {
+    if (predicate_ == nullptr) {
+      return true;
+    }
+    auto value = predicate_->Evaluate(&tuple, table_schema);
+    return !value.IsNull() && value.GetAs<bool>();
+  }
+
+  /** @return The key under which `tuple` of the indexed table is stored */
+  auto KeyFromTuple(const Tuple &tuple, const Schema &table_schema) const -> Tuple {
+    if (key_exprs_.empty()) {
+      return tuple.KeyFromTuple(table_schema, *key_schema_, key_attrs_);
+    }
+    std::vector<Value> values;
+    values.reserve(key_exprs_.size());
+    for (const auto &expr : key_exprs_) {
+      values.push_back(expr->Evaluate(&tuple, table_schema));
+    }
+    return {values, key_schema_.get()};
+  }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -79,6 +142,7 @@ class IndexMetadata {
     os << "IndexMetadata["
        << "Name = " << name_ << ", "
        << "Type = B+Tree, "
+       << "Unique = " << is_unique_ << ", "
        << "Table name = " << table_name_ << "] :: ";
     os << key_schema_->ToString();
 
@@ -94,6 +158,59 @@ class IndexMetadata {
   const std::vector<uint32_t> key_attrs_;
   /** The schema of the indexed key */
   std::shared_ptr<Schema> key_schema_;
+  /** Whether a key may be stored at most once */
+  bool is_unique_;
+  /** The expression computing each key column, empty if every key column is a table column */
+  std::vector<AbstractExpressionRef> key_exprs_;
+  /** Only tuples satisfying the predicate are indexed, nullptr if every tuple is */
+  AbstractExpressionRef predicate_;
+};
+
+/**
+ * Bounds on the leading key column of an index for a range scan. A missing bound leaves that side of the range open,
+ * so a default constructed range covers the whole index.
+ */
+struct IndexKeyRange {
+  /** Lower bound, compared against the first key column */
+  std::optional<Value> low_;
+  /** Whether keys equal to low_ are part of the range */
+  bool low_inclusive_{true};
+  /** Upper bound, compared against the first key column */
+  std::optional<Value> high_;
+  /** Whether keys equal to high_ are part of the range */
+  bool high_inclusive_{true};
+
+  /** @return whether both sides of the range are open */
+  auto IsFull() const -> bool { return !low_.has_value() && !high_.has_value(); }
+
+  /** @return a string representation for plan printing */
+  auto ToString() const -> std::string {
+    std::string result = low_.has_value() ? (low_inclusive_ ? "[" : "(") + low_->ToString() : "(-inf";
+    result += ", ";
+    result += high_.has_value() ? high_->ToString() + (high_inclusive_ ? "]" : ")") : "+inf)";
+    return result;
+  }
+};
+
+/**
+ * IndexScanCursor walks the entries of an ordered index in key order. It hides the key type of the index so that
+ * executors can scan any index without knowing how it was instantiated.
+ */
+class IndexScanCursor {
+ public:
+  virtual ~IndexScanCursor() = default;
+
+  /** @return whether the cursor has moved past the last entry */
+  virtual auto IsEnd() -> bool = 0;
+
+  /** @return the RID of the entry the cursor is positioned at */
+  virtual auto GetRID() -> RID = 0;
+
+  /** @return the key column values of the entry the cursor is positioned at, in key schema order */
+  virtual auto GetKeyValues() -> std::vector<Value> = 0;
+
+  /** Move the cursor to the next entry. */
+  virtual void Next() = 0;
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -139,6 +256,27 @@ class Index {
   /** @return The index key attributes */
   auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetKeyAttrs(); }
 
+  /** @return Whether a key may be stored at most once */
+  auto IsUnique() const -> bool { return metadata_->IsUnique(); }
+
+  /** @return The expression computing each key column, empty if every key column is a table column */
+  auto GetKeyExpressions() const -> const std::vector<AbstractExpressionRef> & {
+    return metadata_->GetKeyExpressions();
+  }
+
+  /** @return The predicate a tuple has to satisfy to be indexed, nullptr if every tuple is */
+  auto GetPredicate() const -> const AbstractExpressionRef & { return metadata_->GetPredicate(); }
+
+  /** @return Whether `tuple` of the indexed table has an entry in the index */
+  auto IsIndexed(const Tuple &tuple, const Schema &table_schema) const -> bool {
+    return metadata_->IsIndexed(tuple, table_schema);
+  }
+
+  /** @return The key under which `tuple` of the indexed table is stored */
+  auto KeyFromTuple(const Tuple &tuple, const Schema &table_schema) const -> Tuple {
+    return metadata_->KeyFromTuple(tuple, table_schema);
+  }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -176,6 +314,54 @@ class Index {
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  /**
+   * Search the index for many keys at once. Indexes that can share work between lookups override this, the default
+   * probes one key at a time.
+   * @param keys The index keys
+   * @param result Resized to keys.size(), (*result)[i] is populated with the RIDs of keys[i]
+   * @param transaction The transaction context
+   */
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                        Transaction *transaction) {
+    result->assign(keys.size(), {});
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*result)[i], transaction);
+    }
+  }
+
+  /**
+   * Delete many entries at once. Indexes that can remove a batch in one pass override this, the default deletes one
+   * entry at a time.
+   * @param entries The index keys with the RIDs of their entries
+   * @param transaction The transaction context
+   */
+  virtual void DeleteEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+    for (const auto &[key, rid] : entries) {
+      DeleteEntry(key, rid, transaction);
+    }
+  }
+
+  /**
+   * Keep a Bloom filter over the keys of the index so that lookups of absent keys can return without reading index
+   * pages. Only some indexes support this.
+   */
+  virtual void EnableBloomFilter() { throw NotImplementedException("index does not support bloom filters"); }
+
+  ///////////////////////////////////////////////////////////////////
+  // Ordered Scan
+  ///////////////////////////////////////////////////////////////////
+
+  /**
+   * Open a cursor over the entries whose first key column lies in `range`, in key order. Only ordered indexes support
+   * this.
+   * @param range bounds on the first key column, the default range scans the whole index
+   * @param descending whether to walk from the largest key down
+   * @return a cursor positioned at the first entry in the range, or at the last one if descending
+   */
+  virtual auto ScanRange(const IndexKeyRange &range, bool descending) -> std::unique_ptr<IndexScanCursor> {
+    throw NotImplementedException("index does not support ordered scans");
+  }
+
  private:
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
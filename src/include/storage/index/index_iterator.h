@@ -13,6 +13,9 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <utility>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
 #include "storage/page/b_plus_tree_header_page.h"
@@ -23,14 +26,29 @@
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
+#define REVERSE_INDEXITERATOR_TYPE ReverseIndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * Walks the leaves from the smallest key up, one leaf at a time. The entries from the current position to the end of
+ * the leaf are copied out and every latch is released before they are handed out, so a slow consumer does not hold
+ * up writers. Once the copy is used up the iterator descends again from the root to the first key after the last one
+ * it returned; the leaf it came from may have been split, merged or freed in between.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
  public:
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
   using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
 
-  IndexIterator(BufferPoolManager *bpm, ReadPageGuard &&guard, ReadPageGuard &&head, int index = -1);
+  /** Creates the end iterator. */
+  IndexIterator() = default;
+  /**
+   * Start at entry `index` of the leaf, both the leaf and the header page are read-latched and released here.
+   * @param comparator the comparator of the tree, it has to outlive the iterator
+   */
+  IndexIterator(BufferPoolManager *bpm, const KeyComparator *comparator, ReadPageGuard &&head, ReadPageGuard &&guard,
+                int index);
+  IndexIterator(IndexIterator &&that) = default;
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -44,12 +62,65 @@ class IndexIterator {
   auto operator!=(const IndexIterator &itr) const -> bool;
 
  private:
-  // add your own private member variables here
-  BufferPoolManager *bpm_;
-  ReadPageGuard guard_;
-  ReadPageGuard head_;
-  int index_;
-  page_id_t page_id_;
+  /** Copy the entries of the leaf from `index` on, moving on to the next leaf while there are none, then unlatch. */
+  void LoadBatch(ReadPageGuard head, ReadPageGuard guard, int index);
+
+  /** Descend from the root to the first key after the last entry of the batch and load from there. */
+  void Reseek();
+
+  BufferPoolManager *bpm_{nullptr};
+  const KeyComparator *comparator_{nullptr};
+  page_id_t header_page_id_{INVALID_PAGE_ID};
+  /** the rest of the leaf the iterator is on, batch_[pos_] is the current entry */
+  std::vector<MappingType> batch_;
+  size_t pos_{0};
+  /** whether the batch ends with the last leaf of the tree */
+  bool last_leaf_{true};
+};
+
+/**
+ * Walks the leaves from the largest key down. Like IndexIterator it copies out the entries of one leaf, from the
+ * current position down to the first key, and holds no latch while they are handed out. Leaves are only linked
+ * forward, so once the copy is used up the iterator descends again from the root to the last key before the smallest
+ * one it returned.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class ReverseIndexIterator {
+ public:
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
+
+  /** Creates the end iterator. */
+  ReverseIndexIterator() = default;
+  /**
+   * Start at the last of the first `count` entries of the leaf, both the leaf and the header page are read-latched
+   * and released here.
+   * @param comparator the comparator of the tree, it has to outlive the iterator
+   * @param leftmost whether the leaf is the first leaf of the tree
+   */
+  ReverseIndexIterator(BufferPoolManager *bpm, const KeyComparator *comparator, ReadPageGuard &&head,
+                       ReadPageGuard &&guard, int count, bool leftmost);
+  ReverseIndexIterator(ReverseIndexIterator &&that) = default;
+  ~ReverseIndexIterator();  // NOLINT
+
+  auto IsEnd() -> bool { return pos_ == batch_.size(); }
+
+  auto operator*() -> const MappingType &;
+
+  auto operator++() -> ReverseIndexIterator &;
+
+ private:
+  /** Descend from the root to the last key before `key`, and copy out the leaf from that key down. */
+  void Reseek(KeyType key);
+
+  BufferPoolManager *bpm_{nullptr};
+  const KeyComparator *comparator_{nullptr};
+  page_id_t header_page_id_{INVALID_PAGE_ID};
+  /** the leaf the iterator is on from the current entry down, batch_[pos_] is the current entry */
+  std::vector<MappingType> batch_;
+  size_t pos_{0};
+  /** whether the batch ends with the first leaf of the tree */
+  bool first_leaf_{true};
 };
 
 }  // namespace bustub
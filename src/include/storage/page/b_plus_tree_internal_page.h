@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
 #include "storage/page/b_plus_tree_page.h"
@@ -18,20 +19,28 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 12
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_HEADER_SIZE 16
+// children that fit into an internal page even if their keys share no bytes
+#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(KeyType) + sizeof(page_id_t)))
+// default max size of an internal page: a split leaves two halves that still fit a key at the full width
+#define INTERNAL_PAGE_MAX_SIZE (2 * INTERNAL_PAGE_SIZE - 2)
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
  * K(i) <= K < K(i+1).
  * NOTE: since the number of keys does not equal to number of child pointers,
  * the first key always remains invalid. That is to say, any search/lookup
- * should ignore the first key.
+ * should ignore the first key. It is not stored, KeyAt(0) is an all-zero key.
+ *
+ * The keys are separators, which need not be keys of the tree: any K(i) works
+ * that sorts after every key below PAGE_ID(i-1) and not after any key below
+ * PAGE_ID(i). The tree picks short ones, and like in leaf pages the keys are
+ * stored without their common prefix and trailing zero bytes (see KeyLayout).
  *
  * Internal page format (keys are stored in increasing order):
- *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
- *  --------------------------------------------------------------------------
+ *  -----------------------------------------------------------------------------------
+ * | HEADER | PREFIX | PAGE_ID(0) | KEY(1)+PAGE_ID(1) | ... | KEY(n)+PAGE_ID(n) |
+ *  -----------------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -45,7 +54,7 @@ class BPlusTreeInternalPage : public BPlusTreePage {
    * the creation of a new page to make a valid BPlusTreeInternalPage
    * @param max_size Maximal size of the page
    */
-  void Init(int max_size = INTERNAL_PAGE_SIZE);
+  void Init(int max_size = INTERNAL_PAGE_MAX_SIZE);
 
   /**
    * @param index The index of the key to get. Index must be non-zero.
@@ -75,29 +84,42 @@ class BPlusTreeInternalPage : public BPlusTreePage {
 
   void SetValueAt(int index, const ValueType &value);
 
+  /**
+   * Branch-free binary search for the child covering `key`: the last index whose key is <= `key`, the invalid key at
+   * index 0 counting as minus infinity. The loop always runs log2(size) rounds and picks the next half with a
+   * conditional move, so a descent does not stall on mispredicted comparisons.
+   * @return index of the child to follow, in [0, size)
+   */
+  auto LookupChildIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  // whether the page has room for one more child with `key`
+  auto HasRoomFor(const KeyType &key) const -> bool;
+  // whether the page has room for one more child whatever its key, i.e. even at the full key width
+  auto HasRoomForAnyKey() const -> bool;
+  // whether the key at `index` can be replaced with `key`
+  auto HasRoomForKeyAt(int index, const KeyType &key) const -> bool;
+  // whether the page has room for the children of `right` as well, `separator` going in front of the first one
+  auto HasRoomFor(const BPlusTreeInternalPage *right, const KeyType &separator) const -> bool;
+
   // search the target value
   auto FindValue(const KeyType &key, const KeyComparator &comparator) const -> std::pair<ValueType, int>;
-  // insert value into internal page in a given position
+  // insert value into internal page in a given position, which is only 0 for the first child of an empty page
   void InsertValueAt(const KeyType &key, const ValueType &value, int pos);
-  // move half of the data to newpage
-  void MoveHalfTo(BPlusTreeInternalPage *newpage);
-  // move all of the data to newpage
-  void MoveAllTo(BPlusTreeInternalPage *newpage);
-  // move the backdata to the front of the newpage
-  void MoveBackToFront(BPlusTreeInternalPage *newpage);
-  // move the frontdata to the back of the newpage
-  void MoveFrontToBack(BPlusTreeInternalPage *newpage);
-  // set header value
-  void SetInitVal(int max_size, const ValueType &left, const KeyType &mid, const ValueType &right);
+  // move the upper half of the children to the empty newpage, return the key separating the two pages
+  auto MoveHalfTo(BPlusTreeInternalPage *newpage) -> KeyType;
+  // move all children to the end of newpage, the page on the left, whose children are separated from ours by
+  // `separator`
+  void MoveAllTo(BPlusTreeInternalPage *newpage, const KeyType &separator);
+  // move the last child to the front of newpage, the page on the right, rotating the key `separator` that tells the
+  // two pages apart
+  void MoveBackToFront(BPlusTreeInternalPage *newpage, KeyType *separator);
+  // move the first child to the back of newpage, the page on the left, rotating the key `separator` that tells the
+  // two pages apart
+  void MoveFrontToBack(BPlusTreeInternalPage *newpage, KeyType *separator);
   // remove value from current page;
   void RemoveByIndex(int remove_index);
 
-  void StoleFromLeftSibling(BPlusTreeInternalPage<KeyType, ValueType, KeyComparator> *internal);
-
-  void StoleFromRightSibling(BPlusTreeInternalPage<KeyType, ValueType, KeyComparator> *internal);
-
-  auto RemovePage(const KeyType &key, page_id_t removed_page, KeyComparator cmp) -> bool;
-  void CombieWithRightSibling(BPlusTreeInternalPage<KeyType, ValueType, KeyComparator> *right_sibling);
+  auto RemovePage(page_id_t removed_page) -> bool;
 
   /**
    * @brief For test only, return a string representing all keys in
@@ -126,7 +148,17 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   }
 
  private:
-  // Flexible array member for page data.
-  MappingType array_[0];
+  // the layout the page stores its keys in
+  auto Layout() const -> KeyLayout<KeyType>;
+  // a layout for `count` children that fits into the page: the keys of the page but the one at `skip`, plus `key`
+  auto LayoutFor(const KeyType &key, int count, int skip = -1) const -> std::optional<KeyLayout<KeyType>>;
+  // store the keys in `layout` instead, if they are not already
+  void Relayout(const KeyLayout<KeyType> &layout);
+  auto EntryAt(int index) const -> const char *;
+  auto EntryAt(int index) -> char *;
+
+  // Flexible array member for page data, the prefix followed by the entries. The first entry has room for a key as
+  // well, which is left unused.
+  char data_[0];
 };
 }  // namespace bustub
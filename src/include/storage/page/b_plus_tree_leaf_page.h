@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -21,26 +22,33 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 16
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_HEADER_SIZE 20
+// entries that fit into a leaf page even if their keys share no bytes
+#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (sizeof(KeyType) + sizeof(ValueType)))
+// default max size of a leaf page: a split leaves two halves that fit even at the full key width
+#define LEAF_PAGE_MAX_SIZE (2 * LEAF_PAGE_SIZE - 2)
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
  *
- * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
+ * Leaf page format (keys are stored in order, each one without the prefix that
+ * all of them share and without its trailing zero bytes, see KeyLayout):
+ *  ----------------------------------------------------------------------------------
+ * | HEADER | PREFIX | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ *  ----------------------------------------------------------------------------------
  *
- *  Header format (size in byte, 16 bytes in total):
+ *  Header format (size in byte, 20 bytes in total):
  *  ---------------------------------------------------------------------
- * | PageType (4) | CurrentSize (4) | MaxSize (4) |
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | PrefixSize (2) |
  *  ---------------------------------------------------------------------
  *  -----------------------------------------------
- * |  NextPageId (4)
+ * | KeyWidth (2) | NextPageId (4)
  *  -----------------------------------------------
+ *
+ * Whether an entry fits depends on its key, so besides staying below the max
+ * size, inserts have to check HasRoomFor().
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
@@ -54,17 +62,22 @@ class BPlusTreeLeafPage : public BPlusTreePage {
    * method to set default values
    * @param max_size Max size of the leaf node
    */
-  void Init(int max_size = LEAF_PAGE_SIZE);
+  void Init(int max_size = LEAF_PAGE_MAX_SIZE);
 
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
   auto KeyAt(int index) const -> KeyType;
   auto ValueAt(int index) const -> ValueType;
-  auto KeyValueAt(int index) const -> const MappingType &;
+  auto KeyValueAt(int index) const -> MappingType;
   void SetKeyAt(int index, const KeyType &key);
   void SetValueAt(int index, const ValueType &value);
 
+  // whether the page has room for one more entry with `key`
+  auto HasRoomFor(const KeyType &key) const -> bool;
+  // whether the page has room for every entry of `other` as well
+  auto HasRoomFor(const BPlusTreeLeafPage *other) const -> bool;
+
   // use binarysearch find the target value's index
   auto FindValueIndex(const KeyType &key, const KeyComparator &comparator) const -> std::pair<int, bool>;
   // search the target value
@@ -115,8 +128,17 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   }
 
  private:
+  // the layout the page stores its keys in
+  auto Layout() const -> KeyLayout<KeyType>;
+  // a layout for `count` entries that fits into the page: the keys of the page but the one at `skip`, plus `key`
+  auto LayoutFor(const KeyType &key, int count, int skip = -1) const -> std::optional<KeyLayout<KeyType>>;
+  // store the entries in `layout` instead, if they are not already
+  void Relayout(const KeyLayout<KeyType> &layout);
+  auto EntryAt(int index) const -> const char *;
+  auto EntryAt(int index) -> char *;
+
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[0];
+  // Flexible array member for page data, the prefix followed by the entries.
+  char data_[0];
 };
 }  // namespace bustub
@@ -10,10 +10,13 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <climits>
 #include <cstdlib>
+#include <cstring>
 #include <string>
+#include <type_traits>
 
 #include "buffer/buffer_pool_manager.h"
 #include "storage/index/generic_key.h"
@@ -33,10 +36,13 @@ enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
  * It actually serves as a header part for each B+ tree page and
  * contains information shared by both leaf page and internal page.
  *
- * Header format (size in byte, 12 bytes in total):
+ * Header format (size in byte, 16 bytes in total):
  * ----------------------------------------------------------------------------
- * | PageType (4) | CurrentSize (4) | MaxSize (4) |
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | PrefixSize (2) | KeyWidth (2) |
  * ----------------------------------------------------------------------------
+ *
+ * Keys are stored compressed, see KeyLayout: the PrefixSize bytes that every key of the page starts with are kept
+ * once in front of the entries, and each entry keeps the next KeyWidth bytes of its key.
  */
 class BPlusTreePage {
  public:
@@ -56,11 +62,85 @@ class BPlusTreePage {
   void SetMaxSize(int max_size);
   auto GetMinSize() const -> int;
 
+  // bytes that every key of the page starts with, stored once in front of the entries
+  auto GetPrefixSize() const -> int;
+  // bytes of its key that each entry stores after the prefix
+  auto GetKeyWidth() const -> int;
+  void SetKeyLayout(int prefix_size, int key_width);
+
  private:
   // member variable, attributes that both internal and leaf page share
   IndexPageType page_type_ __attribute__((__unused__));
   int size_ __attribute__((__unused__));
   int max_size_ __attribute__((__unused__));
+  uint16_t prefix_size_ __attribute__((__unused__));
+  uint16_t key_width_ __attribute__((__unused__));
+};
+
+/**
+ * The byte layout shared by the keys of a page. Every key starts with the same PrefixSize() bytes and is zero past
+ * PrefixSize() + KeyWidth(), so an entry only has to store the KeyWidth() bytes in between. Keys of a leaf tend to
+ * share their leading columns, and separators in internal pages are cut short when a leaf splits, so pages hold more
+ * entries than they would at the full key width.
+ *
+ * A layout is built by adding keys one at a time; adding a key can only shorten the prefix and widen the entries.
+ */
+template <typename KeyType>
+class KeyLayout {
+  static_assert(std::is_trivially_copyable_v<KeyType>, "keys are stored as raw bytes");
+
+ public:
+  KeyLayout() = default;
+
+  // the layout of a page that stores `prefix_size` bytes at `prefix` and `key_width` bytes per entry
+  KeyLayout(const char *prefix, size_t prefix_size, size_t key_width)
+      : empty_(false), prefix_size_(prefix_size), end_(prefix_size + key_width) {
+    memcpy(prefix_, prefix, prefix_size);
+  }
+
+  void Add(const KeyType &key) {
+    const auto *bytes = reinterpret_cast<const char *>(&key);
+    if (empty_) {
+      memcpy(prefix_, bytes, sizeof(KeyType));
+      prefix_size_ = sizeof(KeyType);
+      empty_ = false;
+    } else {
+      prefix_size_ = std::mismatch(prefix_, prefix_ + prefix_size_, bytes).first - prefix_;
+    }
+    end_ = std::max(end_, SignificantSize(key));
+  }
+
+  // the bytes past the end of every key are zero and need not be stored, even when they are common to all of them
+  auto PrefixSize() const -> size_t { return std::min(prefix_size_, end_); }
+  auto KeyWidth() const -> size_t { return end_ - PrefixSize(); }
+  auto Prefix() const -> const char * { return prefix_; }
+
+  // bytes taken by the prefix and `count` entries with values of `value_size` bytes
+  auto Bytes(size_t count, size_t value_size) const -> size_t {
+    return PrefixSize() + count * (KeyWidth() + value_size);
+  }
+
+  // whether a page laid out as `other` stores the keys the same way
+  auto operator==(const KeyLayout &other) const -> bool {
+    return PrefixSize() == other.PrefixSize() && KeyWidth() == other.KeyWidth() &&
+           memcmp(prefix_, other.prefix_, PrefixSize()) == 0;
+  }
+
+  // the length of `key` without its trailing zero bytes
+  static auto SignificantSize(const KeyType &key) -> size_t {
+    const auto *bytes = reinterpret_cast<const char *>(&key);
+    size_t size = sizeof(KeyType);
+    while (size > 0 && bytes[size - 1] == 0) {
+      size--;
+    }
+    return size;
+  }
+
+ private:
+  bool empty_{true};
+  char prefix_[sizeof(KeyType)]{};
+  size_t prefix_size_{0};
+  size_t end_{0};
 };
 
 }  // namespace bustub
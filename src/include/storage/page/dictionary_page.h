@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// dictionary_page.h
+//
+// Identification: src/include/storage/page/dictionary_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+static constexpr uint64_t DICTIONARY_PAGE_HEADER_SIZE = 12;
+
+/**
+ * Dictionary page format, entries are appended in code order:
+ *  ---------------------------------------------------------------
+ *  | HEADER | Entry_1 | Entry_2 | ... | ... FREE SPACE ... |
+ *  ---------------------------------------------------------------
+ *
+ *  Header format (size in bytes):
+ *  ----------------------------------------------------------------------------
+ *  | NextPageId (4) | NumEntries (4) | FreeSpaceOffset (4) |
+ *  ----------------------------------------------------------------------------
+ *
+ * Entry format:
+ * | length (4) | bytes |
+ */
+class DictionaryPage {
+ public:
+  /** Largest string a single entry can hold. */
+  static constexpr uint32_t MAX_ENTRY_SIZE = BUSTUB_PAGE_SIZE - DICTIONARY_PAGE_HEADER_SIZE - sizeof(uint32_t);
+
+  /**
+   * Initialize the DictionaryPage header.
+   */
+  void Init();
+
+  /** @return number of entries in this page */
+  auto GetNumEntries() const -> uint32_t { return num_entries_; }
+
+  /** @return the page ID of the next dictionary page */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** Set the page id of the next dictionary page of the table. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /**
+   * Append an entry to the page.
+   * @param entry the string to append
+   * @return false if there is not enough space left
+   */
+  auto AppendEntry(std::string_view entry) -> bool;
+
+  /** @return all entries of the page, in the order they were appended */
+  auto GetEntries() const -> std::vector<std::string>;
+
+  static_assert(sizeof(page_id_t) == 4);
+
+ private:
+  char page_start_[0];
+  page_id_t next_page_id_;
+  uint32_t num_entries_;
+  uint32_t free_space_offset_;
+};
+
+static_assert(sizeof(DictionaryPage) == DICTIONARY_PAGE_HEADER_SIZE);
+
+}  // namespace bustub
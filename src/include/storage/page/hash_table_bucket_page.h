@@ -24,14 +24,20 @@ namespace bustub {
  * Store indexed key and and value together within bucket page. Supports
  * non-unique keys.
  *
- * Bucket page format (keys are stored in order):
- *  ----------------------------------------------------------------
- * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
- *  ----------------------------------------------------------------
+ * Bucket page format:
+ *  --------------------------------------------------------------------------------------------------------
+ * | OVERFLOW_PAGE_ID (4) | CTRL(1) | CTRL(2) | ... | CTRL(n) | KEY(1) + VALUE(1) | ... | KEY(n) + VALUE(n)
+ *  --------------------------------------------------------------------------------------------------------
  *
- *  Here '+' means concatenation.
- *  The above format omits the space required for the occupied_ and
- *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
+ *  Here '+' means concatenation. Like in a SwissTable, every slot has a one-byte control
+ *  word: 0 for a slot that was never used, 1 for a tombstone, or the high bit set plus 7
+ *  bits of the key's hash (the tag) for a live entry. Lookups compare 16 control words
+ *  at a time against the tag and only compare the keys of the slots that match, so a probe
+ *  mostly reads the control words instead of every key in the bucket. Slots are taken
+ *  front to back, the first never-used slot ends a scan.
+ *  A bucket that can no longer be split chains overflow pages of the same format, the
+ *  primary bucket page links to the first of them.
+ *  More information is in storage/page/hash_table_page_defs.h.
  *
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -137,11 +143,33 @@ class HashTableBucketPage {
    */
   void PrintBucket();
 
+  /** @return the page id of the next overflow page of the bucket, INVALID_PAGE_ID at the end of the chain */
+  auto GetOverflowPageId() const -> page_id_t { return overflow_page_id_; }
+
+  /** Link the next overflow page, a new bucket page has to set INVALID_PAGE_ID since a zeroed page reads as page 0. */
+  void SetOverflowPageId(page_id_t page_id) { overflow_page_id_ = page_id; }
+
+  /**
+   * @return the control word of a live entry with key `key`
+   */
+  static auto TagOf(const KeyType &key) -> uint8_t;
+
  private:
+  static constexpr uint8_t CTRL_EMPTY = 0;
+  static constexpr uint8_t CTRL_DELETED = 1;
+  static constexpr uint8_t CTRL_FULL = 0x80;
+
+  /**
+   * Call `visit(slot)` for every slot in use whose control word equals `ctrl`, stopping at the first never-used slot
+   * or as soon as `visit` returns true.
+   * @return whether `visit` returned true
+   */
+  template <typename Visitor>
+  auto MatchCtrl(uint8_t ctrl, Visitor &&visit) const -> bool;
+
+  page_id_t overflow_page_id_;
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
-  char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
-  // 0 if tombstone/brand new (never occupied), 1 otherwise.
-  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  uint8_t ctrl_[BUCKET_CTRL_SIZE];
   // Flexible array member for page data.
   MappingType array_[1];
 };
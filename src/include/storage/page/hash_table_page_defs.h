@@ -35,10 +35,15 @@
 
 /**
  * BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in an extendible hash index bucket page.
- * The computation is the same as the above BLOCK_ARRAY_SIZE, but blocks and buckets have different implementations
- * of search, insertion, removal, and helper methods.
+ * Every pair needs one control byte. The control bytes are rounded up to BUCKET_CTRL_GROUP_SIZE so that they can be
+ * matched a group at a time, the 16 bytes held back cover that rounding. Another 4 bytes hold the page id of the
+ * bucket's first overflow page.
  */
-#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_CTRL_GROUP_SIZE 16
+#define BUCKET_ARRAY_SIZE \
+  ((BUSTUB_PAGE_SIZE - BUCKET_CTRL_GROUP_SIZE - sizeof(page_id_t)) / (sizeof(MappingType) + 1))
+#define BUCKET_CTRL_SIZE \
+  ((BUCKET_ARRAY_SIZE + BUCKET_CTRL_GROUP_SIZE - 1) / BUCKET_CTRL_GROUP_SIZE * BUCKET_CTRL_GROUP_SIZE)
 
 /**
  * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_dictionary.h
+//
+// Identification: src/include/storage/table/table_dictionary.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TableDictionary encodes the dictionary-compressed VARCHAR columns of a table. Every distinct string stored in any
+ * of those columns gets a dense INTEGER code, and the table heap stores the code instead of the string. Codes are
+ * shared by all encoded columns of the table, so two encoded columns can be compared for equality code to code.
+ *
+ * The dictionary is append-only: codes are never reused or removed, so a code handed out once stays valid for the
+ * lifetime of the table. Entries are persisted in a chain of DictionaryPages in code order, the in-memory maps are
+ * only a cache of those pages.
+ */
+class TableDictionary {
+ public:
+  /**
+   * Create an empty dictionary for the encoded columns of `schema`.
+   * @param bpm the buffer pool manager
+   * @param schema the logical schema of the table
+   */
+  TableDictionary(BufferPoolManager *bpm, const Schema &schema);
+
+  /**
+   * Open an existing dictionary by reading back its pages.
+   * @param bpm the buffer pool manager
+   * @param schema the logical schema of the table
+   * @param first_page_id the id of the first dictionary page
+   */
+  TableDictionary(BufferPoolManager *bpm, const Schema &schema, page_id_t first_page_id);
+
+  /** @return whether column `column_idx` is stored as a dictionary code */
+  auto IsEncoded(uint32_t column_idx) const -> bool { return encoded_[column_idx]; }
+
+  /** @return the schema tuples are stored with in the table heap, encoded columns are INTEGER codes */
+  auto GetStorageSchema() const -> const Schema & { return storage_schema_; }
+
+  /** @return the id of the first dictionary page */
+  auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
+
+  /** @return the number of distinct strings in the dictionary */
+  auto Size() const -> size_t;
+
+  /** @return the code of `str`, assigning the next free code if it has not been seen yet */
+  auto Encode(const std::string &str) -> int32_t;
+
+  /** @return the code of `str`, or std::nullopt if no tuple of the table has ever stored it */
+  auto Lookup(const std::string &str) const -> std::optional<int32_t>;
+
+  /** @return the string behind `code` */
+  auto Decode(int32_t code) const -> std::string;
+
+  /** Convert a tuple of the logical schema into its storage form. */
+  auto EncodeTuple(const Tuple &tuple) -> Tuple;
+
+  /** Convert a tuple in storage form back into the logical schema, keeping its rid. */
+  auto DecodeTuple(const Tuple &tuple) const -> Tuple;
+
+ private:
+  /** Append `str` to the last dictionary page, chaining a new page if it is full. Caller holds latch_. */
+  void PersistEntry(const std::string &str);
+
+  BufferPoolManager *bpm_;
+  Schema schema_;
+  Schema storage_schema_;
+  std::vector<bool> encoded_;
+
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+
+  mutable std::shared_mutex latch_;
+  std::unordered_map<std::string, int32_t> codes_;
+  std::vector<std::string> strings_;
+};
+
+}  // namespace bustub
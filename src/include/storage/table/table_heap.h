@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <mutex>  // NOLINT
 #include <optional>
 #include <utility>
@@ -22,8 +23,10 @@
 #include "concurrency/transaction.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
+#include "storage/table/table_dictionary.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
@@ -67,6 +70,16 @@ class TableHeap {
    */
   auto GetTuple(RID rid) -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Read a tuple from the table without copying it. The page holding the tuple is read-latched into `guard`, and the
+   * returned view is only valid as long as that guard is held. If the table has a dictionary, the view is in storage
+   * form and must be read with the dictionary's storage schema.
+   * @param rid rid of the tuple to read
+   * @param[out] guard receives the read guard of the page holding the tuple
+   * @return the meta and a view of the tuple
+   */
+  auto GetTupleView(RID rid, ReadPageGuard *guard) -> std::pair<TupleMeta, TupleView>;
+
   /**
    * Read a tuple meta from the table. Note: if you want to get tuple and meta together, use `GetTuple` insead
    * to ensure atomicity.
@@ -92,12 +105,33 @@ class TableHeap {
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /**
+   * Start maintaining per-page zone maps for the fixed-width columns of `schema`. Must be called before the first
+   * insert, otherwise pages filled earlier have no zone and are never pruned.
+   */
+  void EnableZoneMap(const Schema &schema) { zone_map_ = std::make_unique<ZoneMap>(schema); }
+
+  /** @return the zone map of this table, or nullptr if it is not maintained */
+  auto GetZoneMap() const -> const ZoneMap * { return zone_map_.get(); }
+
+  /**
+   * Store the dictionary-encoded columns of `schema` as codes. Must be called before the first insert, tuples
+   * inserted earlier would be read back with the wrong layout.
+   */
+  void EnableDictionary(const Schema &schema) { dictionary_ = std::make_unique<TableDictionary>(bpm_, schema); }
+
+  /** @return the dictionary of this table, or nullptr if no column is dictionary encoded */
+  auto GetDictionary() const -> const TableDictionary * { return dictionary_.get(); }
+
  private:
   BufferPoolManager *bpm_;
   page_id_t first_page_id_{INVALID_PAGE_ID};
 
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+
+  std::unique_ptr<ZoneMap> zone_map_{nullptr};
+  std::unique_ptr<TableDictionary> dictionary_{nullptr};
 };
 
 }  // namespace bustub
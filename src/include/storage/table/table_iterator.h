@@ -24,6 +24,7 @@
 namespace bustub {
 
 class TableHeap;
+class ReadPageGuard;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
@@ -41,12 +42,18 @@ class TableIterator {
 
   auto GetTuple() -> std::pair<TupleMeta, Tuple>;
 
+  // Zero-copy variant of GetTuple. The returned view is only valid while `guard` is held.
+  auto GetTupleView(ReadPageGuard *guard) -> std::pair<TupleMeta, TupleView>;
+
   auto GetRID() -> RID;
 
   auto IsEnd() -> bool;
 
   auto operator++() -> TableIterator &;
 
+  // Move to the first tuple of the next page, skipping the rest of the current one.
+  auto SkipPage() -> TableIterator &;
+
  private:
   TableHeap *table_heap_;
   RID rid_;
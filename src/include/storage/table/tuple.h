@@ -12,11 +12,13 @@
 
 #pragma once
 
+#include <cstring>
 #include <string>
 #include <vector>
 
 #include "catalog/schema.h"
 #include "common/rid.h"
+#include "storage/table/tuple_arena.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -42,6 +44,110 @@ struct TupleMeta {
 
 static_assert(sizeof(TupleMeta) == TUPLE_META_SIZE);
 
+/**
+ * TupleStorage is the byte buffer behind a Tuple. Buffers of up to INLINE_CAPACITY bytes live inside the object
+ * itself, larger ones either on the heap or, when an arena is supplied, in that arena.
+ *
+ * A copy always owns its bytes (inline or heap), so copying an arena-backed tuple yields one that may outlive the
+ * arena. A move keeps the backing of the source.
+ */
+class TupleStorage {
+ public:
+  static constexpr uint32_t INLINE_CAPACITY = 32;
+
+  TupleStorage() = default;
+
+  TupleStorage(const TupleStorage &other) { Assign(other.Data(), other.Size()); }
+
+  TupleStorage(TupleStorage &&other) noexcept { MoveFrom(&other); }
+
+  auto operator=(const TupleStorage &other) -> TupleStorage & {
+    if (this != &other) {
+      Assign(other.Data(), other.Size());
+    }
+    return *this;
+  }
+
+  auto operator=(TupleStorage &&other) noexcept -> TupleStorage & {
+    if (this != &other) {
+      Release();
+      MoveFrom(&other);
+    }
+    return *this;
+  }
+
+  ~TupleStorage() { Release(); }
+
+  inline auto Data() -> char * { return kind_ == Kind::INLINE ? inline_ : ptr_; }
+
+  inline auto Data() const -> const char * { return kind_ == Kind::INLINE ? inline_ : ptr_; }
+
+  inline auto Size() const -> uint32_t { return size_; }
+
+  /** @return true if the bytes are stored inside this object */
+  inline auto IsInline() const -> bool { return kind_ == Kind::INLINE; }
+
+  /** @return true if the bytes are stored in an arena */
+  inline auto IsArena() const -> bool { return kind_ == Kind::ARENA; }
+
+  /**
+   * Make room for `size` bytes, discarding the current contents. The new bytes are uninitialized.
+   * @param size number of bytes
+   * @param arena if not null and the bytes do not fit inline, allocate them from this arena instead of the heap
+   */
+  void Allocate(uint32_t size, TupleArena *arena = nullptr) {
+    Release();
+    size_ = size;
+    if (size <= INLINE_CAPACITY) {
+      kind_ = Kind::INLINE;
+    } else if (arena != nullptr) {
+      kind_ = Kind::ARENA;
+      ptr_ = arena->Allocate(size);
+    } else {
+      kind_ = Kind::HEAP;
+      ptr_ = new char[size];
+    }
+  }
+
+  /** Replace the contents with a copy of `size` bytes at `data`, which must not point into this buffer. */
+  void Assign(const char *data, uint32_t size, TupleArena *arena = nullptr) {
+    Allocate(size, arena);
+    if (size > 0) {
+      memcpy(Data(), data, size);
+    }
+  }
+
+ private:
+  enum class Kind : uint8_t { INLINE, HEAP, ARENA };
+
+  void Release() {
+    if (kind_ == Kind::HEAP) {
+      delete[] ptr_;
+    }
+    kind_ = Kind::INLINE;
+    size_ = 0;
+  }
+
+  void MoveFrom(TupleStorage *other) {
+    size_ = other->size_;
+    kind_ = other->kind_;
+    if (kind_ == Kind::INLINE) {
+      memcpy(inline_, other->inline_, size_);
+    } else {
+      ptr_ = other->ptr_;
+    }
+    other->kind_ = Kind::INLINE;
+    other->size_ = 0;
+  }
+
+  uint32_t size_{0};
+  Kind kind_{Kind::INLINE};
+  union {
+    char inline_[INLINE_CAPACITY];
+    char *ptr_;
+  };
+};
+
 /**
  * Tuple format:
  * ---------------------------------------------------------------------
@@ -52,6 +158,8 @@ class Tuple {
   friend class TablePage;
   friend class TableHeap;
   friend class TableIterator;
+  friend class TableDictionary;
+  friend class TupleView;
 
  public:
   // Default constructor (to create a dummy tuple)
@@ -60,8 +168,8 @@ class Tuple {
   // constructor for table heap tuple
   explicit Tuple(RID rid) : rid_(rid) {}
 
-  // constructor for creating a new tuple based on input value
-  Tuple(std::vector<Value> values, const Schema *schema);
+  // constructor for creating a new tuple based on input value, optionally placing large tuples in an arena
+  Tuple(std::vector<Value> values, const Schema *schema, TupleArena *arena = nullptr);
 
   Tuple(const Tuple &other) = default;
 
@@ -84,17 +192,18 @@ class Tuple {
   inline auto GetRid() const -> RID { return rid_; }
 
   // Get the address of this tuple in the table's backing store
-  inline auto GetData() const -> const char * { return data_.data(); }
+  inline auto GetData() const -> const char * { return data_.Data(); }
 
   // Get length of the tuple, including varchar legth
-  inline auto GetLength() const -> uint32_t { return data_.size(); }
+  inline auto GetLength() const -> uint32_t { return data_.Size(); }
 
   // Get the value of a specified column (const)
   // checks the schema to see how to return the Value.
   auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
 
   // Generates a key tuple given schemas and attributes
-  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) -> Tuple;
+  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const
+      -> Tuple;
 
   // Is the column value null ?
   inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
@@ -109,7 +218,43 @@ class Tuple {
   auto GetDataPtr(const Schema *schema, uint32_t column_idx) const -> const char *;
 
   RID rid_{};  // if pointing to the table heap, the rid is valid
-  std::vector<char> data_;
+  TupleStorage data_;
+};
+
+/**
+ * TupleView is a non-owning reference to tuple bytes that live somewhere else, usually inside a pinned table page.
+ * It is only valid as long as the memory it points to is, i.e. for the lifetime of the page guard it was obtained
+ * with. Use `Materialize` to get an owning `Tuple` that outlives the guard.
+ */
+class TupleView {
+ public:
+  // Default constructor (to create an empty view)
+  TupleView() = default;
+
+  TupleView(const char *data, uint32_t size, RID rid) : data_(data), size_(size), rid_(rid) {}
+
+  // view over an owning tuple, valid as long as the tuple is not modified or destroyed
+  explicit TupleView(const Tuple &tuple) : data_(tuple.GetData()), size_(tuple.GetLength()), rid_(tuple.GetRid()) {}
+
+  // return RID of the viewed tuple
+  inline auto GetRid() const -> RID { return rid_; }
+
+  // Get the address of the viewed tuple data
+  inline auto GetData() const -> const char * { return data_; }
+
+  // Get length of the viewed tuple, including varchar length
+  inline auto GetLength() const -> uint32_t { return size_; }
+
+  // Get the value of a specified column without copying the tuple
+  auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
+
+  // Copy the viewed bytes into a tuple, placing large tuples in `arena` if given
+  auto Materialize(TupleArena *arena = nullptr) const -> Tuple;
+
+ private:
+  const char *data_{nullptr};
+  uint32_t size_{0};
+  RID rid_{};
 };
 
 }  // namespace bustub
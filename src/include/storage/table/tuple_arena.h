@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_arena.h
+//
+// Identification: src/include/storage/table/tuple_arena.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TupleArena is a bump allocator for tuple bytes. Allocation is a pointer increment inside the current block;
+ * nothing is freed individually. All memory is released at once by `Reset` or when the arena is destroyed, so any
+ * tuple backed by the arena must not outlive either.
+ */
+class TupleArena {
+ public:
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+  explicit TupleArena(size_t block_size = DEFAULT_BLOCK_SIZE) : block_size_(block_size) {}
+
+  ~TupleArena() = default;
+
+  DISALLOW_COPY_AND_MOVE(TupleArena);
+
+  /**
+   * Allocate `size` bytes aligned to 8 bytes. The memory is uninitialized.
+   * @param size number of bytes to allocate
+   * @return pointer to the allocated memory, valid until the next `Reset`
+   */
+  auto Allocate(size_t size) -> char * {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (size > remaining_) {
+      NewBlock(size);
+    }
+    char *ptr = cursor_;
+    cursor_ += size;
+    remaining_ -= size;
+    bytes_allocated_ += size;
+    return ptr;
+  }
+
+  /**
+   * Release all allocations at once. The first block is kept around so that an arena reused across batches does
+   * not go back to the system allocator.
+   */
+  void Reset() {
+    if (blocks_.empty()) {
+      return;
+    }
+    if (blocks_.size() > 1) {
+      blocks_.erase(blocks_.begin() + 1, blocks_.end());
+      block_sizes_.erase(block_sizes_.begin() + 1, block_sizes_.end());
+    }
+    cursor_ = blocks_.front().get();
+    remaining_ = block_sizes_.front();
+    bytes_allocated_ = 0;
+  }
+
+  /** @return the number of bytes handed out since the last reset */
+  auto BytesAllocated() const -> size_t { return bytes_allocated_; }
+
+  /** @return the number of blocks currently held by the arena */
+  auto NumBlocks() const -> size_t { return blocks_.size(); }
+
+ private:
+  static constexpr size_t ALIGNMENT = 8;
+
+  void NewBlock(size_t min_size) {
+    size_t size = min_size > block_size_ ? min_size : block_size_;
+    blocks_.emplace_back(new char[size]);
+    block_sizes_.push_back(size);
+    cursor_ = blocks_.back().get();
+    remaining_ = size;
+  }
+
+  size_t block_size_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  std::vector<size_t> block_sizes_;
+  char *cursor_{nullptr};
+  size_t remaining_{0};
+  size_t bytes_allocated_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Summary of the values of one column on one table page.
+ */
+struct ColumnZone {
+  /** Smallest non-null value seen, only meaningful if has_range_ */
+  Value min_;
+  /** Largest non-null value seen, only meaningful if has_range_ */
+  Value max_;
+  /** Whether at least one non-null value was seen */
+  bool has_range_{false};
+  /** Number of null values seen */
+  uint32_t null_count_{0};
+};
+
+/**
+ * ZoneMap keeps per-page min/max/null-count summaries for the fixed-width columns of a table. It lives next to the
+ * table heap and is widened on every insert; deletes never shrink it, so a zone is always a superset of the values
+ * actually on the page. A page without a zone has unknown contents and must be scanned.
+ */
+class ZoneMap {
+ public:
+  explicit ZoneMap(const Schema &schema);
+
+  /** Widen the zone of `page_id` with the values of `tuple`. */
+  void Insert(page_id_t page_id, const Tuple &tuple);
+
+  /** @return whether column `column_idx` is summarized */
+  auto IsTracked(uint32_t column_idx) const -> bool { return tracked_[column_idx]; }
+
+  /**
+   * @return the summary of column `column_idx` on page `page_id`, or std::nullopt if the column is not tracked or
+   * nothing is known about the page
+   */
+  auto GetColumnZone(page_id_t page_id, uint32_t column_idx) const -> std::optional<ColumnZone>;
+
+ private:
+  Schema schema_;
+  std::vector<bool> tracked_;
+  mutable std::shared_mutex latch_;
+  std::unordered_map<page_id_t, std::vector<ColumnZone>> zones_;
+};
+
+}  // namespace bustub
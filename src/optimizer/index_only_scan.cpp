@@ -0,0 +1,105 @@
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+void CollectColumns(const AbstractExpressionRef &expr, std::unordered_set<uint32_t> *columns) {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+    columns->insert(column->GetColIdx());
+    return;
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+/**
+ * Walk down from the child of a column-narrowing node through nodes that pass their input tuples through unchanged,
+ * and turn the index scan at the bottom into an index-only scan if the index key has every column read on the way.
+ * @return the rewritten subtree, or nullptr if there is no such scan or the index does not cover the columns
+ */
+auto MakeIndexOnly(const AbstractPlanNodeRef &plan, std::unordered_set<uint32_t> *columns, const Catalog &catalog)
+    -> AbstractPlanNodeRef {
+  switch (plan->GetType()) {
+    case PlanType::Sort:
+    case PlanType::TopN:
+    case PlanType::Limit: {
+      if (plan->GetType() == PlanType::Sort) {
+        for (const auto &order_by : dynamic_cast<const SortPlanNode &>(*plan).GetOrderBy()) {
+          CollectColumns(order_by.second, columns);
+        }
+      } else if (plan->GetType() == PlanType::TopN) {
+        for (const auto &order_by : dynamic_cast<const TopNPlanNode &>(*plan).GetOrderBy()) {
+          CollectColumns(order_by.second, columns);
+        }
+      }
+      auto child = MakeIndexOnly(plan->GetChildAt(0), columns, catalog);
+      return child == nullptr ? nullptr : plan->CloneWithChildren({std::move(child)});
+    }
+    case PlanType::IndexScan: {
+      const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*plan);
+      if (index_scan.filter_predicate_ != nullptr) {
+        CollectColumns(index_scan.filter_predicate_, columns);
+      }
+      const auto &key_attrs = catalog.GetIndex(index_scan.GetIndexOid())->index_->GetKeyAttrs();
+      std::unordered_set<uint32_t> key_columns(key_attrs.begin(), key_attrs.end());
+      for (auto column : *columns) {
+        if (key_columns.count(column) == 0) {
+          return nullptr;
+        }
+      }
+      return std::make_shared<IndexScanPlanNode>(index_scan.output_schema_, index_scan.index_oid_, index_scan.range_,
+                                                 index_scan.filter_predicate_, index_scan.descending_, true);
+    }
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeIndexOnlyScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // only a projection or an aggregation drops columns, every other parent may pass the whole tuple up
+  std::unordered_set<uint32_t> columns;
+  if (optimized_plan->GetType() == PlanType::Projection) {
+    for (const auto &expr : dynamic_cast<const ProjectionPlanNode &>(*optimized_plan).GetExpressions()) {
+      CollectColumns(expr, &columns);
+    }
+  } else if (optimized_plan->GetType() == PlanType::Aggregation) {
+    const auto &agg_plan = dynamic_cast<const AggregationPlanNode &>(*optimized_plan);
+    for (const auto &expr : agg_plan.GetGroupBys()) {
+      CollectColumns(expr, &columns);
+    }
+    for (const auto &expr : agg_plan.GetAggregates()) {
+      CollectColumns(expr, &columns);
+    }
+  } else {
+    return optimized_plan;
+  }
+  auto child = MakeIndexOnly(optimized_plan->GetChildAt(0), &columns, catalog_);
+  if (child == nullptr) {
+    return optimized_plan;
+  }
+  return optimized_plan->CloneWithChildren({std::move(child)});
+}
+
+}  // namespace bustub
@@ -32,10 +32,11 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
     const auto &sort_plan = dynamic_cast<const SortPlanNode &>(*optimized_plan);
     const auto &order_bys = sort_plan.GetOrderBy();
 
+    // Order types are all asc (or default), or all desc, which walks the index backwards
+    bool descending = !order_bys.empty() && order_bys[0].first == OrderByType::DESC;
     std::vector<uint32_t> order_by_column_ids;
     for (const auto &[order_type, expr] : order_bys) {
-      // Order type is asc or default
-      if (order_type != OrderByType::ASC && order_type != OrderByType::DEFAULT) {
+      if ((order_type == OrderByType::DESC) != descending || order_type == OrderByType::INVALID) {
         return optimized_plan;
       }
 
@@ -50,27 +51,66 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
 
     // Has exactly one child
     BUSTUB_ENSURE(optimized_plan->children_.size() == 1, "Sort with multiple children?? Impossible!");
-    const auto &child_plan = optimized_plan->children_[0];
+    auto child_plan = optimized_plan->children_[0];
+
+    // look through a projection of plain columns, the scan below it can still produce the order
+    const ProjectionPlanNode *projection = nullptr;
+    if (child_plan->GetType() == PlanType::Projection) {
+      projection = dynamic_cast<const ProjectionPlanNode *>(child_plan.get());
+      for (auto &col_id : order_by_column_ids) {
+        const auto *column_value_expr =
+            dynamic_cast<const ColumnValueExpression *>(projection->GetExpressions()[col_id].get());
+        if (column_value_expr == nullptr) {
+          return optimized_plan;
+        }
+        col_id = column_value_expr->GetColIdx();
+      }
+      child_plan = projection->GetChildAt(0);
+    }
+    auto with_projection = [&](AbstractPlanNodeRef scan) -> AbstractPlanNodeRef {
+      return projection == nullptr ? scan : projection->CloneWithChildren({std::move(scan)});
+    };
+
+    // check the index is ordered and its key schema == order by columns
+    auto index_matches = [&](const IndexInfo *index, const Schema &table_schema) {
+      const auto &columns = index->key_schema_.GetColumns();
+      if (index->index_type_ == IndexType::HashTableIndex || columns.size() != order_by_column_ids.size() ||
+          !index->index_->GetKeyExpressions().empty()) {
+        return false;
+      }
+      for (size_t i = 0; i < columns.size(); i++) {
+        if (columns[i].GetName() != table_schema.GetColumn(order_by_column_ids[i]).GetName()) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    if (child_plan->GetType() == PlanType::IndexScan) {
+      // a range scan picked for the filter already produces the order if it uses the same index
+      const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*child_plan);
+      const auto *index = catalog_.GetIndex(index_scan.GetIndexOid());
+      if (index_matches(index, catalog_.GetTable(index->table_name_)->schema_)) {
+        return with_projection(std::make_shared<IndexScanPlanNode>(
+            child_plan->output_schema_, index_scan.index_oid_, index_scan.range_, index_scan.filter_predicate_,
+            descending));
+      }
+    }
 
     if (child_plan->GetType() == PlanType::SeqScan) {
       const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
+      // the index scan has no predicate of its own
+      if (seq_scan.filter_predicate_ != nullptr) {
+        return optimized_plan;
+      }
       const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
       const auto indices = catalog_.GetTableIndexes(table_info->name_);
 
       for (const auto *index : indices) {
-        const auto &columns = index->key_schema_.GetColumns();
-        // check index key schema == order by columns
-        bool valid = true;
-        if (columns.size() == order_by_column_ids.size()) {
-          for (size_t i = 0; i < columns.size(); i++) {
-            if (columns[i].GetName() != table_info->schema_.GetColumn(order_by_column_ids[i]).GetName()) {
-              valid = false;
-              break;
-            }
-          }
-          if (valid) {
-            return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
-          }
+        // a partial index does not reach every row
+        if (index->index_->GetPredicate() == nullptr && index_matches(index, table_info->schema_)) {
+          return with_projection(std::make_shared<IndexScanPlanNode>(child_plan->output_schema_, index->index_oid_,
+                                                                     IndexKeyRange{}, nullptr, descending));
         }
       }
     }
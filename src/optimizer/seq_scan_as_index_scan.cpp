@@ -0,0 +1,238 @@
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+#include "storage/index/index.h"
+#include "type/type_id.h"
+
+namespace bustub {
+
+namespace {
+
+/**
+ * A `key <op> constant` conjunct of a scan predicate, with the operator flipped if the constant came first. The key
+ * side is a column or an expression over the columns, which can match the key of an expression index.
+ */
+struct KeyBound {
+  AbstractExpressionRef key_;
+  ComparisonType comp_type_;
+  Value value_;
+};
+
+void CollectConjuncts(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *conjuncts) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get());
+      logic != nullptr && logic->logic_type_ == LogicType::And) {
+    CollectConjuncts(logic->GetChildAt(0), conjuncts);
+    CollectConjuncts(logic->GetChildAt(1), conjuncts);
+    return;
+  }
+  conjuncts->push_back(expr);
+}
+
+void CollectKeyBounds(const AbstractExpressionRef &conjunct, std::vector<KeyBound> *bounds) {
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(conjunct.get());
+  if (comparison == nullptr || comparison->comp_type_ == ComparisonType::NotEqual) {
+    return;
+  }
+  auto comp_type = comparison->comp_type_;
+  auto key = comparison->GetChildAt(0);
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+  if (constant == nullptr) {
+    // try `constant <op> key`, flipping the operator
+    key = comparison->GetChildAt(1);
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+    if (constant == nullptr) {
+      return;
+    }
+    switch (comp_type) {
+      case ComparisonType::LessThan:
+        comp_type = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        comp_type = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        comp_type = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        comp_type = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  if (dynamic_cast<const ConstantValueExpression *>(key.get()) != nullptr || constant->val_.IsNull()) {
+    return;
+  }
+  bounds->push_back({std::move(key), comp_type, constant->val_});
+}
+
+/** @return whether `key` computes the leading key column of `index` */
+auto IsLeadingKey(const AbstractExpressionRef &key, const Index &index) -> bool {
+  const auto &key_exprs = index.GetKeyExpressions();
+  if (!key_exprs.empty()) {
+    return fmt::format("{}", key) == fmt::format("{}", key_exprs[0]);
+  }
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(key.get());
+  return column != nullptr && column->GetTupleIdx() == 0 && column->GetColIdx() == index.GetKeyAttrs()[0];
+}
+
+/** @return whether every conjunct of the predicate of a partial index is also a conjunct of the scan predicate */
+auto ImpliesPredicate(const std::unordered_set<std::string> &conjuncts, const Index &index) -> bool {
+  if (index.GetPredicate() == nullptr) {
+    return true;
+  }
+  std::vector<AbstractExpressionRef> index_conjuncts;
+  CollectConjuncts(index.GetPredicate(), &index_conjuncts);
+  for (const auto &conjunct : index_conjuncts) {
+    if (conjuncts.count(fmt::format("{}", conjunct)) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** @return whether values of the two types can be ordered against each other */
+auto IsComparable(TypeId column_type, TypeId constant_type) -> bool {
+  if ((column_type == TypeId::BOOLEAN) != (constant_type == TypeId::BOOLEAN)) {
+    return false;
+  }
+  return (column_type == TypeId::VARCHAR) == (constant_type == TypeId::VARCHAR);
+}
+
+/** @return whether a constant of `constant_type` has the same key bytes as the value stored in the column */
+auto IsHashable(TypeId column_type, TypeId constant_type) -> bool {
+  if (column_type == constant_type) {
+    return true;
+  }
+  // narrower integers widen losslessly
+  auto is_integer = [](TypeId type) { return type >= TypeId::TINYINT && type <= TypeId::BIGINT; };
+  return is_integer(column_type) && is_integer(constant_type) && constant_type < column_type;
+}
+
+/** Narrow `range` with one bound, keeping whichever of the old and new bound is tighter. */
+void TightenRange(IndexKeyRange *range, const KeyBound &bound) {
+  auto tighten_low = [range](const Value &value, bool inclusive) {
+    if (!range->low_.has_value() || value.CompareGreaterThan(*range->low_) == CmpBool::CmpTrue ||
+        (value.CompareEquals(*range->low_) == CmpBool::CmpTrue && !inclusive)) {
+      range->low_ = value;
+      range->low_inclusive_ = inclusive;
+    }
+  };
+  auto tighten_high = [range](const Value &value, bool inclusive) {
+    if (!range->high_.has_value() || value.CompareLessThan(*range->high_) == CmpBool::CmpTrue ||
+        (value.CompareEquals(*range->high_) == CmpBool::CmpTrue && !inclusive)) {
+      range->high_ = value;
+      range->high_inclusive_ = inclusive;
+    }
+  };
+  switch (bound.comp_type_) {
+    case ComparisonType::Equal:
+      tighten_low(bound.value_, true);
+      tighten_high(bound.value_, true);
+      break;
+    case ComparisonType::GreaterThan:
+    case ComparisonType::GreaterThanOrEqual:
+      tighten_low(bound.value_, bound.comp_type_ == ComparisonType::GreaterThanOrEqual);
+      break;
+    case ComparisonType::LessThan:
+    case ComparisonType::LessThanOrEqual:
+      tighten_high(bound.value_, bound.comp_type_ == ComparisonType::LessThanOrEqual);
+      break;
+    default:
+      break;
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  // the scans below a write would walk the index while the write modifies it
+  if (plan->GetType() == PlanType::Insert || plan->GetType() == PlanType::Delete ||
+      plan->GetType() == PlanType::Update) {
+    return plan;
+  }
+
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSeqScanAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*optimized_plan);
+  if (seq_scan.filter_predicate_ == nullptr) {
+    return optimized_plan;
+  }
+  std::vector<AbstractExpressionRef> conjuncts;
+  CollectConjuncts(seq_scan.filter_predicate_, &conjuncts);
+  std::vector<KeyBound> bounds;
+  std::unordered_set<std::string> conjunct_strings;
+  for (const auto &conjunct : conjuncts) {
+    CollectKeyBounds(conjunct, &bounds);
+    conjunct_strings.insert(fmt::format("{}", conjunct));
+  }
+  if (bounds.empty()) {
+    return optimized_plan;
+  }
+
+  const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
+  const IndexInfo *best_index = nullptr;
+  IndexKeyRange best_range;
+  int best_score = 0;
+  for (const auto *index : catalog_.GetTableIndexes(table_info->name_)) {
+    // a partial index misses the rows outside its predicate, so the scan predicate has to exclude them as well
+    if (!ImpliesPredicate(conjunct_strings, *index->index_)) {
+      continue;
+    }
+    // the range is on the first key column only
+    auto column_type = index->key_schema_.GetColumn(0).GetType();
+    bool is_hash = index->index_type_ == IndexType::HashTableIndex;
+    if (is_hash && index->index_->GetKeyAttrs().size() != 1) {
+      continue;
+    }
+    IndexKeyRange range;
+    for (const auto &bound : bounds) {
+      if (IsLeadingKey(bound.key_, *index->index_) && IsComparable(column_type, bound.value_.GetTypeId())) {
+        TightenRange(&range, bound);
+      }
+    }
+    if (range.IsFull()) {
+      continue;
+    }
+    // a hash probe beats a tree point lookup, which beats a closed range, which beats a half-open one
+    int score = range.low_.has_value() && range.high_.has_value() ? 2 : 1;
+    if (score == 2 && range.low_inclusive_ && range.high_inclusive_ &&
+        range.low_->CompareEquals(*range.high_) == CmpBool::CmpTrue) {
+      score = is_hash ? 4 : 3;
+    }
+    if (is_hash && (score != 4 || !IsHashable(column_type, range.low_->GetTypeId()))) {
+      continue;
+    }
+    if (score > best_score) {
+      best_index = index;
+      best_range = std::move(range);
+      best_score = score;
+    }
+  }
+  if (best_index == nullptr) {
+    return optimized_plan;
+  }
+  return std::make_shared<IndexScanPlanNode>(seq_scan.output_schema_, best_index->index_oid_, std::move(best_range),
+                                             seq_scan.filter_predicate_);
+}
+
+}  // namespace bustub
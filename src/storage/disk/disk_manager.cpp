@@ -11,9 +11,11 @@
 //===----------------------------------------------------------------------===//
 
 #include <sys/stat.h>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
+#include <iterator>
 #include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
@@ -122,6 +124,51 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   }
 }
 
+/**
+ * Hand out the lowest freed page, or extend the file by one page
+ */
+auto DiskManager::AllocatePage() -> page_id_t {
+  std::scoped_lock scoped_alloc_latch(alloc_latch_);
+  if (free_pages_.empty()) {
+    allocated_end_ = std::max(allocated_end_, next_page_id_ + 1);
+    return next_page_id_++;
+  }
+  page_id_t page_id = *free_pages_.begin();
+  free_pages_.erase(free_pages_.begin());
+  return page_id;
+}
+
+/**
+ * Record a page as free, a free run at the end of the file lowers the page count instead
+ */
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  std::scoped_lock scoped_alloc_latch(alloc_latch_);
+  if (page_id < 0 || page_id >= next_page_id_) {
+    return;
+  }
+  free_pages_.insert(page_id);
+  while (!free_pages_.empty() && *free_pages_.rbegin() == next_page_id_ - 1) {
+    free_pages_.erase(std::prev(free_pages_.end()));
+    next_page_id_--;
+  }
+}
+
+/**
+ * A page is free when it sits in the free set or was trimmed off the end of the file
+ */
+auto DiskManager::IsFree(page_id_t page_id) -> bool {
+  std::scoped_lock scoped_alloc_latch(alloc_latch_);
+  return (page_id >= next_page_id_ && page_id < allocated_end_) || free_pages_.count(page_id) != 0;
+}
+
+/**
+ * Returns the number of pages allocated, free pages in between included
+ */
+auto DiskManager::GetNumPages() -> page_id_t {
+  std::scoped_lock scoped_alloc_latch(alloc_latch_);
+  return next_page_id_;
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
@@ -0,0 +1,969 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.cpp
+//
+// Identification: src/storage/index/art_index.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/art_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <thread>  // NOLINT
+
+#include "common/exception.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+enum class ArtNodeType : uint8_t { Leaf, Node4, Node16, Node48, Node256 };
+
+/** Header shared by leaves and inner nodes. */
+struct ArtNode {
+  ArtNode(ArtNodeType type, std::string prefix) : type_(type), prefix_(std::move(prefix)) {}
+  virtual ~ArtNode() = default;
+
+  const ArtNodeType type_;
+  /** Key bytes shared by everything below the node, they come before its child byte. A node never changes its prefix,
+   * it is replaced by a copy with the new one instead. */
+  const std::string prefix_;
+  /** A change counter shifted left by two, then the locked and the obsolete bit */
+  std::atomic<uint64_t> version_{0};
+  /** Number of children */
+  std::atomic<uint16_t> count_{0};
+};
+
+/** A leaf holds one entry and is never modified, deleting the entry unlinks the leaf. */
+struct ArtLeaf : public ArtNode {
+  ArtLeaf(std::string key, Tuple tuple, RID rid)
+      : ArtNode(ArtNodeType::Leaf, ""), key_(std::move(key)), tuple_(std::move(tuple)), rid_(rid) {}
+
+  /** The encoded key, including the RID suffix of a non-unique index */
+  const std::string key_;
+  const Tuple tuple_;
+  const RID rid_;
+};
+
+/** Node4 and Node16 keep their child bytes sorted in a small array. */
+template <size_t N>
+struct ArtSortedNode : public ArtNode {
+  ArtSortedNode(ArtNodeType type, std::string prefix) : ArtNode(type, std::move(prefix)) {}
+
+  std::array<std::atomic<uint8_t>, N> keys_{};
+  std::array<std::atomic<ArtNode *>, N> children_{};
+};
+
+using ArtNode4 = ArtSortedNode<4>;
+using ArtNode16 = ArtSortedNode<16>;
+
+/** Node48 maps every byte to one of 48 child slots. */
+struct ArtNode48 : public ArtNode {
+  explicit ArtNode48(std::string prefix) : ArtNode(ArtNodeType::Node48, std::move(prefix)) {}
+
+  /** Child slot of each byte plus one, 0 if the byte has no child */
+  std::array<std::atomic<uint8_t>, 256> child_index_{};
+  std::array<std::atomic<ArtNode *>, 48> children_{};
+};
+
+/** Node256 has a child pointer for every byte. */
+struct ArtNode256 : public ArtNode {
+  explicit ArtNode256(std::string prefix) : ArtNode(ArtNodeType::Node256, std::move(prefix)) {}
+
+  std::array<std::atomic<ArtNode *>, 256> children_{};
+};
+
+namespace {
+
+constexpr uint64_t LOCKED_BIT = 0b10;
+constexpr uint64_t OBSOLETE_BIT = 0b01;
+
+/** Begin an optimistic read of `node`. @return false if the node is being changed or has been replaced */
+auto ReadLock(ArtNode *node, uint64_t *version) -> bool {
+  *version = node->version_.load(std::memory_order_acquire);
+  return (*version & (LOCKED_BIT | OBSOLETE_BIT)) == 0;
+}
+
+/** @return whether `node` is unchanged since `version` was read, so that everything read from it since is consistent */
+auto Validate(ArtNode *node, uint64_t version) -> bool {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return node->version_.load(std::memory_order_relaxed) == version;
+}
+
+/** Turn an optimistic read into a write lock. @return false if the node changed since `version` was read */
+auto Upgrade(ArtNode *node, uint64_t version) -> bool {
+  return node->version_.compare_exchange_strong(version, version + LOCKED_BIT, std::memory_order_acquire);
+}
+
+void WriteUnlock(ArtNode *node) { node->version_.fetch_add(LOCKED_BIT, std::memory_order_release); }
+
+/** Unlock a node that has been unlinked, readers still holding it restart. */
+void WriteUnlockObsolete(ArtNode *node) {
+  node->version_.fetch_add(LOCKED_BIT | OBSOLETE_BIT, std::memory_order_release);
+}
+
+auto Capacity(ArtNodeType type) -> size_t {
+  switch (type) {
+    case ArtNodeType::Node4:
+      return 4;
+    case ArtNodeType::Node16:
+      return 16;
+    case ArtNodeType::Node48:
+      return 48;
+    case ArtNodeType::Node256:
+      return 256;
+    default:
+      UNREACHABLE("leaves have no children");
+  }
+}
+
+auto Grown(ArtNodeType type) -> ArtNodeType {
+  return type == ArtNodeType::Node4 ? ArtNodeType::Node16
+                                    : type == ArtNodeType::Node16 ? ArtNodeType::Node48 : ArtNodeType::Node256;
+}
+
+auto Shrunk(ArtNodeType type) -> ArtNodeType {
+  return type == ArtNodeType::Node256 ? ArtNodeType::Node48
+                                      : type == ArtNodeType::Node48 ? ArtNodeType::Node16 : ArtNodeType::Node4;
+}
+
+/** @return whether a node of `type` with `count` children moves to the next smaller type when one is removed */
+auto ShouldShrink(ArtNodeType type, size_t count) -> bool {
+  // leave the smaller node some room, so that a key inserted and deleted over and over does not copy it every time
+  return type != ArtNodeType::Node4 && count - 1 < Capacity(Shrunk(type)) * 3 / 4;
+}
+
+auto NewInner(ArtNodeType type, std::string prefix) -> ArtNode * {
+  switch (type) {
+    case ArtNodeType::Node4:
+      return new ArtNode4(type, std::move(prefix));
+    case ArtNodeType::Node16:
+      return new ArtNode16(type, std::move(prefix));
+    case ArtNodeType::Node48:
+      return new ArtNode48(std::move(prefix));
+    case ArtNodeType::Node256:
+      return new ArtNode256(std::move(prefix));
+    default:
+      UNREACHABLE("not an inner node type");
+  }
+}
+
+template <size_t N>
+auto FindSorted(ArtSortedNode<N> *node, uint8_t byte) -> ArtNode * {
+  auto count = std::min<size_t>(node->count_.load(std::memory_order_relaxed), N);
+  for (size_t i = 0; i < count; i++) {
+    if (node->keys_[i].load(std::memory_order_relaxed) == byte) {
+      return node->children_[i].load(std::memory_order_acquire);
+    }
+  }
+  return nullptr;
+}
+
+/** @return the child of `node` under `byte`, nullptr if there is none; only valid once `node` is validated */
+auto FindChild(ArtNode *node, uint8_t byte) -> ArtNode * {
+  switch (node->type_) {
+    case ArtNodeType::Node4:
+      return FindSorted(static_cast<ArtNode4 *>(node), byte);
+    case ArtNodeType::Node16:
+      return FindSorted(static_cast<ArtNode16 *>(node), byte);
+    case ArtNodeType::Node48: {
+      auto *node48 = static_cast<ArtNode48 *>(node);
+      auto slot = node48->child_index_[byte].load(std::memory_order_relaxed);
+      return slot == 0 ? nullptr : node48->children_[slot - 1].load(std::memory_order_acquire);
+    }
+    case ArtNodeType::Node256:
+      return static_cast<ArtNode256 *>(node)->children_[byte].load(std::memory_order_acquire);
+    default:
+      UNREACHABLE("leaves have no children");
+  }
+}
+
+/** Call `fn(byte, child)` for every child of `node` in byte order. Optimistic readers may see a nullptr child. */
+template <typename Fn>
+void ForEachChild(ArtNode *node, Fn &&fn) {
+  auto for_each_sorted = [&fn](auto *sorted) {
+    auto count = std::min(static_cast<size_t>(sorted->count_.load(std::memory_order_relaxed)), sorted->keys_.size());
+    for (size_t i = 0; i < count; i++) {
+      fn(sorted->keys_[i].load(std::memory_order_relaxed), sorted->children_[i].load(std::memory_order_acquire));
+    }
+  };
+  switch (node->type_) {
+    case ArtNodeType::Node4:
+      for_each_sorted(static_cast<ArtNode4 *>(node));
+      break;
+    case ArtNodeType::Node16:
+      for_each_sorted(static_cast<ArtNode16 *>(node));
+      break;
+    case ArtNodeType::Node48: {
+      auto *node48 = static_cast<ArtNode48 *>(node);
+      for (size_t byte = 0; byte < 256; byte++) {
+        auto slot = node48->child_index_[byte].load(std::memory_order_relaxed);
+        if (slot != 0) {
+          fn(static_cast<uint8_t>(byte), node48->children_[slot - 1].load(std::memory_order_acquire));
+        }
+      }
+      break;
+    }
+    case ArtNodeType::Node256: {
+      auto *node256 = static_cast<ArtNode256 *>(node);
+      for (size_t byte = 0; byte < 256; byte++) {
+        if (auto *child = node256->children_[byte].load(std::memory_order_acquire); child != nullptr) {
+          fn(static_cast<uint8_t>(byte), child);
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+/** Add a child under a byte `node` has no child for yet. The node must be write locked and not full. */
+void AddChild(ArtNode *node, uint8_t byte, ArtNode *child) {
+  auto add_sorted = [byte, child](auto *sorted) {
+    size_t count = sorted->count_.load(std::memory_order_relaxed);
+    size_t pos = 0;
+    while (pos < count && sorted->keys_[pos].load(std::memory_order_relaxed) < byte) {
+      pos++;
+    }
+    for (size_t i = count; i > pos; i--) {
+      sorted->keys_[i].store(sorted->keys_[i - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      sorted->children_[i].store(sorted->children_[i - 1].load(std::memory_order_relaxed), std::memory_order_release);
+    }
+    sorted->keys_[pos].store(byte, std::memory_order_relaxed);
+    sorted->children_[pos].store(child, std::memory_order_release);
+  };
+  switch (node->type_) {
+    case ArtNodeType::Node4:
+      add_sorted(static_cast<ArtNode4 *>(node));
+      break;
+    case ArtNodeType::Node16:
+      add_sorted(static_cast<ArtNode16 *>(node));
+      break;
+    case ArtNodeType::Node48: {
+      auto *node48 = static_cast<ArtNode48 *>(node);
+      size_t slot = 0;
+      while (node48->children_[slot].load(std::memory_order_relaxed) != nullptr) {
+        slot++;
+      }
+      node48->children_[slot].store(child, std::memory_order_release);
+      node48->child_index_[byte].store(static_cast<uint8_t>(slot + 1), std::memory_order_relaxed);
+      break;
+    }
+    case ArtNodeType::Node256:
+      static_cast<ArtNode256 *>(node)->children_[byte].store(child, std::memory_order_release);
+      break;
+    default:
+      UNREACHABLE("leaves have no children");
+  }
+  node->count_.store(node->count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/** Remove the child under `byte`. The node must be write locked. */
+void RemoveChild(ArtNode *node, uint8_t byte) {
+  auto remove_sorted = [byte](auto *sorted) {
+    size_t count = sorted->count_.load(std::memory_order_relaxed);
+    size_t pos = 0;
+    while (sorted->keys_[pos].load(std::memory_order_relaxed) != byte) {
+      pos++;
+    }
+    for (size_t i = pos + 1; i < count; i++) {
+      sorted->keys_[i - 1].store(sorted->keys_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      sorted->children_[i - 1].store(sorted->children_[i].load(std::memory_order_relaxed), std::memory_order_release);
+    }
+    sorted->children_[count - 1].store(nullptr, std::memory_order_relaxed);
+  };
+  switch (node->type_) {
+    case ArtNodeType::Node4:
+      remove_sorted(static_cast<ArtNode4 *>(node));
+      break;
+    case ArtNodeType::Node16:
+      remove_sorted(static_cast<ArtNode16 *>(node));
+      break;
+    case ArtNodeType::Node48: {
+      auto *node48 = static_cast<ArtNode48 *>(node);
+      auto slot = node48->child_index_[byte].load(std::memory_order_relaxed);
+      node48->child_index_[byte].store(0, std::memory_order_relaxed);
+      node48->children_[slot - 1].store(nullptr, std::memory_order_relaxed);
+      break;
+    }
+    case ArtNodeType::Node256:
+      static_cast<ArtNode256 *>(node)->children_[byte].store(nullptr, std::memory_order_relaxed);
+      break;
+    default:
+      UNREACHABLE("leaves have no children");
+  }
+  node->count_.store(node->count_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+}
+
+/** Point the existing child slot of `byte` at `child`. The node must be write locked. */
+void ReplaceChild(ArtNode *node, uint8_t byte, ArtNode *child) {
+  auto replace_sorted = [byte, child](auto *sorted) {
+    for (size_t i = 0;; i++) {
+      if (sorted->keys_[i].load(std::memory_order_relaxed) == byte) {
+        sorted->children_[i].store(child, std::memory_order_release);
+        return;
+      }
+    }
+  };
+  switch (node->type_) {
+    case ArtNodeType::Node4:
+      replace_sorted(static_cast<ArtNode4 *>(node));
+      break;
+    case ArtNodeType::Node16:
+      replace_sorted(static_cast<ArtNode16 *>(node));
+      break;
+    case ArtNodeType::Node48: {
+      auto *node48 = static_cast<ArtNode48 *>(node);
+      auto slot = node48->child_index_[byte].load(std::memory_order_relaxed);
+      node48->children_[slot - 1].store(child, std::memory_order_release);
+      break;
+    }
+    case ArtNodeType::Node256:
+      static_cast<ArtNode256 *>(node)->children_[byte].store(child, std::memory_order_release);
+      break;
+    default:
+      UNREACHABLE("leaves have no children");
+  }
+}
+
+/**
+ * @return a new node of `type` with `prefix` and the children of `node`, except the one under `skip`. The node must
+ * be write locked.
+ */
+auto CopyInner(ArtNode *node, ArtNodeType type, std::string prefix, std::optional<uint8_t> skip = std::nullopt)
+    -> ArtNode * {
+  auto *copy = NewInner(type, std::move(prefix));
+  ForEachChild(node, [copy, skip](uint8_t byte, ArtNode *child) {
+    if (byte != skip) {
+      AddChild(copy, byte, child);
+    }
+  });
+  return copy;
+}
+
+void FreeTree(ArtNode *node) {
+  ForEachChild(node, [](uint8_t byte, ArtNode *child) { FreeTree(child); });
+  delete node;
+}
+
+/** @return the number of bytes of `prefix` that `key` repeats from `depth` on */
+auto MatchPrefix(const std::string &prefix, const std::string &key, size_t depth) -> size_t {
+  size_t matched = 0;
+  while (matched < prefix.size() && depth + matched < key.size() && prefix[matched] == key[depth + matched]) {
+    matched++;
+  }
+  return matched;
+}
+
+/** Append the low `bytes` bytes of `bits`, most significant first, so that the bytes compare like the number. */
+void AppendBigEndian(uint64_t bits, size_t bytes, std::string *out) {
+  for (size_t i = bytes; i > 0; i--) {
+    out->push_back(static_cast<char>(bits >> ((i - 1) * 8)));
+  }
+}
+
+/** Append a signed integer of `bytes` bytes with the sign bit flipped, which puts negative numbers first. */
+void AppendSigned(int64_t value, size_t bytes, std::string *out) {
+  AppendBigEndian(static_cast<uint64_t>(value) ^ (uint64_t{1} << (bytes * 8 - 1)), bytes, out);
+}
+
+/**
+ * Append the encoding of `value`: a byte that puts NULL before everything else, then bytes that compare like the
+ * value. No encoding is a prefix of another one of the same type, so neither is a key of fixed-schema columns.
+ */
+void AppendValue(const Value &value, std::string *out) {
+  if (value.IsNull()) {
+    out->push_back('\0');
+    return;
+  }
+  out->push_back('\1');
+  switch (value.GetTypeId()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      AppendSigned(value.GetAs<int8_t>(), sizeof(int8_t), out);
+      break;
+    case TypeId::SMALLINT:
+      AppendSigned(value.GetAs<int16_t>(), sizeof(int16_t), out);
+      break;
+    case TypeId::INTEGER:
+      AppendSigned(value.GetAs<int32_t>(), sizeof(int32_t), out);
+      break;
+    case TypeId::BIGINT:
+      AppendSigned(value.GetAs<int64_t>(), sizeof(int64_t), out);
+      break;
+    case TypeId::TIMESTAMP:
+      AppendBigEndian(value.GetAs<uint64_t>(), sizeof(uint64_t), out);
+      break;
+    case TypeId::DECIMAL: {
+      uint64_t bits;
+      auto decimal = value.GetAs<double>();
+      std::memcpy(&bits, &decimal, sizeof(bits));
+      // positive numbers go above the negative ones, which count down as their magnitude grows
+      bits = (bits >> 63) != 0 ? ~bits : bits | (uint64_t{1} << 63);
+      AppendBigEndian(bits, sizeof(uint64_t), out);
+      break;
+    }
+    case TypeId::VARCHAR: {
+      // a zero byte is escaped as 0x00 0xff, and two zero bytes end the string, which sorts it before its extensions
+      const char *data = value.GetData();
+      for (uint32_t i = 0; i + 1 < value.GetLength(); i++) {
+        out->push_back(data[i]);
+        if (data[i] == '\0') {
+          out->push_back('\xff');
+        }
+      }
+      out->append(2, '\0');
+      break;
+    }
+    default:
+      throw NotImplementedException("art index does not support this key type");
+  }
+}
+
+void AppendRID(RID rid, std::string *out) { AppendBigEndian(static_cast<uint64_t>(rid.Get()), sizeof(int64_t), out); }
+
+/** How many of the keys under a path satisfy one bound. */
+enum class Coverage { None, Some, All };
+
+/**
+ * @param path bytes every key in question starts with
+ * @param is_key whether `path` is a whole key rather than the path to a subtree
+ */
+auto CoverLow(const std::string &path, const std::string &low, bool inclusive, bool is_key) -> Coverage {
+  auto common = std::min(path.size(), low.size());
+  if (auto cmp = path.compare(0, common, low, 0, common); cmp != 0) {
+    return cmp < 0 ? Coverage::None : Coverage::All;
+  }
+  if (path.size() < low.size()) {
+    // a key that is a proper prefix of the bound sorts below it
+    return is_key ? Coverage::None : Coverage::Some;
+  }
+  return inclusive ? Coverage::All : Coverage::None;
+}
+
+auto CoverHigh(const std::string &path, const std::string &high, bool inclusive, bool is_key) -> Coverage {
+  auto common = std::min(path.size(), high.size());
+  if (auto cmp = path.compare(0, common, high, 0, common); cmp != 0) {
+    return cmp < 0 ? Coverage::All : Coverage::None;
+  }
+  if (path.size() < high.size()) {
+    return is_key ? Coverage::All : Coverage::Some;
+  }
+  return inclusive ? Coverage::All : Coverage::None;
+}
+
+/** @return whether `value` lies within the bounds of `range` */
+auto InRange(const Value &value, const IndexKeyRange &range) -> bool {
+  if (range.low_.has_value()) {
+    auto above = range.low_inclusive_ ? value.CompareGreaterThanEquals(*range.low_)
+                                      : value.CompareGreaterThan(*range.low_);
+    if (above != CmpBool::CmpTrue) {
+      return false;
+    }
+  }
+  if (range.high_.has_value()) {
+    auto below = range.high_inclusive_ ? value.CompareLessThanEquals(*range.high_)
+                                       : value.CompareLessThan(*range.high_);
+    if (below != CmpBool::CmpTrue) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+ArtIndexCursor::ArtIndexCursor(ArtIndex *index, ArtIndex::ByteRange bytes, std::optional<IndexKeyRange> value_range,
+                               bool descending)
+    : index_(index), bytes_(std::move(bytes)), value_range_(std::move(value_range)), descending_(descending) {
+  Fill();
+}
+
+auto ArtIndexCursor::GetKeyValues() -> std::vector<Value> {
+  auto *key_schema = index_->GetKeySchema();
+  std::vector<Value> values;
+  values.reserve(key_schema->GetColumnCount());
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    values.push_back(entries_[pos_].first.GetValue(key_schema, i));
+  }
+  return values;
+}
+
+void ArtIndexCursor::Next() {
+  if (++pos_ == entries_.size()) {
+    Fill();
+  }
+}
+
+void ArtIndexCursor::Fill() {
+  entries_.clear();
+  pos_ = 0;
+  while (entries_.empty() && !exhausted_) {
+    ArtIndex::EpochGuard guard(index_);
+    auto leaves = index_->CollectRange(bytes_, descending_, FILL_SIZE);
+    exhausted_ = leaves.size() < FILL_SIZE;
+    for (const auto *leaf : leaves) {
+      if (!value_range_.has_value() || InRange(leaf->tuple_.GetValue(index_->GetKeySchema(), 0), *value_range_)) {
+        entries_.emplace_back(leaf->tuple_, leaf->rid_);
+      }
+    }
+    if (leaves.empty()) {
+      break;
+    }
+    // no key is a prefix of another, so an exclusive bound at the last key rules out just that key
+    if (descending_) {
+      bytes_.high_ = leaves.back()->key_;
+      bytes_.high_inclusive_ = false;
+    } else {
+      bytes_.low_ = leaves.back()->key_;
+      bytes_.low_inclusive_ = false;
+    }
+  }
+}
+
+ArtIndex::EpochGuard::EpochGuard(ArtIndex *index) {
+  auto start = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  for (size_t i = 0;; i++) {
+    auto &slot = index->active_epochs_[(start + i) % EPOCH_SLOTS];
+    uint64_t expected = 0;
+    if (slot.compare_exchange_strong(expected, index->global_epoch_.load())) {
+      slot_ = &slot;
+      return;
+    }
+    if (i % EPOCH_SLOTS == EPOCH_SLOTS - 1) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+ArtIndex::EpochGuard::~EpochGuard() { slot_->store(0); }
+
+ArtIndex::ArtIndex(std::unique_ptr<IndexMetadata> &&metadata)
+    : Index(std::move(metadata)), root_(NewInner(ArtNodeType::Node256, "")) {}
+
+ArtIndex::~ArtIndex() {
+  FreeTree(root_);
+  for (auto &[epoch, node] : retired_) {
+    delete node;
+  }
+}
+
+void ArtIndex::Retire(ArtNode *node) {
+  std::scoped_lock guard(retired_latch_);
+  retired_.emplace_back(global_epoch_.load(), node);
+  if (retired_.size() < next_reclaim_at_) {
+    return;
+  }
+  // a node unlinked before the oldest running operation started cannot be reached by any of them
+  auto oldest = global_epoch_.fetch_add(1) + 1;
+  for (const auto &slot : active_epochs_) {
+    if (auto epoch = slot.load(); epoch != 0) {
+      oldest = std::min(oldest, epoch);
+    }
+  }
+  auto reclaimable = std::partition(retired_.begin(), retired_.end(),
+                                    [oldest](const auto &retired) { return retired.first >= oldest; });
+  for (auto iter = reclaimable; iter != retired_.end(); ++iter) {
+    delete iter->second;
+  }
+  retired_.erase(reclaimable, retired_.end());
+  next_reclaim_at_ = std::max(RECLAIM_THRESHOLD, retired_.size() * 2);
+}
+
+auto ArtIndex::EncodeKey(const Tuple &key) const -> std::string {
+  std::string bytes;
+  auto *key_schema = GetKeySchema();
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    AppendValue(key.GetValue(key_schema, i), &bytes);
+  }
+  return bytes;
+}
+
+auto ArtIndex::TryInsert(const std::string &key, const Tuple &tuple, RID rid) -> std::optional<bool> {
+  ArtNode *parent = nullptr;
+  uint64_t parent_version = 0;
+  uint8_t parent_byte = 0;
+  ArtNode *node = root_;
+  uint64_t version;
+  if (!ReadLock(node, &version)) {
+    return std::nullopt;
+  }
+  size_t depth = 0;
+  while (true) {
+    const auto &prefix = node->prefix_;
+    auto matched = MatchPrefix(prefix, key, depth);
+    if (matched < prefix.size()) {
+      // the key leaves the compressed path of `node`: a Node4 above it holds both at the byte where they differ
+      BUSTUB_ASSERT(parent != nullptr && depth + matched < key.size(), "the root has no prefix, keys are prefix-free");
+      if (!Upgrade(parent, parent_version)) {
+        return std::nullopt;
+      }
+      if (!Upgrade(node, version)) {
+        WriteUnlock(parent);
+        return std::nullopt;
+      }
+      auto *split = NewInner(ArtNodeType::Node4, prefix.substr(0, matched));
+      AddChild(split, prefix[matched], CopyInner(node, node->type_, prefix.substr(matched + 1)));
+      AddChild(split, key[depth + matched], new ArtLeaf(key, tuple, rid));
+      ReplaceChild(parent, parent_byte, split);
+      WriteUnlock(parent);
+      WriteUnlockObsolete(node);
+      Retire(node);
+      return true;
+    }
+    depth += prefix.size();
+    BUSTUB_ASSERT(depth < key.size(), "keys are prefix-free");
+    auto byte = static_cast<uint8_t>(key[depth]);
+    auto *next = FindChild(node, byte);
+    if (!Validate(node, version)) {
+      return std::nullopt;
+    }
+
+    if (next == nullptr) {
+      if (node->count_.load(std::memory_order_relaxed) < Capacity(node->type_)) {
+        if (!Upgrade(node, version)) {
+          return std::nullopt;
+        }
+        AddChild(node, byte, new ArtLeaf(key, tuple, rid));
+        WriteUnlock(node);
+        return true;
+      }
+      // a full node is replaced by a larger copy
+      BUSTUB_ASSERT(parent != nullptr, "the root is a Node256");
+      if (!Upgrade(parent, parent_version)) {
+        return std::nullopt;
+      }
+      if (!Upgrade(node, version)) {
+        WriteUnlock(parent);
+        return std::nullopt;
+      }
+      auto *grown = CopyInner(node, Grown(node->type_), prefix);
+      AddChild(grown, byte, new ArtLeaf(key, tuple, rid));
+      ReplaceChild(parent, parent_byte, grown);
+      WriteUnlock(parent);
+      WriteUnlockObsolete(node);
+      Retire(node);
+      return true;
+    }
+
+    if (next->type_ == ArtNodeType::Leaf) {
+      auto *leaf = static_cast<ArtLeaf *>(next);
+      if (leaf->key_ == key) {
+        return false;
+      }
+      // the two keys share the bytes up to where they differ, a Node4 with that prefix takes the place of the leaf
+      if (!Upgrade(node, version)) {
+        return std::nullopt;
+      }
+      auto common = MatchPrefix(leaf->key_.substr(depth + 1), key, depth + 1);
+      auto *split = NewInner(ArtNodeType::Node4, key.substr(depth + 1, common));
+      AddChild(split, leaf->key_[depth + 1 + common], leaf);
+      AddChild(split, key[depth + 1 + common], new ArtLeaf(key, tuple, rid));
+      ReplaceChild(node, byte, split);
+      WriteUnlock(node);
+      return true;
+    }
+
+    parent = node;
+    parent_version = version;
+    parent_byte = byte;
+    node = next;
+    if (!ReadLock(node, &version) || !Validate(parent, parent_version)) {
+      return std::nullopt;
+    }
+    depth++;
+  }
+}
+
+auto ArtIndex::TryRemove(const std::string &key) -> std::optional<bool> {
+  ArtNode *parent = nullptr;
+  uint64_t parent_version = 0;
+  uint8_t parent_byte = 0;
+  ArtNode *node = root_;
+  uint64_t version;
+  if (!ReadLock(node, &version)) {
+    return std::nullopt;
+  }
+  size_t depth = 0;
+  while (true) {
+    const auto &prefix = node->prefix_;
+    if (MatchPrefix(prefix, key, depth) < prefix.size() || depth + prefix.size() >= key.size()) {
+      return false;
+    }
+    depth += prefix.size();
+    auto byte = static_cast<uint8_t>(key[depth]);
+    auto *next = FindChild(node, byte);
+    size_t count = node->count_.load(std::memory_order_relaxed);
+    if (!Validate(node, version)) {
+      return std::nullopt;
+    }
+    if (next == nullptr) {
+      return false;
+    }
+
+    if (next->type_ == ArtNodeType::Leaf) {
+      auto *leaf = static_cast<ArtLeaf *>(next);
+      if (leaf->key_ != key) {
+        return false;
+      }
+      if (node == root_ || (node->type_ != ArtNodeType::Node4 && !ShouldShrink(node->type_, count))) {
+        if (!Upgrade(node, version)) {
+          return std::nullopt;
+        }
+        RemoveChild(node, byte);
+        WriteUnlock(node);
+        Retire(leaf);
+        return true;
+      }
+      if (node->type_ == ArtNodeType::Node4 && count > 2) {
+        if (!Upgrade(node, version)) {
+          return std::nullopt;
+        }
+        RemoveChild(node, byte);
+        WriteUnlock(node);
+        Retire(leaf);
+        return true;
+      }
+
+      // the node is replaced, either by a smaller copy or, if only one child is left, by that child
+      if (!Upgrade(parent, parent_version)) {
+        return std::nullopt;
+      }
+      if (!Upgrade(node, version)) {
+        WriteUnlock(parent);
+        return std::nullopt;
+      }
+      ArtNode *replacement;
+      ArtNode *merged_sibling = nullptr;
+      if (node->type_ != ArtNodeType::Node4) {
+        replacement = CopyInner(node, Shrunk(node->type_), prefix, byte);
+      } else {
+        auto *node4 = static_cast<ArtNode4 *>(node);
+        size_t other = node4->keys_[0].load(std::memory_order_relaxed) == byte ? 1 : 0;
+        auto sibling_byte = node4->keys_[other].load(std::memory_order_relaxed);
+        auto *sibling = node4->children_[other].load(std::memory_order_relaxed);
+        replacement = sibling;
+        if (sibling->type_ != ArtNodeType::Leaf) {
+          // the sibling moves up a level, so the path through `node` becomes part of its prefix
+          uint64_t sibling_version;
+          if (!ReadLock(sibling, &sibling_version) || !Upgrade(sibling, sibling_version)) {
+            WriteUnlock(node);
+            WriteUnlock(parent);
+            return std::nullopt;
+          }
+          replacement = CopyInner(sibling, sibling->type_,
+                                  prefix + static_cast<char>(sibling_byte) + sibling->prefix_);
+          merged_sibling = sibling;
+        }
+      }
+      ReplaceChild(parent, parent_byte, replacement);
+      WriteUnlock(parent);
+      WriteUnlockObsolete(node);
+      if (merged_sibling != nullptr) {
+        WriteUnlockObsolete(merged_sibling);
+        Retire(merged_sibling);
+      }
+      Retire(node);
+      Retire(leaf);
+      return true;
+    }
+
+    parent = node;
+    parent_version = version;
+    parent_byte = byte;
+    node = next;
+    if (!ReadLock(node, &version) || !Validate(parent, parent_version)) {
+      return std::nullopt;
+    }
+    depth++;
+  }
+}
+
+auto ArtIndex::TryLookup(const std::string &key, RID *rid) -> std::optional<bool> {
+  ArtNode *node = root_;
+  uint64_t version;
+  if (!ReadLock(node, &version)) {
+    return std::nullopt;
+  }
+  size_t depth = 0;
+  while (true) {
+    const auto &prefix = node->prefix_;
+    if (MatchPrefix(prefix, key, depth) < prefix.size() || depth + prefix.size() >= key.size()) {
+      return false;
+    }
+    depth += prefix.size();
+    auto *next = FindChild(node, static_cast<uint8_t>(key[depth]));
+    if (!Validate(node, version)) {
+      return std::nullopt;
+    }
+    if (next == nullptr) {
+      return false;
+    }
+    if (next->type_ == ArtNodeType::Leaf) {
+      auto *leaf = static_cast<ArtLeaf *>(next);
+      if (leaf->key_ != key) {
+        return false;
+      }
+      *rid = leaf->rid_;
+      return true;
+    }
+    auto *parent = node;
+    auto parent_version = version;
+    node = next;
+    if (!ReadLock(node, &version) || !Validate(parent, parent_version)) {
+      return std::nullopt;
+    }
+    depth++;
+  }
+}
+
+auto ArtIndex::TryCollect(ArtNode *node, uint64_t version, std::string *path, const ByteRange &range,
+                          bool low_checked, bool high_checked, bool descending, size_t limit,
+                          std::vector<const ArtLeaf *> *leaves, bool *done) -> bool {
+  std::vector<std::pair<uint8_t, ArtNode *>> children;
+  ForEachChild(node, [&children](uint8_t byte, ArtNode *child) {
+    if (child != nullptr) {
+      children.emplace_back(byte, child);
+    }
+  });
+  if (!Validate(node, version)) {
+    return false;
+  }
+  if (descending) {
+    std::reverse(children.begin(), children.end());
+  }
+  for (auto [byte, child] : children) {
+    if (child->type_ == ArtNodeType::Leaf) {
+      const auto *leaf = static_cast<const ArtLeaf *>(child);
+      auto low = low_checked ? Coverage::All : CoverLow(leaf->key_, *range.low_, range.low_inclusive_, true);
+      auto high = high_checked ? Coverage::All : CoverHigh(leaf->key_, *range.high_, range.high_inclusive_, true);
+      if ((descending ? low : high) == Coverage::None) {
+        *done = true;
+        return true;
+      }
+      if (low == Coverage::All && high == Coverage::All) {
+        leaves->push_back(leaf);
+        if (leaves->size() == limit) {
+          *done = true;
+          return true;
+        }
+      }
+      continue;
+    }
+
+    uint64_t child_version;
+    if (!ReadLock(child, &child_version) || !Validate(node, version)) {
+      return false;
+    }
+    auto path_size = path->size();
+    path->push_back(static_cast<char>(byte));
+    path->append(child->prefix_);
+    auto low = low_checked ? Coverage::All : CoverLow(*path, *range.low_, range.low_inclusive_, false);
+    auto high = high_checked ? Coverage::All : CoverHigh(*path, *range.high_, range.high_inclusive_, false);
+    bool consistent = true;
+    if ((descending ? low : high) == Coverage::None) {
+      // keys are visited in order, everything after this subtree is past the range as well
+      *done = true;
+    } else if ((descending ? high : low) != Coverage::None) {
+      consistent = TryCollect(child, child_version, path, range, low == Coverage::All, high == Coverage::All,
+                              descending, limit, leaves, done);
+    }
+    path->resize(path_size);
+    if (!consistent || *done) {
+      return consistent;
+    }
+  }
+  return true;
+}
+
+auto ArtIndex::CollectRange(const ByteRange &range, bool descending, size_t limit) -> std::vector<const ArtLeaf *> {
+  std::vector<const ArtLeaf *> leaves;
+  while (true) {
+    uint64_t version;
+    if (!ReadLock(root_, &version)) {
+      continue;
+    }
+    std::string path;
+    bool done = false;
+    leaves.clear();
+    if (TryCollect(root_, version, &path, range, !range.low_.has_value(), !range.high_.has_value(), descending, limit,
+                   &leaves, &done)) {
+      return leaves;
+    }
+  }
+}
+
+auto ArtIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  auto bytes = EncodeKey(key);
+  if (!IsUnique()) {
+    AppendRID(rid, &bytes);
+  }
+  EpochGuard guard(this);
+  while (true) {
+    if (auto inserted = TryInsert(bytes, key, rid); inserted.has_value()) {
+      return *inserted;
+    }
+  }
+}
+
+void ArtIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  auto bytes = EncodeKey(key);
+  if (!IsUnique()) {
+    AppendRID(rid, &bytes);
+  }
+  EpochGuard guard(this);
+  while (!TryRemove(bytes).has_value()) {
+  }
+}
+
+void ArtIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  auto bytes = EncodeKey(key);
+  EpochGuard guard(this);
+  if (IsUnique()) {
+    RID rid;
+    std::optional<bool> found;
+    while (!(found = TryLookup(bytes, &rid)).has_value()) {
+    }
+    if (*found) {
+      result->push_back(rid);
+    }
+    return;
+  }
+  // the entries of a non-unique index are the key followed by the RID, all of them start with the key
+  for (const auto *leaf : CollectRange({bytes, true, bytes, true})) {
+    result->push_back(leaf->rid_);
+  }
+}
+
+auto ArtIndex::ScanRange(const IndexKeyRange &range, bool descending) -> std::unique_ptr<IndexScanCursor> {
+  auto *key_schema = GetKeySchema();
+  auto column_type = key_schema->GetColumn(0).GetType();
+  ByteRange bytes;
+  // a bound of another type is encoded differently than the column, such bounds are checked on the key values
+  bool check_values = false;
+  if (range.low_.has_value() && range.low_->GetTypeId() == column_type) {
+    bytes.low_.emplace();
+    AppendValue(*range.low_, &*bytes.low_);
+    bytes.low_inclusive_ = range.low_inclusive_;
+  } else if (range.low_.has_value() || range.high_.has_value()) {
+    // NULL keys sort first but are in no bounded range
+    bytes.low_ = "\1";
+    check_values = range.low_.has_value();
+  }
+  if (range.high_.has_value() && range.high_->GetTypeId() == column_type) {
+    bytes.high_.emplace();
+    AppendValue(*range.high_, &*bytes.high_);
+    bytes.high_inclusive_ = range.high_inclusive_;
+  } else if (range.high_.has_value()) {
+    check_values = true;
+  }
+
+  auto value_range = check_values ? std::make_optional(range) : std::nullopt;
+  return std::make_unique<ArtIndexCursor>(this, std::move(bytes), std::move(value_range), descending);
+}
+
+}  // namespace bustub
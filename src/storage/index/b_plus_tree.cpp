@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <deque>
 #include <iostream>
+#include <numeric>
 #include <ostream>
 #include <random>
 #include <sstream>
@@ -27,8 +29,8 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
     : index_name_(std::move(name)),
       bpm_(buffer_pool_manager),
       comparator_(std::move(comparator)),
-      leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size),
+      leaf_max_size_(std::min<int>(leaf_max_size, LEAF_PAGE_MAX_SIZE)),
+      internal_max_size_(std::min<int>(internal_max_size, INTERNAL_PAGE_MAX_SIZE)),
       header_page_id_(header_page_id) {
   WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
   auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
@@ -46,19 +48,9 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::CompareAndGetPageId(BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *internal,
+auto BPLUSTREE_TYPE::CompareAndGetPageId(const BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *internal,
                                          const KeyType &key) -> page_id_t {
-  // For simplicity i use linear search, to get max performance consider binary search
-  if (comparator_(key, internal->KeyAt(1)) < 0) {
-    return internal->ValueAt(0);
-  }
-  int start = 1;
-  for (; start + 1 < internal->GetSize(); start++) {
-    if (comparator_(key, internal->KeyAt(start + 1)) < 0) {
-      break;
-    }
-  }
-  return internal->ValueAt(start);
+  return internal->ValueAt(internal->LookupChildIndex(key, comparator_));
 }
 /*****************************************************************************
  * SEARCH
@@ -101,6 +93,45 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   // return false;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *result,
+                               Transaction *txn) {
+  result->assign(keys.size(), {});
+  ReadPageGuard readpageguard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = readpageguard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID || keys.empty()) {
+    return;
+  }
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t lhs, size_t rhs) { return comparator_(keys[lhs], keys[rhs]) < 0; });
+
+  // latched pages from the root down, each with the separator bounding its subtree from above (none on the right
+  // edge of the tree); the root stays latched for the whole batch so it cannot be replaced underneath us
+  std::vector<std::pair<ReadPageGuard, std::optional<KeyType>>> path;
+  path.emplace_back(bpm_->FetchPageRead(page_id), std::nullopt);
+  readpageguard.Drop();
+  for (auto i : order) {
+    const auto &key = keys[i];
+    // keys only grow, so climb until the page's subtree reaches far enough to the right
+    while (path.size() > 1 && path.back().second.has_value() && comparator_(key, *path.back().second) >= 0) {
+      path.pop_back();
+    }
+    while (!path.back().first.template As<BPlusTreePage>()->IsLeafPage()) {
+      auto *internal_page = path.back().first.template As<InternalPage>();
+      int index = internal_page->LookupChildIndex(key, comparator_);
+      auto upper = index + 1 < internal_page->GetSize() ? std::make_optional(internal_page->KeyAt(index + 1))
+                                                         : path.back().second;
+      path.emplace_back(bpm_->FetchPageRead(internal_page->ValueAt(index)), upper);
+    }
+    ValueType val;
+    if (path.back().first.template As<LeafPage>()->FindValue(key, &val, comparator_)) {
+      (*result)[i].push_back(val);
+    }
+  }
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -112,9 +143,41 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * keys return false, otherwise return true.
  */
 
+/*
+ * Optimistic descent shared by Insert and Remove: inner pages are only read-latched and the parent latch is released
+ * as soon as the child is latched. The leaf is write-latched while its parent is still read-latched, nobody can split
+ * or merge it in between since that needs the parent write latch.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafOptimistic(const KeyType &key) -> std::optional<WritePageGuard> {
+  ReadPageGuard parent_guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = parent_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return std::nullopt;
+  }
+  while (true) {
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+      guard.Drop();
+      return bpm_->FetchPageWrite(page_id);
+    }
+    page_id = CompareAndGetPageId(guard.As<InternalPage>(), key);
+    parent_guard = std::move(guard);
+  }
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
-  // Declaration of context instance.
+  // Optimistic pass: most inserts do not split the leaf, so they only need the leaf write latch.
+  if (std::optional<WritePageGuard> leaf_guard = FindLeafOptimistic(key); leaf_guard.has_value()) {
+    auto *leaf = leaf_guard->AsMut<LeafPage>();
+    if (leaf->GetSize() > 0 && leaf->GetSize() + 1 < leaf->GetMaxSize() && leaf->HasRoomFor(key)) {
+      Context ctx;
+      return InsertIntoNode(leaf, leaf_guard->PageId(), key, value, txn, &ctx);
+    }
+  }
+
+  // Pessimistic pass, restart from the header with write latches.
   Context ctx;
   WritePageGuard headerwg = bpm_->FetchPageWrite(header_page_id_);
   auto headpage = headerwg.AsMut<BPlusTreeHeaderPage>();
@@ -139,11 +202,117 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   return FindLeafNode(headpage->root_page_id_, key, value, txn, &ctx);
 }
 
+/*
+ * Bulk loading: sort the entries, cut them into leaves of the target size and then build every inner level from the
+ * separators in front of the pages of the level below, until a single root is left. Pages of a level get an even
+ * share of the entries so the last one is never left nearly empty; a page whose keys compress badly takes fewer and
+ * leaves the rest to the pages after it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> entries, double fill_factor) -> bool {
+  WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  auto *header = header_guard.AsMut<BPlusTreeHeaderPage>();
+  if (header->root_page_id_ != INVALID_PAGE_ID) {
+    return false;
+  }
+  if (entries.empty()) {
+    return true;
+  }
+
+  std::stable_sort(entries.begin(), entries.end(),
+                   [this](const auto &lhs, const auto &rhs) { return comparator_(lhs.first, rhs.first) < 0; });
+  // the sort is stable, so the first of equal keys is the one that came first
+  size_t unique_cnt = 0;
+  for (auto &entry : entries) {
+    if (unique_cnt == 0 || comparator_(entries[unique_cnt - 1].first, entry.first) != 0) {
+      entries[unique_cnt++] = entry;
+    }
+  }
+  entries.resize(unique_cnt);
+
+  // number of pages for `count` items at `fill` items per page, a page never gets more than `capacity`
+  auto page_count = [](size_t count, int fill, int capacity, int min_items) -> size_t {
+    size_t pages = (count + fill - 1) / fill;
+    size_t fewer = std::max<size_t>(1, count / min_items);
+    if (fewer < pages && (count + fewer - 1) / fewer <= static_cast<size_t>(capacity)) {
+      pages = fewer;
+    }
+    return pages;
+  };
+  auto target_fill = [fill_factor](int capacity, int min_items) {
+    min_items = std::min(min_items, capacity);
+    return std::clamp(static_cast<int>(capacity * fill_factor), min_items, capacity);
+  };
+  auto new_page = [this](page_id_t *page_id) {
+    BasicPageGuard guard = bpm_->NewPageGuarded(page_id);
+    if (*page_id == INVALID_PAGE_ID) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate page for bulk loading");
+    }
+    return guard;
+  };
+
+  // leaves, a leaf is split as soon as it reaches its max size so it holds at most max - 1 entries
+  int leaf_capacity = std::max(leaf_max_size_ - 1, 1);
+  int leaf_fill = target_fill(leaf_capacity, std::max(leaf_max_size_ / 2, 1));
+  size_t leaf_cnt = page_count(entries.size(), leaf_fill, leaf_capacity, 1);
+  // each page with the separator in front of it, which is not used for the first page of a level
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  BasicPageGuard prev_guard;
+  size_t pos = 0;
+  for (size_t i = 0; pos < entries.size(); i++) {
+    size_t pages_left = i < leaf_cnt ? leaf_cnt - i : 1;
+    size_t cnt = (entries.size() - pos + pages_left - 1) / pages_left;
+    page_id_t page_id;
+    BasicPageGuard guard = new_page(&page_id);
+    auto *leaf = guard.AsMut<LeafPage>();
+    leaf->Init(leaf_max_size_);
+    for (size_t j = 0; j < cnt && leaf->HasRoomFor(entries[pos + j].first); j++) {
+      leaf->InsertValueAt(entries[pos + j].first, entries[pos + j].second, j);
+    }
+    if (i > 0) {
+      prev_guard.AsMut<LeafPage>()->SetNextPageId(page_id);
+    }
+    level.emplace_back(pos > 0 ? Separator(entries[pos - 1].first, entries[pos].first) : entries[pos].first, page_id);
+    pos += leaf->GetSize();
+    prev_guard = std::move(guard);
+  }
+  prev_guard.Drop();
+
+  // inner levels, an internal page holds up to max size children
+  int internal_fill = target_fill(internal_max_size_, std::max(internal_max_size_ / 2, 2));
+  while (level.size() > 1) {
+    size_t node_cnt = page_count(level.size(), internal_fill, internal_max_size_, 2);
+    std::vector<std::pair<KeyType, page_id_t>> parents;
+    pos = 0;
+    for (size_t i = 0; pos < level.size(); i++) {
+      size_t pages_left = i < node_cnt ? node_cnt - i : 1;
+      size_t cnt = (level.size() - pos + pages_left - 1) / pages_left;
+      page_id_t page_id;
+      BasicPageGuard guard = new_page(&page_id);
+      auto *internal = guard.AsMut<InternalPage>();
+      internal->Init(internal_max_size_);
+      // the separator in front of the first child moves up to the parent
+      internal->InsertValueAt(level[pos].first, level[pos].second, 0);
+      for (size_t j = 1; j < cnt && internal->HasRoomFor(level[pos + j].first); j++) {
+        internal->InsertValueAt(level[pos + j].first, level[pos + j].second, j);
+      }
+      parents.emplace_back(level[pos].first, page_id);
+      pos += internal->GetSize();
+    }
+    level = std::move(parents);
+  }
+  header->root_page_id_ = level[0].second;
+  return true;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::FindLeafNode(page_id_t page_id, const KeyType &key, const ValueType &value, Transaction *txn,
                                   Context *ctx) -> bool {
   WritePageGuard basic_wg = bpm_->FetchPageWrite(page_id);
   auto basic_page = basic_wg.AsMut<BPlusTreePage>();
+  if (IsSafeForInsert(basic_page, key)) {
+    ctx->ReleaseAncestors();
+  }
   if (!basic_page->IsLeafPage()) {
     page_id_t next_level = CompareAndGetPageId(
         reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(basic_page), key);
@@ -164,56 +333,44 @@ auto BPLUSTREE_TYPE::FindLeafNode(page_id_t page_id, const KeyType &key, const V
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::InsertIntoNode(LeafPage *leaf, page_id_t leaf_id, const KeyType &key, const ValueType &value,
                                     Transaction *txn, Context *ctx) -> bool {
-  int insert_index = -1;
-  for (int i = 0; i < leaf->GetSize(); i++) {
-    if (comparator_(key, leaf->KeyAt(i)) < 0) {
-      insert_index = i;
-      break;
-    }
-    if (comparator_(key, leaf->KeyAt(i)) == 0) {
-      leaf->SetValueAt(i, value);
+  auto findval = leaf->FindValueIndex(key, comparator_);
+  // a duplicate key leaves the value already stored
+  if (findval.second) {
+    return false;
+  }
+  int insert_index = findval.first;
+  BasicPageGuard buddy_guard;
+  page_id_t buddy_id = INVALID_PAGE_ID;
+  if (!leaf->HasRoomFor(key)) {
+    // The key does not fit into the leaf the way it compresses, split first; either half has room for it
+    buddy_id = DivideLeafNode(leaf, &buddy_guard);
+    if (buddy_id == INVALID_PAGE_ID) {
       return false;
     }
-  }
-  if (insert_index == -1) {
-    insert_index = leaf->GetSize();
-  }
-  int index = leaf->GetSize();
-  while (index > insert_index) {
-    leaf->SetKeyAt(index, leaf->KeyAt(index - 1));
-    leaf->SetValueAt(index, leaf->ValueAt(index - 1));
-    index--;
-  }
-  if (insert_index == 0) {
-    // The key is same as the first key, the situation should never occur in normal case
-    const KeyType &origin = leaf->KeyAt(0);
-    leaf->SetKeyAt(0, key);
-    leaf->SetValueAt(0, value);
-    // std::cout << "replace " << origin << " with " << leaf->KeyAt(0) << " id is:" << leaf_id << std::endl;
-    ReplaceParentKey(origin, leaf->KeyAt(0), leaf_id, ctx);
+    if (insert_index < leaf->GetSize()) {
+      leaf->InsertValueAt(key, value, insert_index);
+    } else {
+      buddy_guard.AsMut<LeafPage>()->InsertValueAt(key, value, insert_index - leaf->GetSize());
+    }
   } else {
-    leaf->SetKeyAt(insert_index, key);
-    leaf->SetValueAt(insert_index, value);
-  }
-  leaf->SetSize(leaf->GetSize() + 1);
-  if (leaf->GetSize() < leaf->GetMaxSize()) {
-    return true;
+    leaf->InsertValueAt(key, value, insert_index);
+    if (leaf->GetSize() < leaf->GetMaxSize()) {
+      return true;
+    }
+    // The leaf Node is already full, in this case we should coallpse the node first
+    buddy_id = DivideLeafNode(leaf, &buddy_guard);
+    if (buddy_id == INVALID_PAGE_ID) {
+      return false;
+    }
   }
 
-  // std::cout << "insert key is " << key << std::endl;
-  // The leaf Node is already full, in this case we should coallpse the node first
-  BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *buddy;
-  page_id_t buddy_id = DivideLeafNode(leaf, &buddy);
-  if (buddy_id == INVALID_PAGE_ID) {
-    return false;
-  }
-  const KeyType &key_to_insert = buddy->KeyAt(0);
+  KeyType separator = Separator(leaf->KeyAt(leaf->GetSize() - 1), buddy_guard.As<LeafPage>()->KeyAt(0));
   if (ctx->write_set_.empty()) {
     // std::cout<<"No more parent to insert, this case you should allocate a new page to become root"<<std::endl;
-    MakeNewRootNode(leaf_id, buddy_id, leaf->KeyAt(0), key_to_insert, ctx);
+    MakeNewRootNode(leaf_id, buddy_id, separator, ctx);
   } else {
     // std::cout<<"insert into internal node"<<std::endl;
-    InsertKeyToInternalNode(key_to_insert, buddy_id, ctx);
+    InsertKeyToInternalNode(separator, buddy_id, ctx);
   }
   return true;
 }
@@ -223,106 +380,67 @@ void BPLUSTREE_TYPE::InsertKeyToInternalNode(const KeyType &key, page_id_t value
   WritePageGuard guard = std::move(ctx->write_set_.back());
   ctx->write_set_.pop_back();
   auto *internal = guard.AsMut<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-  if (internal->GetSize() < internal->GetMaxSize()) {
-    // In this case, Simply insert(k, v) into the node
-    int index = internal->GetSize();
-    while (index > 0) {
-      if (comparator_(key, internal->KeyAt(index - 1)) > 0) {
-        internal->SetKeyAt(index, key);
-        internal->SetValueAt(index, value);
-        break;
-      }
-      if (comparator_(key, internal->KeyAt(index - 1)) == 0) {
-        // Same key, no need to insert
-        return;
-      }
-      internal->SetKeyAt(index, internal->KeyAt(index - 1));
-      internal->SetValueAt(index, internal->ValueAt(index - 1));
-      index--;
-    }
-    if (index == 0) {
-      // The key is same as the first key, the situation should never occur in normal case
-      const KeyType &origin = internal->KeyAt(0);
-      internal->SetKeyAt(index, key);
-      internal->SetValueAt(index, value);
-      ReplaceParentKey(origin, internal->KeyAt(0), guard.PageId(), ctx);
-    }
-    internal->SetSize(internal->GetSize() + 1);
+  if (internal->GetSize() < internal->GetMaxSize() && internal->HasRoomFor(key)) {
+    // In this case, Simply insert(k, v) into the node, right behind the child that was split
+    internal->InsertValueAt(key, value, internal->LookupChildIndex(key, comparator_) + 1);
+    return;
+  }
+  page_id_t internal_id = guard.PageId();
+  // The internal Node is already full, in this case we should coallpse the node first
+  // the buddy stays pinned by buddy_guard, it is unreachable for other threads until it is linked into the parent
+  BasicPageGuard buddy_guard;
+  KeyType separator;
+  page_id_t buddy_id = DivideInternalNode(internal, &buddy_guard, &separator);
+  if (buddy_id == INVALID_PAGE_ID) {
+    return;
+  }
+  auto *buddy = buddy_guard.AsMut<InternalPage>();
+  auto *target = comparator_(key, separator) >= 0 ? buddy : internal;
+  target->InsertValueAt(key, value, target->LookupChildIndex(key, comparator_) + 1);
+  if (internal->GetSize() > buddy->GetSize() + 1) {
+    internal->MoveBackToFront(buddy, &separator);
+  } else if (internal->GetSize() + 1 < buddy->GetSize()) {
+    buddy->MoveFrontToBack(internal, &separator);
+  }
+  if (ctx->write_set_.empty()) {
+    // No more parent to insert, this case you should allocate a new page to become root
+    MakeNewRootNode(internal_id, buddy_id, separator, ctx);
   } else {
-    page_id_t internal_id = guard.PageId();
-    // The leaf Node is already full, in this case we should coallpse the node first
-    BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *buddy;
-    page_id_t buddy_id = DivideInternalNode(internal, &buddy);
-    if (buddy_id == INVALID_PAGE_ID) {
-      return;
-    }
-    if (comparator_(key, buddy->KeyAt(0)) >= 0) {
-      ctx->write_set_.push_back(bpm_->FetchPageWrite(buddy_id));
-      InsertKeyToInternalNode(key, value, ctx);
-    } else {
-      ctx->write_set_.push_back(std::move(guard));
-      InsertKeyToInternalNode(key, value, ctx);
-    }
-    if (internal->GetSize() > buddy->GetSize() + 1) {
-      // internal->StoleFromLeftSibling(buddy, comparator_, key);
-      internal->MoveBackToFront(buddy);
-    } else if (internal->GetSize() + 1 < buddy->GetSize()) {
-      internal->MoveFrontToBack(buddy);
-      // internal->StoleFromRightSibling(buddy, comparator_, key);
-    }
-    const KeyType &key_to_insert = buddy->KeyAt(0);
-    if (ctx->write_set_.empty()) {
-      // No more parent to insert, this case you should allocate a new page to become root
-      MakeNewRootNode(internal_id, buddy_id, internal->KeyAt(0), key_to_insert, ctx);
-    } else {
-      InsertKeyToInternalNode(key_to_insert, buddy_id, ctx);
-    }
+    InsertKeyToInternalNode(separator, buddy_id, ctx);
   }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::DivideLeafNode(LeafPage *leaf, LeafPage **buddy) -> page_id_t {
+auto BPLUSTREE_TYPE::DivideLeafNode(LeafPage *leaf, BasicPageGuard *buddy_guard) -> page_id_t {
   page_id_t alloc_page_id = INVALID_PAGE_ID;
-  auto alloc_page = bpm_->NewPageGuarded(&alloc_page_id);
-  *buddy = alloc_page.AsMut<LeafPage>();
-  if (*buddy == nullptr) {
+  *buddy_guard = bpm_->NewPageGuarded(&alloc_page_id);
+  if (alloc_page_id == INVALID_PAGE_ID) {
     return INVALID_PAGE_ID;
   }
-  (*buddy)->Init(leaf_max_size_);
-  (*buddy)->SetNextPageId(leaf->GetNextPageId());
+  auto *buddy = buddy_guard->AsMut<LeafPage>();
+  buddy->Init(leaf_max_size_);
+  buddy->SetNextPageId(leaf->GetNextPageId());
   leaf->SetNextPageId(alloc_page_id);
-  int old_size = leaf->GetSize();
-  (*buddy)->SetSize(old_size / 2);
-  leaf->SetSize(old_size - (*buddy)->GetSize());
-  for (int i = 0; i < (*buddy)->GetSize(); i++) {
-    (*buddy)->SetKeyAt(i, leaf->KeyAt(leaf->GetSize() + i));
-    (*buddy)->SetValueAt(i, leaf->ValueAt(leaf->GetSize() + i));
-  }
+  leaf->MoveHalfTo(buddy);
   return alloc_page_id;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::DivideInternalNode(InternalPage *internalpage, InternalPage **buddy) -> page_id_t {
+auto BPLUSTREE_TYPE::DivideInternalNode(InternalPage *internalpage, BasicPageGuard *buddy_guard, KeyType *separator)
+    -> page_id_t {
   page_id_t alloc_page_id = INVALID_PAGE_ID;
-  auto alloc_page = bpm_->NewPageGuarded(&alloc_page_id);
-  *buddy = alloc_page.AsMut<InternalPage>();
-  if (*buddy == nullptr) {
+  *buddy_guard = bpm_->NewPageGuarded(&alloc_page_id);
+  if (alloc_page_id == INVALID_PAGE_ID) {
     return INVALID_PAGE_ID;
   }
-  (*buddy)->Init(internal_max_size_);
-  int old_size = internalpage->GetSize();
-  (*buddy)->SetSize(old_size / 2);
-  internalpage->SetSize(old_size - (*buddy)->GetSize());
-  for (int i = 0; i < (*buddy)->GetSize(); i++) {
-    (*buddy)->SetKeyAt(i, internalpage->KeyAt(internalpage->GetSize() + i));
-    (*buddy)->SetValueAt(i, internalpage->ValueAt(internalpage->GetSize() + i));
-  }
+  auto *buddy = buddy_guard->AsMut<InternalPage>();
+  buddy->Init(internal_max_size_);
+  *separator = internalpage->MoveHalfTo(buddy);
   return alloc_page_id;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::MakeNewRootNode(page_id_t pg1_id, page_id_t pg2_id, const KeyType &key1, const KeyType &key2,
-                                     Context *ctx) {
+void BPLUSTREE_TYPE::MakeNewRootNode(page_id_t pg1_id, page_id_t pg2_id, const KeyType &separator, Context *ctx) {
   page_id_t alloc_page_id = INVALID_PAGE_ID;
   auto alloc_page = bpm_->NewPageGuarded(&alloc_page_id);
   if (alloc_page_id == INVALID_PAGE_ID) {
@@ -330,11 +448,8 @@ void BPLUSTREE_TYPE::MakeNewRootNode(page_id_t pg1_id, page_id_t pg2_id, const K
   }
   auto *new_root = alloc_page.AsMut<InternalPage>();
   new_root->Init(internal_max_size_);
-  new_root->SetSize(2);
-  new_root->SetKeyAt(0, key1);
-  new_root->SetKeyAt(1, key2);
-  new_root->SetValueAt(0, pg1_id);
-  new_root->SetValueAt(1, pg2_id);
+  new_root->InsertValueAt(separator, pg1_id, 0);
+  new_root->InsertValueAt(separator, pg2_id, 1);
   BUSTUB_ASSERT(ctx->header_page_, "ctx header page is nullptr");
   auto guard = std::move(ctx->header_page_);
   // std::cout<<"assert guard"<<std::endl;
@@ -344,34 +459,24 @@ void BPLUSTREE_TYPE::MakeNewRootNode(page_id_t pg1_id, page_id_t pg2_id, const K
   // std::cout<<"MakeNewRootNode successfully"<<std::endl;
 }
 
+/*
+ * The shortest key that still tells two neighbouring pages apart: a prefix of `right`, the first key of the page on
+ * the right, that sorts after `left`, the last key of the page on the left. Internal pages store fewer bytes of
+ * such a key, and a parent can hold as many separators as fit.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::ReplaceParentKey(const KeyType &originKey, const KeyType &replaceKey, page_id_t replacePageId,
-                                      Context *ctx) {
-  if (ctx->write_set_.empty()) {
-    return;
-  }
-  WritePageGuard write_guard = std::move(ctx->write_set_.back());
-  ctx->write_set_.pop_back();
-  auto *internal_parent = write_guard.AsMut<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-  if (comparator_(originKey, internal_parent->KeyAt(0)) == 0 && internal_parent->ValueAt(0) == replacePageId) {
-    ReplaceParentKey(originKey, replaceKey, write_guard.PageId(), ctx);
-  }
-  int remove_index = -1;
-  for (int idx = 0; idx < internal_parent->GetSize(); idx++) {
-    if (comparator_(originKey, internal_parent->KeyAt(idx)) == 0 && internal_parent->ValueAt(idx) == replacePageId) {
-      remove_index = idx;
-      break;
+auto BPLUSTREE_TYPE::Separator(const KeyType &left, const KeyType &right) const -> KeyType {
+  size_t end = KeyLayout<KeyType>::SignificantSize(right);
+  for (size_t size = std::min(comparator_.TruncationFloor(right), end); size < end; size++) {
+    KeyType separator;
+    auto *bytes = reinterpret_cast<char *>(&separator);
+    memcpy(bytes, &right, size);
+    memset(bytes + size, 0, sizeof(KeyType) - size);
+    if (comparator_(left, separator) < 0 && comparator_(separator, right) <= 0) {
+      return separator;
     }
   }
-  if (remove_index == -1) {
-    // std::cout << "not found... " << internal_parent->KeyAt(0) << " page id is:" << internal_parent->ValueAt(0) <<
-    // std::endl;
-    ctx->write_set_.push_back(std::move(write_guard));
-    return;
-  }
-  internal_parent->SetKeyAt(remove_index, replaceKey);
-  // We do not know if we need this parent page next time, just insert it back to write_set
-  ctx->write_set_.push_back(std::move(write_guard));
+  return right;
 }
 
 /*****************************************************************************
@@ -612,19 +717,39 @@ void BPLUSTREE_TYPE::Merge(WritePageGuard &parent_wg, WritePageGuard &child_wg,
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
-  // Declaration of context instance.
+  // Optimistic pass: if the leaf does not underflow, only the leaf is modified.
+  if (std::optional<WritePageGuard> leaf_guard = FindLeafOptimistic(key); leaf_guard.has_value()) {
+    auto *leaf = leaf_guard->AsMut<LeafPage>();
+    ValueType unused;
+    if (!leaf->FindValue(key, &unused, comparator_)) {
+      return;
+    }
+    if (leaf->GetSize() > CalculateMinTolerantSize(leaf)) {
+      leaf->DeleteKeyFromNode(key, comparator_);
+      return;
+    }
+  } else {
+    return;
+  }
+
+  // Pessimistic pass, restart from the header with write latches.
   Context ctx;
   WritePageGuard headerwg = bpm_->FetchPageWrite(header_page_id_);
   auto headpage = headerwg.As<BPlusTreeHeaderPage>();
   page_id_t headpageid = headpage->root_page_id_;
   ctx.header_page_ = std::move(headerwg);
+  ctx.root_page_id_ = headpageid;
   if (headpageid == INVALID_PAGE_ID) {
     // the b+tree is empty
     return;
   }
   ctx.sibling_stack_.push_back(INVALID_PAGE_ID);
   RemoveTrack(headpageid, key, txn, &ctx);
-  (void)ctx;
+  ctx.header_page_ = std::nullopt;
+  ctx.write_set_.clear();
+  for (auto page_id : ctx.freed_pages_) {
+    bpm_->DeletePage(page_id);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -639,28 +764,24 @@ void BPLUSTREE_TYPE::RemoveTrack(page_id_t page_id, const KeyType &key, Transact
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::TrackDeletePage(WritePageGuard guard, const KeyType &key, Context *ctx) -> page_id_t {
   auto *tree_page = guard.AsMut<BPlusTreePage>();
+  if (IsSafeForRemove(tree_page, key)) {
+    // Merging leaves latches the left sibling, which would deadlock against iterators walking right. They walk under
+    // the header read latch, so keep the header until it is clear that the leaf itself stays put.
+    ctx->ReleaseAncestors(!tree_page->IsLeafPage());
+  }
   if (tree_page->IsLeafPage()) {
     page_id_t page_id = guard.PageId();
     ctx->write_set_.push_back(std::move(guard));
     return page_id;
   }
   auto *internal_page = guard.AsMut<InternalPage>();
-  int target_index = -1;
+  int target_index = internal_page->LookupChildIndex(key, comparator_);
   if (internal_page->GetSize() == 1) {
-    target_index = 0;
     ctx->sibling_stack_.push_back(INVALID_PAGE_ID);
-  } else if (comparator_(key, internal_page->KeyAt(1)) < 0) {
-    target_index = 0;
+  } else if (target_index == 0) {
     ctx->sibling_stack_.push_back(internal_page->ValueAt(1));
   } else {
-    int index = 1;
-    for (; index < internal_page->GetSize() - 1; index++) {
-      if (comparator_(key, internal_page->KeyAt(index + 1)) < 0) {
-        break;
-      }
-    }
-    target_index = index;
-    ctx->sibling_stack_.push_back(internal_page->ValueAt(index - 1));
+    ctx->sibling_stack_.push_back(internal_page->ValueAt(target_index - 1));
   }
   page_id_t next_page_id = internal_page->ValueAt(target_index);
   if (next_page_id == INVALID_PAGE_ID) {
@@ -799,7 +920,7 @@ void BPLUSTREE_TYPE::RemoveLeafNode(const KeyType &key, Transaction *txn, Contex
 }*/
 
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::RemoveKeyFromParent(const KeyType &key, Context *ctx, page_id_t removed_id) {
+void BPLUSTREE_TYPE::RemoveKeyFromParent(Context *ctx, page_id_t removed_id) {
   if (ctx->write_set_.empty()) {
     return;
   }
@@ -810,85 +931,67 @@ void BPLUSTREE_TYPE::RemoveKeyFromParent(const KeyType &key, Context *ctx, page_
   ctx->sibling_stack_.pop_back();
 
   // do not need to borrow
-  if (sibling_page_id == INVALID_PAGE_ID || internalpage->GetSize() > CalculateMinTolerantSize(internalpage)) {
-    if (comparator_(key, internalpage->KeyAt(0)) == 0) {
-      KeyType oldkey = internalpage->KeyAt(0);
-      if (internalpage->RemovePage(key, removed_id, comparator_)) {
-        ReplaceParentKey(oldkey, internalpage->KeyAt(0), guard.PageId(), ctx);
-      }
-    } else {
-      internalpage->RemovePage(key, removed_id, comparator_);
-    }
+  bool underflow = internalpage->GetSize() <= CalculateMinTolerantSize(internalpage);
+  internalpage->RemovePage(removed_id);
+  if (sibling_page_id == INVALID_PAGE_ID || !underflow) {
     return;
   }
 
-  // need to borrow from sibling
+  // need to borrow from sibling, rotating a child through the separator in the parent
+  auto *parent = ctx->write_set_.back().template AsMut<InternalPage>();
+  int index = parent->ValueIndex(guard.PageId());
+  int sibling_index = parent->ValueIndex(sibling_page_id);
   WritePageGuard sibling = bpm_->FetchPageWrite(sibling_page_id);
   auto *buddy = sibling.AsMut<InternalPage>();
-  bool replace_flag = comparator_(key, internalpage->KeyAt(0)) == 0;
-  if (comparator_(internalpage->KeyAt(0), buddy->KeyAt(0)) > 0) {
-    // left sibling
-    if (buddy->GetSize() > CalculateMinTolerantSize(buddy)) {
-      // just borrow
-      const KeyType &originkey = internalpage->KeyAt(0);
-      internalpage->RemovePage(key, removed_id, comparator_);
-      buddy->MoveBackToFront(internalpage);
-      ReplaceParentKey(originkey, internalpage->KeyAt(0), guard.PageId(), ctx);
-    } else {
-      // need to merge
-      const KeyType &oldkey = internalpage->KeyAt(0);
-      internalpage->RemovePage(key, removed_id, comparator_);
-      internalpage->MoveAllTo(buddy);
-      if (ctx->write_set_.size() == 1) {
-        WritePageGuard parentguard = std::move(ctx->write_set_.back());
-        ctx->write_set_.pop_back();
-        auto *parent = parentguard.AsMut<InternalPage>();
-        if (parent->GetSize() == 2) {
-          // BUSTUB_ASSERT(ctx->header_page_, "header page is nullptr");
-          WritePageGuard root_guard = std::move(ctx->header_page_.value());
-          root_guard.AsMut<BPlusTreeHeaderPage>()->root_page_id_ = sibling.PageId();
-          return;
-        }
-        ctx->write_set_.push_back(std::move(parentguard));
-      }
-      RemoveKeyFromParent(oldkey, ctx, guard.PageId());
-    }
-  } else {
-    // right sibling
-    if (buddy->GetSize() > CalculateMinTolerantSize(buddy)) {
-      // just borrow
-      const KeyType &originkey = internalpage->KeyAt(0);
-      const KeyType &leaf_key = buddy->KeyAt(0);
-      internalpage->RemovePage(key, removed_id, comparator_);
-      buddy->MoveFrontToBack(internalpage);
-      if (replace_flag) {
-        ReplaceParentKey(originkey, internalpage->KeyAt(0), guard.PageId(), ctx);
+  if (buddy->GetSize() > CalculateMinTolerantSize(buddy)) {
+    if (sibling_index < index) {
+      // left sibling, its last child comes over
+      KeyType separator = parent->KeyAt(index);
+      if (internalpage->HasRoomFor(separator) &&
+          parent->HasRoomForKeyAt(index, buddy->KeyAt(buddy->GetSize() - 1))) {
+        buddy->MoveBackToFront(internalpage, &separator);
+        parent->SetKeyAt(index, separator);
+        return;
       }
-      ReplaceParentKey(leaf_key, buddy->KeyAt(0), sibling.PageId(), ctx);
     } else {
-      // need to merge
-      const KeyType &originkey = internalpage->KeyAt(0);
-      const KeyType &leaf_key = buddy->KeyAt(0);
-      internalpage->RemovePage(key, removed_id, comparator_);
-      buddy->MoveAllTo(internalpage);
-      if (replace_flag) {
-        ReplaceParentKey(originkey, internalpage->KeyAt(0), guard.PageId(), ctx);
-      }
-      if (ctx->write_set_.size() == 1) {
-        WritePageGuard parentguard = std::move(ctx->write_set_.back());
-        ctx->write_set_.pop_back();
-        auto *parent = parentguard.AsMut<InternalPage>();
-        if (parent->GetSize() == 2) {
-          // BUSTUB_ASSERT(ctx->header_page_, "header page is nullptr");
-          WritePageGuard root_guard = std::move(ctx->header_page_.value());
-          root_guard.AsMut<BPlusTreeHeaderPage>()->root_page_id_ = guard.PageId();
-          return;
-        }
-        ctx->write_set_.push_back(std::move(parentguard));
+      // right sibling, its first child comes over
+      KeyType separator = parent->KeyAt(sibling_index);
+      if (internalpage->HasRoomFor(separator) && parent->HasRoomForKeyAt(sibling_index, buddy->KeyAt(1))) {
+        buddy->MoveFrontToBack(internalpage, &separator);
+        parent->SetKeyAt(sibling_index, separator);
+        return;
       }
-      RemoveKeyFromParent(leaf_key, ctx, sibling.PageId());
     }
   }
+
+  // need to merge the page on the right into the one on the left, the separator between them comes down
+  bool is_left = sibling_index < index;
+  auto *left = is_left ? buddy : internalpage;
+  auto *right = is_left ? internalpage : buddy;
+  int right_index = std::max(index, sibling_index);
+  KeyType separator = parent->KeyAt(right_index);
+  if (left->GetSize() + right->GetSize() > left->GetMaxSize() || !left->HasRoomFor(right, separator)) {
+    // the page stays underfull, which is still a valid page as long as it has a child
+    BUSTUB_ASSERT(internalpage->GetSize() > 0, "an internal page lost its last child");
+    return;
+  }
+  page_id_t left_id = is_left ? sibling.PageId() : guard.PageId();
+  page_id_t right_id = is_left ? guard.PageId() : sibling.PageId();
+  right->MoveAllTo(left, separator);
+  ctx->freed_pages_.push_back(right_id);
+  if (ctx->write_set_.size() == 1 && ctx->IsRootPage(ctx->write_set_.back().PageId())) {
+    WritePageGuard parentguard = std::move(ctx->write_set_.back());
+    ctx->write_set_.pop_back();
+    if (parentguard.As<InternalPage>()->GetSize() == 2) {
+      ctx->freed_pages_.push_back(parentguard.PageId());
+      // BUSTUB_ASSERT(ctx->header_page_, "header page is nullptr");
+      WritePageGuard root_guard = std::move(ctx->header_page_.value());
+      root_guard.AsMut<BPlusTreeHeaderPage>()->root_page_id_ = left_id;
+      return;
+    }
+    ctx->write_set_.push_back(std::move(parentguard));
+  }
+  RemoveKeyFromParent(ctx, right_id);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -896,84 +999,427 @@ void BPLUSTREE_TYPE::RemoveLeafNode(const KeyType &key, Transaction *txn, Contex
   WritePageGuard guard = std::move(ctx->write_set_.back());
   ctx->write_set_.pop_back();
   auto *leaf = guard.AsMut<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>();
-  if (ctx->write_set_.empty() || leaf->GetSize() > CalculateMinTolerantSize(leaf)) {
-    bool replace_flag = false;
-    replace_flag = comparator_(key, leaf->KeyAt(0)) == 0;
-    if (leaf->DeleteKeyFromNode(key, comparator_)) {
-      if (!ctx->write_set_.empty() && replace_flag) {
-        ReplaceParentKey(key, leaf->KeyAt(0), guard.PageId(), ctx);
-      }
-    }
-    return;
-  }
   page_id_t sibling_id = ctx->sibling_stack_.back();
   ctx->sibling_stack_.pop_back();
+  if (ctx->write_set_.empty() || sibling_id == INVALID_PAGE_ID || leaf->GetSize() > CalculateMinTolerantSize(leaf)) {
+    leaf->DeleteKeyFromNode(key, comparator_);
+    return;
+  }
+  if (!leaf->DeleteKeyFromNode(key, comparator_)) {
+    return;
+  }
+  auto *parent = ctx->write_set_.back().template AsMut<InternalPage>();
+  int index = parent->ValueIndex(guard.PageId());
+  int sibling_index = parent->ValueIndex(sibling_id);
   WritePageGuard sibling_guard = bpm_->FetchPageWrite(sibling_id);
   auto *sibling = sibling_guard.AsMut<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>();
-  bool replace_flag = comparator_(key, leaf->KeyAt(0)) == 0;
-  if (comparator_(sibling->KeyAt(0), leaf->KeyAt(0)) < 0) {
-    // Left sibling case
-    if (sibling->GetSize() > CalculateMinTolerantSize(sibling)) {
-      const KeyType &old_key = leaf->KeyAt(0);
-      if (!leaf->DeleteKeyFromNode(key, comparator_)) {
+  if (sibling->GetSize() > CalculateMinTolerantSize(sibling)) {
+    // borrow a key, the separator in the parent moves to just past the keys staying on the left
+    int size = sibling->GetSize();
+    if (sibling_index < index) {
+      KeyType separator = Separator(sibling->KeyAt(size - 2), sibling->KeyAt(size - 1));
+      if (parent->HasRoomForKeyAt(index, separator)) {
+        sibling->StoleLastElement(leaf);
+        parent->SetKeyAt(index, separator);
         return;
       }
-      sibling->StoleLastElement(leaf);
-      ReplaceParentKey(old_key, leaf->KeyAt(0), guard.PageId(), ctx);
     } else {
-      const KeyType &old_key = leaf->KeyAt(0);
-      if (!leaf->DeleteKeyFromNode(key, comparator_)) {
+      KeyType separator = Separator(sibling->KeyAt(0), sibling->KeyAt(1));
+      if (parent->HasRoomForKeyAt(sibling_index, separator)) {
+        sibling->StoleFirstElement(leaf);
+        parent->SetKeyAt(sibling_index, separator);
         return;
       }
-      sibling->CombineWithRightSibling(leaf);
-      if (ctx->write_set_.size() == 1) {
-        WritePageGuard parent_guard = std::move(ctx->write_set_.back());
-        ctx->write_set_.pop_back();
-        auto *parent = parent_guard.AsMut<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-        if (parent->GetSize() == 2) {
-          WritePageGuard root_guard = std::move(ctx->header_page_.value());
-          root_guard.AsMut<BPlusTreeHeaderPage>()->root_page_id_ = sibling_guard.PageId();
-          return;
+    }
+  }
+
+  // merge the leaf on the right into the one on the left
+  bool is_left = sibling_index < index;
+  auto *left = is_left ? sibling : leaf;
+  auto *right = is_left ? leaf : sibling;
+  if (leaf->GetSize() > 0 &&
+      (left->GetSize() + right->GetSize() >= left->GetMaxSize() || !left->HasRoomFor(right))) {
+    // the leaf stays underfull, which is fine as long as it is not empty
+    return;
+  }
+  page_id_t left_id = is_left ? sibling_guard.PageId() : guard.PageId();
+  page_id_t right_id = is_left ? guard.PageId() : sibling_guard.PageId();
+  left->CombineWithRightSibling(right);
+  ctx->freed_pages_.push_back(right_id);
+  if (ctx->write_set_.size() == 1 && ctx->IsRootPage(ctx->write_set_.back().PageId())) {
+    WritePageGuard parent_guard = std::move(ctx->write_set_.back());
+    ctx->write_set_.pop_back();
+    if (parent_guard.As<InternalPage>()->GetSize() == 2) {
+      ctx->freed_pages_.push_back(parent_guard.PageId());
+      WritePageGuard root_guard = std::move(ctx->header_page_.value());
+      root_guard.AsMut<BPlusTreeHeaderPage>()->root_page_id_ = left_id;
+      return;
+    }
+    ctx->write_set_.push_back(std::move(parent_guard));
+  }
+  RemoveKeyFromParent(ctx, right_id);
+}
+
+/*
+ * Range and bulk removal. The pass descends once and visits the children of each internal page that intersect the
+ * range in key order, so leaves are reached from left to right the way iterators walk them. The header page stays
+ * write-latched, which keeps out iterators and every remove that may merge leaves; that makes it safe to latch leaves
+ * in key order and to relink the left neighbour of a dropped leaf. On the way back up each parent drops its emptied
+ * children and merges underfull neighbours where they fit, keeping leaves non-empty and internal pages at two
+ * children or more. Separators stay valid as keys go, so they are left as they are.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RemoveRange(const std::function<bool(const KeyType &)> &is_before,
+                                 const std::function<bool(const KeyType &)> &is_after, Transaction *txn) -> size_t {
+  RemoveRangeContext ctx;
+  ctx.is_before_ = is_before;
+  ctx.is_after_ = is_after;
+  return RemoveInRange(&ctx);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RemoveKeys(std::vector<KeyType> keys, Transaction *txn) -> size_t {
+  if (keys.empty()) {
+    return 0;
+  }
+  std::sort(keys.begin(), keys.end(),
+            [this](const KeyType &lhs, const KeyType &rhs) { return comparator_(lhs, rhs) < 0; });
+  keys.erase(std::unique(keys.begin(), keys.end(),
+                         [this](const KeyType &lhs, const KeyType &rhs) { return comparator_(lhs, rhs) == 0; }),
+             keys.end());
+  RemoveRangeContext ctx;
+  ctx.keys_ = &keys;
+  ctx.is_before_ = [this, &keys](const KeyType &key) { return comparator_(key, keys.front()) < 0; };
+  ctx.is_after_ = [this, &keys](const KeyType &key) { return comparator_(key, keys.back()) > 0; };
+  return RemoveInRange(&ctx);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RemoveInRange(RemoveRangeContext *ctx) -> size_t {
+  {
+    WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+    auto *header = header_guard.AsMut<BPlusTreeHeaderPage>();
+    if (header->root_page_id_ == INVALID_PAGE_ID) {
+      return 0;
+    }
+    WritePageGuard root_guard = bpm_->FetchPageWrite(header->root_page_id_);
+    if (root_guard.As<BPlusTreePage>()->IsLeafPage()) {
+      RemoveFromLeaf(root_guard.AsMut<LeafPage>(), ctx);
+    } else {
+      RemoveFromInternal(root_guard, std::nullopt, ctx);
+    }
+    ctx->prev_leaf_ = std::nullopt;
+    // an empty root empties the tree, a root with a single child hands over to that child
+    while (true) {
+      auto *root = root_guard.AsMut<BPlusTreePage>();
+      if (root->GetSize() == 0) {
+        ctx->freed_.push_back(root_guard.PageId());
+        header->root_page_id_ = INVALID_PAGE_ID;
+        break;
+      }
+      if (root->IsLeafPage() || root->GetSize() > 1) {
+        break;
+      }
+      ctx->freed_.push_back(root_guard.PageId());
+      header->root_page_id_ = root_guard.As<InternalPage>()->ValueAt(0);
+      root_guard = bpm_->FetchPageWrite(header->root_page_id_);
+    }
+  }
+  for (auto page_id : ctx->freed_) {
+    bpm_->DeletePage(page_id);
+  }
+  return ctx->removed_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveFromLeaf(LeafPage *leaf, RemoveRangeContext *ctx) {
+  int size = leaf->GetSize();
+  if (ctx->keys_ == nullptr) {
+    // the keys in range are the run [begin, end), found by binary search on the predicates
+    auto first_where = [leaf](int lo, int hi, const auto &pred) {
+      while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (pred(leaf->KeyAt(mid))) {
+          hi = mid;
+        } else {
+          lo = mid + 1;
         }
-        ctx->write_set_.push_back(std::move(parent_guard));
       }
-      RemoveKeyFromParent(old_key, ctx, guard.PageId());
+      return lo;
+    };
+    int begin = ctx->is_before_ ? first_where(0, size, [ctx](const KeyType &key) { return !ctx->is_before_(key); }) : 0;
+    int end = ctx->is_after_ ? first_where(begin, size, ctx->is_after_) : size;
+    for (int i = end; i < size; i++) {
+      leaf->SetKeyAt(begin + i - end, leaf->KeyAt(i));
+      leaf->SetValueAt(begin + i - end, leaf->ValueAt(i));
     }
-  } else {
-    if (sibling->GetSize() > CalculateMinTolerantSize(sibling)) {
-      const KeyType &old_key = leaf->KeyAt(0);
-      const KeyType &sibling_old_key = sibling->KeyAt(0);
-      if (!leaf->DeleteKeyFromNode(key, comparator_)) {
-        return;
+    leaf->SetSize(size - (end - begin));
+    ctx->removed_ += end - begin;
+    return;
+  }
+  // merge the sorted keys to remove with the keys of the leaf, compacting the kept ones
+  const auto &keys = *ctx->keys_;
+  int kept = 0;
+  for (int i = 0; i < size; i++) {
+    KeyType key = leaf->KeyAt(i);
+    while (ctx->next_key_ < keys.size() && comparator_(keys[ctx->next_key_], key) < 0) {
+      ctx->next_key_++;
+    }
+    if (ctx->next_key_ < keys.size() && comparator_(keys[ctx->next_key_], key) == 0) {
+      ctx->next_key_++;
+      continue;
+    }
+    if (kept != i) {
+      leaf->SetKeyAt(kept, key);
+      leaf->SetValueAt(kept, leaf->ValueAt(i));
+    }
+    kept++;
+  }
+  leaf->SetSize(kept);
+  ctx->removed_ += size - kept;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveFromInternal(WritePageGuard &guard, const std::optional<KeyType> &lower,
+                                        RemoveRangeContext *ctx) {
+  auto *page = guard.AsMut<InternalPage>();
+  // the bound below the first child, which the page does not store; std::nullopt on the left edge of the tree
+  std::optional<KeyType> first_lower = lower;
+  auto lower_at = [page, &first_lower](int index) {
+    return index > 0 ? std::make_optional(page->KeyAt(index)) : first_lower;
+  };
+  auto remove_child = [page, &first_lower](int index) {
+    if (index == 0 && page->GetSize() > 1) {
+      first_lower = page->KeyAt(1);
+    }
+    page->RemoveByIndex(index);
+  };
+  // start at the last child whose separator is before the range, its later keys may be in it
+  int idx = 0;
+  if (ctx->is_before_) {
+    int lo = 1;
+    int hi = page->GetSize();
+    while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if (ctx->is_before_(page->KeyAt(mid))) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
       }
-      sibling->StoleFirstElement(leaf);
-      if (replace_flag) {
-        ReplaceParentKey(old_key, leaf->KeyAt(0), guard.PageId(), ctx);
+    }
+    idx = lo - 1;
+  }
+  if (idx > 0) {
+    // the leaf before the first one visited is the last leaf of the child on the left
+    ctx->prev_leaf_ = std::nullopt;
+    ctx->prev_subtree_ = page->ValueAt(idx - 1);
+  }
+  // the last internal child kept so far, still latched so that the next one can be merged into it
+  std::optional<WritePageGuard> prev_child;
+  // internal children left with a single child, fixed after the loop has let go of the children
+  std::vector<page_id_t> single_children;
+  bool started = false;
+  while (idx < page->GetSize()) {
+    auto child_lower = lower_at(idx);
+    if (started && ctx->is_after_ && child_lower.has_value() && ctx->is_after_(*child_lower)) {
+      break;
+    }
+    started = true;
+    page_id_t child_id = page->ValueAt(idx);
+    auto upper = idx + 1 < page->GetSize() ? std::make_optional(page->KeyAt(idx + 1)) : std::nullopt;
+    // keys to remove below `upper` that the child did not hold are not in the tree
+    auto pass_child = [this, ctx, &upper] {
+      while (ctx->keys_ != nullptr && upper.has_value() && ctx->next_key_ < ctx->keys_->size() &&
+             comparator_((*ctx->keys_)[ctx->next_key_], *upper) < 0) {
+        ctx->next_key_++;
       }
-      ReplaceParentKey(sibling_old_key, sibling->KeyAt(0), sibling_guard.PageId(), ctx);
-    } else {
-      const KeyType &old_key = sibling->KeyAt(0);
-      if (!leaf->DeleteKeyFromNode(key, comparator_)) {
-        return;
+    };
+
+    if (ctx->keys_ != nullptr && (ctx->next_key_ == ctx->keys_->size() ||
+                                  (upper.has_value() && comparator_((*ctx->keys_)[ctx->next_key_], *upper) >= 0))) {
+      // none of the keys to remove is below this child
+      ctx->prev_leaf_ = std::nullopt;
+      ctx->prev_subtree_ = child_id;
+      prev_child = std::nullopt;
+      idx++;
+      continue;
+    }
+    if (ctx->keys_ == nullptr && upper.has_value() &&
+        !(ctx->is_before_ && (!child_lower.has_value() || ctx->is_before_(*child_lower))) &&
+        !(ctx->is_after_ && ctx->is_after_(*upper))) {
+      // every key below this child is in range
+      FreeSubtree(child_id, ctx);
+      remove_child(idx);
+      continue;
+    }
+
+    WritePageGuard child_guard = bpm_->FetchPageWrite(child_id);
+    if (child_guard.As<BPlusTreePage>()->IsLeafPage()) {
+      auto *leaf = child_guard.AsMut<LeafPage>();
+      RemoveFromLeaf(leaf, ctx);
+      pass_child();
+      if (leaf->GetSize() == 0) {
+        DropLeaf(child_guard, ctx);
+        remove_child(idx);
+        continue;
       }
-      leaf->CombineWithRightSibling(sibling);
-      if (ctx->write_set_.size() == 1) {
-        WritePageGuard parent_guard = std::move(ctx->write_set_.back());
-        ctx->write_set_.pop_back();
-        auto *parent = parent_guard.AsMut<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-        if (parent->GetSize() == 2) {
-          WritePageGuard root_guard = std::move(ctx->header_page_.value());
-          root_guard.AsMut<BPlusTreeHeaderPage>()->root_page_id_ = guard.PageId();
-          return;
+      // merge into the left neighbour if one of the two is underfull and both fit into one leaf
+      int min_size = CalculateMinTolerantSize(leaf);
+      if (idx > 0 && (leaf->GetSize() < min_size ||
+                      (ctx->prev_leaf_.has_value() && ctx->prev_leaf_->template As<LeafPage>()->GetSize() < min_size))) {
+        auto *prev = PrevLeaf(ctx);
+        if (prev != nullptr && ctx->prev_leaf_->PageId() == page->ValueAt(idx - 1) &&
+            prev->GetSize() + leaf->GetSize() < leaf_max_size_ && prev->HasRoomFor(leaf)) {
+          prev->CombineWithRightSibling(leaf);
+          ctx->freed_.push_back(child_id);
+          page->RemoveByIndex(idx);
+          continue;
         }
-        ctx->write_set_.push_back(std::move(parent_guard));
       }
-      if (replace_flag) {
-        ReplaceParentKey(key, leaf->KeyAt(0), guard.PageId(), ctx);
+      ctx->prev_leaf_ = std::move(child_guard);
+      ctx->prev_subtree_ = INVALID_PAGE_ID;
+      idx++;
+      continue;
+    }
+
+    RemoveFromInternal(child_guard, child_lower, ctx);
+    pass_child();
+    auto *child = child_guard.AsMut<InternalPage>();
+    if (child->GetSize() == 0) {
+      ctx->freed_.push_back(child_id);
+      remove_child(idx);
+      continue;
+    }
+    if (prev_child.has_value() && idx > 0 && prev_child->PageId() == page->ValueAt(idx - 1)) {
+      auto *left = prev_child->AsMut<InternalPage>();
+      int min_size = CalculateMinTolerantSize(child);
+      if ((child->GetSize() < min_size || left->GetSize() < min_size) &&
+          left->GetSize() + child->GetSize() <= internal_max_size_ && left->HasRoomFor(child, page->KeyAt(idx))) {
+        child->MoveAllTo(left, page->KeyAt(idx));
+        ctx->freed_.push_back(child_id);
+        page->RemoveByIndex(idx);
+        continue;
+      }
+    }
+    if (child->GetSize() == 1) {
+      single_children.push_back(child_id);
+    }
+    prev_child = std::move(child_guard);
+    idx++;
+  }
+  prev_child = std::nullopt;
+  for (auto child_id : single_children) {
+    FixSingleChild(page, child_id, ctx);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DropLeaf(WritePageGuard &guard, RemoveRangeContext *ctx) {
+  if (auto *prev = PrevLeaf(ctx); prev != nullptr) {
+    prev->SetNextPageId(guard.As<LeafPage>()->GetNextPageId());
+  }
+  ctx->freed_.push_back(guard.PageId());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FreeSubtree(page_id_t page_id, RemoveRangeContext *ctx) {
+  // latch every page before letting go of it, so that operations still inside get to finish first
+  WritePageGuard guard = bpm_->FetchPageWrite(page_id);
+  if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+    ctx->removed_ += guard.As<LeafPage>()->GetSize();
+    DropLeaf(guard, ctx);
+    return;
+  }
+  auto *internal = guard.As<InternalPage>();
+  for (int i = 0; i < internal->GetSize(); i++) {
+    FreeSubtree(internal->ValueAt(i), ctx);
+  }
+  ctx->freed_.push_back(page_id);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::PrevLeaf(RemoveRangeContext *ctx) -> LeafPage * {
+  if (!ctx->prev_leaf_.has_value() && ctx->prev_subtree_ != INVALID_PAGE_ID) {
+    // walk down the right edge of the skipped subtree, coupling latches like FindLeafOptimistic
+    page_id_t page_id = ctx->prev_subtree_;
+    ReadPageGuard parent_guard;
+    while (true) {
+      ReadPageGuard page_guard = bpm_->FetchPageRead(page_id);
+      if (page_guard.As<BPlusTreePage>()->IsLeafPage()) {
+        page_guard.Drop();
+        ctx->prev_leaf_ = bpm_->FetchPageWrite(page_id);
+        break;
       }
-      RemoveKeyFromParent(old_key, ctx, sibling_guard.PageId());
+      auto *internal = page_guard.As<InternalPage>();
+      page_id = internal->ValueAt(internal->GetSize() - 1);
+      parent_guard = std::move(page_guard);
     }
+    ctx->prev_subtree_ = INVALID_PAGE_ID;
   }
+  return ctx->prev_leaf_.has_value() ? ctx->prev_leaf_->template AsMut<LeafPage>() : nullptr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FixSingleChild(InternalPage *parent, page_id_t child_id, RemoveRangeContext *ctx) {
+  int idx = parent->ValueIndex(child_id);
+  // the child was merged away since, or has no sibling and leaves its parent with one child in turn
+  if (idx == parent->GetSize() || parent->GetSize() == 1) {
+    return;
+  }
+  WritePageGuard child_guard = bpm_->FetchPageWrite(child_id);
+  auto *child = child_guard.AsMut<InternalPage>();
+  if (child->GetSize() != 1) {
+    return;
+  }
+  // the separator between the child and its sibling comes down into whichever keeps the children of both
+  if (idx > 0) {
+    WritePageGuard left_guard = bpm_->FetchPageWrite(parent->ValueAt(idx - 1));
+    auto *left = left_guard.AsMut<InternalPage>();
+    KeyType separator = parent->KeyAt(idx);
+    if (left->GetSize() < internal_max_size_ && left->HasRoomFor(child, separator)) {
+      child->MoveAllTo(left, separator);
+      ctx->freed_.push_back(child_id);
+      parent->RemoveByIndex(idx);
+    } else if (child->HasRoomFor(separator) &&
+               parent->HasRoomForKeyAt(idx, left->KeyAt(left->GetSize() - 1))) {
+      left->MoveBackToFront(child, &separator);
+      parent->SetKeyAt(idx, separator);
+    }
+    return;
+  }
+  page_id_t right_id = parent->ValueAt(1);
+  WritePageGuard right_guard = bpm_->FetchPageWrite(right_id);
+  auto *right = right_guard.AsMut<InternalPage>();
+  KeyType separator = parent->KeyAt(1);
+  if (right->GetSize() < internal_max_size_ && child->HasRoomFor(right, separator)) {
+    right->MoveAllTo(child, separator);
+    ctx->freed_.push_back(right_id);
+    parent->RemoveByIndex(1);
+  } else if (child->HasRoomFor(separator) && parent->HasRoomForKeyAt(1, right->KeyAt(1))) {
+    right->MoveFrontToBack(child, &separator);
+    parent->SetKeyAt(1, separator);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafeForInsert(BPlusTreePage *page, const KeyType &key) -> bool {
+  // a safe page does not split, so nothing above it changes; an internal page must fit whatever separator comes up
+  if (page->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page);
+    return leaf->GetSize() > 0 && leaf->GetSize() + 1 < leaf->GetMaxSize() && leaf->HasRoomFor(key);
+  }
+  auto *internal = reinterpret_cast<InternalPage *>(page);
+  return internal->GetSize() < internal->GetMaxSize() && internal->HasRoomForAnyKey();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafeForRemove(BPlusTreePage *page, const KeyType &key) -> bool {
+  // a safe page does not underflow; inner pages also keep at least two children, so the root cannot collapse below
+  // them
+  if (page->IsLeafPage()) {
+    return page->GetSize() > CalculateMinTolerantSize(page);
+  }
+  return page->GetSize() > std::max(CalculateMinTolerantSize(page), 2);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -1011,7 +1457,11 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
     read_guard = bpm_->FetchPageRead(headpageid);
     tree_page = read_guard.As<BPlusTreePage>();
   }
-  return INDEXITERATOR_TYPE(bpm_, std::move(read_guard), std::move(headerwg), 0);
+  // removing every key leaves an empty root leaf behind
+  if (tree_page->GetSize() == 0) {
+    return End();
+  }
+  return INDEXITERATOR_TYPE(bpm_, &comparator_, std::move(headerwg), std::move(read_guard), 0);
 }
 
 /*
@@ -1054,7 +1504,123 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
                       leaf->GetNextPageId() == INVALID_PAGE_ID)) {
     return End();
   }*/
-  return {bpm_, std::move(read_guard), std::move(headerwg), index};
+  return {bpm_, &comparator_, std::move(headerwg), std::move(read_guard), index};
+}
+
+/*
+ * Input parameter is a monotone predicate that holds for every key sorting
+ * before the start of a range, find the first key it rejects, then construct
+ * index iterator
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BeginAt(const std::function<bool(const KeyType &)> &is_before) -> INDEXITERATOR_TYPE {
+  ReadPageGuard headerwg = bpm_->FetchPageRead(header_page_id_);
+  auto headpage = headerwg.As<BPlusTreeHeaderPage>();
+  auto headpageid = headpage->root_page_id_;
+  if (headpageid == INVALID_PAGE_ID) {
+    return End();
+  }
+  ReadPageGuard read_guard = bpm_->FetchPageRead(headpageid);
+  auto tree_page = read_guard.As<BPlusTreePage>();
+  while (!tree_page->IsLeafPage()) {
+    auto *internal_page = read_guard.As<InternalPage>();
+    // the first wanted key can only live in the last child whose separator still sorts before the range
+    int left = 1;
+    int right = internal_page->GetSize();
+    while (left < right) {
+      int mid = left + (right - left) / 2;
+      if (is_before(internal_page->KeyAt(mid))) {
+        left = mid + 1;
+      } else {
+        right = mid;
+      }
+    }
+    read_guard = bpm_->FetchPageRead(internal_page->ValueAt(left - 1));
+    tree_page = read_guard.As<BPlusTreePage>();
+  }
+
+  auto *leaf = read_guard.As<LeafPage>();
+  int left = 0;
+  int right = leaf->GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (is_before(leaf->KeyAt(mid))) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  // every key of the leaf sorts before the range, the range starts at the head of the next leaf
+  while (left == leaf->GetSize()) {
+    if (leaf->GetNextPageId() == INVALID_PAGE_ID) {
+      return End();
+    }
+    read_guard = bpm_->FetchPageRead(leaf->GetNextPageId());
+    leaf = read_guard.As<LeafPage>();
+    left = 0;
+  }
+  return {bpm_, &comparator_, std::move(headerwg), std::move(read_guard), left};
+}
+
+/*
+ * Input parameter is void, find the rightmost leaf page first, then construct
+ * reverse index iterator
+ * @return : reverse index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin() -> REVERSE_INDEXITERATOR_TYPE {
+  return RBeginAt([](const KeyType &key) { return false; });
+}
+
+/*
+ * Input parameter is a monotone predicate that holds for every key sorting
+ * after the end of a range, find the last key it rejects, then construct
+ * reverse index iterator
+ * @return : reverse index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBeginAt(const std::function<bool(const KeyType &)> &is_after) -> REVERSE_INDEXITERATOR_TYPE {
+  ReadPageGuard headerwg = bpm_->FetchPageRead(header_page_id_);
+  auto headpage = headerwg.As<BPlusTreeHeaderPage>();
+  auto headpageid = headpage->root_page_id_;
+  if (headpageid == INVALID_PAGE_ID) {
+    return {};
+  }
+  ReadPageGuard read_guard = bpm_->FetchPageRead(headpageid);
+  auto tree_page = read_guard.As<BPlusTreePage>();
+  bool leftmost = true;
+  while (!tree_page->IsLeafPage()) {
+    auto *internal_page = read_guard.As<InternalPage>();
+    // the last wanted key can only live in the last child whose separator is not past the range
+    int left = 1;
+    int right = internal_page->GetSize();
+    while (left < right) {
+      int mid = left + (right - left) / 2;
+      if (is_after(internal_page->KeyAt(mid))) {
+        right = mid;
+      } else {
+        left = mid + 1;
+      }
+    }
+    leftmost = leftmost && left == 1;
+    read_guard = bpm_->FetchPageRead(internal_page->ValueAt(left - 1));
+    tree_page = read_guard.As<BPlusTreePage>();
+  }
+
+  auto *leaf = read_guard.As<LeafPage>();
+  int left = 0;
+  int right = leaf->GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (is_after(leaf->KeyAt(mid))) {
+      right = mid;
+    } else {
+      left = mid + 1;
+    }
+  }
+  // with every key of the leaf past the range, the iterator moves on to the keys before the first one of the leaf
+  return {bpm_, &comparator_, std::move(headerwg), std::move(read_guard), left, leftmost};
 }
 
 /*
@@ -1064,7 +1630,7 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
-  return INDEXITERATOR_TYPE(nullptr, {nullptr, nullptr}, {nullptr, nullptr}, -1);
+  return {};
 }
 
 /**
@@ -1306,8 +1872,22 @@ template class BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
 
 template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 
+template class BPlusTree<GenericKey<24>, RID, GenericComparator<24>>;
+
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 
+template class BPlusTree<GenericKey<40>, RID, GenericComparator<40>>;
+
+template class BPlusTree<GenericKey<48>, RID, GenericComparator<48>>;
+
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTree<GenericKey<96>, RID, GenericComparator<96>>;
+
+template class BPlusTree<GenericKey<8>, RID, IntegerComparator<8, int32_t>>;
+
+template class BPlusTree<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+template class BPlusTree<GenericKey<16>, RID, IntegerComparator<16, int32_t>>;
+template class BPlusTree<GenericKey<16>, RID, IntegerComparator<16, int64_t>>;
+
 }  // namespace bustub
@@ -11,13 +11,52 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include <algorithm>
+#include <limits>
+#include <mutex>  // NOLINT
+
+#include "common/exception.h"
+#include "fmt/format.h"
+
 namespace bustub {
+
+namespace {
+
+/**
+ * Fold one key column into a Bloom filter hash. Integers go in as they are, HashUtil::HashValue sign-extends their
+ * bytes and maps many small keys onto the same hash; the filter mixes the result anyway.
+ */
+auto CombineBloomHash(hash_t hash, const Value &value) -> hash_t {
+  hash_t column_hash;
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      column_hash = static_cast<hash_t>(value.GetAs<int8_t>());
+      break;
+    case TypeId::SMALLINT:
+      column_hash = static_cast<hash_t>(value.GetAs<int16_t>());
+      break;
+    case TypeId::INTEGER:
+      column_hash = static_cast<hash_t>(value.GetAs<int32_t>());
+      break;
+    case TypeId::BIGINT:
+      column_hash = static_cast<hash_t>(value.GetAs<int64_t>());
+      break;
+    default:
+      column_hash = HashUtil::HashValue(&value);
+      break;
+  }
+  return hash * 0x9e3779b97f4a7c15ULL + column_hash;
+}
+
+}  // namespace
 /*
  * Constructor
  */
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
-    : Index(std::move(metadata)), comparator_(GetMetadata()->GetKeySchema()) {
+    : Index(std::move(metadata)),
+      comparator_(GetMetadata()->GetKeySchema(), !GetMetadata()->IsUnique()),
+      key_comparator_(GetMetadata()->GetKeySchema()) {
   page_id_t header_page_id;
   buffer_pool_manager->NewPage(&header_page_id);
   container_ = std::make_shared<BPlusTree<KeyType, ValueType, KeyComparator>>(GetMetadata()->GetName(), header_page_id,
@@ -25,30 +64,242 @@ BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
-  // construct insert index key
+auto BPLUSTREE_INDEX_TYPE::KeyFits(const Tuple &key) const -> bool {
+  return key.GetLength() + (IsUnique() ? 0 : sizeof(int64_t)) <= sizeof(KeyType);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::MakeIndexKey(const Tuple &key, RID rid) const -> KeyType {
   KeyType index_key;
   index_key.SetFromKey(key);
+  if (!IsUnique()) {
+    index_key.SetRid(rid);
+  }
+  return index_key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::BloomHash(const Tuple &key) const -> hash_t {
+  auto *key_schema = GetKeySchema();
+  hash_t hash = 0;
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    hash = CombineBloomHash(hash, key.GetValue(key_schema, i));
+  }
+  return hash;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::BloomHash(const KeyType &key) const -> hash_t {
+  auto *key_schema = GetKeySchema();
+  hash_t hash = 0;
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    hash = CombineBloomHash(hash, key.ToValue(key_schema, i));
+  }
+  return hash;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::MayContain(const Tuple &key) -> bool {
+  if (!has_bloom_filter_.load(std::memory_order_acquire)) {
+    return true;
+  }
+  std::shared_lock<std::shared_mutex> guard(bloom_latch_);
+  return bloom_filter_->MayContain(BloomHash(key));
+}
 
-  return container_->Insert(index_key, rid, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::RebuildBloomFilter(size_t expected_keys, const BloomFilter *replaced) {
+  std::unique_lock<std::shared_mutex> guard(bloom_latch_);
+  // another insert may have rebuilt it while this one waited for the latch
+  if (replaced != nullptr && bloom_filter_.get() != replaced) {
+    return;
+  }
+  std::vector<hash_t> hashes;
+  for (auto iter = container_->Begin(); !iter.IsEnd(); ++iter) {
+    hashes.push_back(BloomHash((*iter).first));
+  }
+  // leave room to grow before the next rebuild
+  auto filter = std::make_unique<BloomFilter>(std::max(expected_keys, 2 * hashes.size()));
+  for (auto hash : hashes) {
+    filter->Insert(hash);
+  }
+  bloom_filter_ = std::move(filter);
+  has_bloom_filter_.store(true, std::memory_order_release);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::EnableBloomFilter() { RebuildBloomFilter(0); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  // strings longer than their declared width could overflow the fixed-size key
+  if (!KeyFits(key)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE,
+                    fmt::format("key of {} bytes does not fit into index {}", key.GetLength(), GetName()));
+  }
+  const BloomFilter *overloaded = nullptr;
+  size_t grow_to = 0;
+  bool inserted;
+  {
+    std::shared_lock<std::shared_mutex> guard(bloom_latch_);
+    if (bloom_filter_ != nullptr) {
+      bloom_filter_->Insert(BloomHash(key));
+      if (bloom_filter_->IsOverloaded()) {
+        overloaded = bloom_filter_.get();
+        grow_to = 2 * bloom_filter_->GetExpectedKeys();
+      }
+    }
+    inserted = container_->Insert(MakeIndexKey(key, rid), rid, transaction);
+  }
+  if (overloaded != nullptr) {
+    RebuildBloomFilter(grow_to, overloaded);
+  }
+  return inserted;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
-  // construct delete index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+  // a key that does not fit was never inserted
+  if (!KeyFits(key)) {
+    return;
+  }
+  container_->Remove(MakeIndexKey(key, rid), transaction);
+}
 
-  container_->Remove(index_key, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::DeleteEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+  if (entries.size() < INDEX_BULK_DELETE_MIN_KEYS) {
+    Index::DeleteEntries(entries, transaction);
+    return;
+  }
+  std::vector<KeyType> index_keys;
+  index_keys.reserve(entries.size());
+  for (const auto &[key, rid] : entries) {
+    if (KeyFits(key)) {
+      index_keys.push_back(MakeIndexKey(key, rid));
+    }
+  }
+  container_->RemoveKeys(std::move(index_keys), transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
-  // construct scan index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+  if (!KeyFits(key) || !MayContain(key)) {
+    return;
+  }
+  if (IsUnique()) {
+    container_->GetValue(MakeIndexKey(key, RID()), result, transaction);
+    return;
+  }
+  // the duplicates of a key are adjacent and ordered by RID, starting from the smallest possible one
+  auto index_key = MakeIndexKey(key, RID(std::numeric_limits<int64_t>::min()));
+  auto iter = container_->BeginAt([&](const KeyType &entry) { return comparator_(entry, index_key) < 0; });
+  for (; !iter.IsEnd() && key_comparator_((*iter).first, index_key) == 0; ++iter) {
+    result->push_back((*iter).second);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                                    Transaction *transaction) {
+  if (!IsUnique()) {
+    Index::ScanKeys(keys, result, transaction);
+    return;
+  }
+  std::vector<KeyType> index_keys;
+  std::vector<size_t> positions;
+  index_keys.reserve(keys.size());
+  positions.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (!KeyFits(keys[i]) || !MayContain(keys[i])) {
+      continue;
+    }
+    index_keys.push_back(MakeIndexKey(keys[i], RID()));
+    positions.push_back(i);
+  }
+  std::vector<std::vector<RID>> found;
+  container_->GetValues(index_keys, &found, transaction);
+  result->assign(keys.size(), {});
+  for (size_t i = 0; i < positions.size(); i++) {
+    (*result)[positions[i]] = std::move(found[i]);
+  }
+}
 
-  container_->GetValue(index_key, result, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BulkLoad(TableHeap *table, const Schema &table_schema, double fill_factor,
+                                    Transaction *transaction, size_t max_keys) {
+  std::vector<std::pair<KeyType, ValueType>> entries;
+  auto iter = table->MakeIterator();
+  for (; !iter.IsEnd() && entries.size() < max_keys; ++iter) {
+    auto [meta, tuple] = iter.GetTuple();
+    if (meta.is_deleted_ || !IsIndexed(tuple, table_schema)) {
+      continue;
+    }
+    auto key = KeyFromTuple(tuple, table_schema);
+    if (!KeyFits(key)) {
+      throw Exception(ExceptionType::OUT_OF_RANGE,
+                      fmt::format("key of {} bytes does not fit into index {}", key.GetLength(), GetName()));
+    }
+    entries.emplace_back(MakeIndexKey(key, tuple.GetRid()), tuple.GetRid());
+  }
+  auto loaded = entries.size();
+  if (!container_->BulkLoad(std::move(entries), fill_factor)) {
+    throw Exception(ExceptionType::EXECUTION, fmt::format("cannot bulk load non-empty index {}", GetName()));
+  }
+  if (has_bloom_filter_.load(std::memory_order_acquire)) {
+    RebuildBloomFilter(2 * loaded);
+  }
+  // memory stays bounded on large tables, the remaining tuples go in like inserted rows, which also keeps the first
+  // of equal keys
+  for (; !iter.IsEnd(); ++iter) {
+    auto [meta, tuple] = iter.GetTuple();
+    if (meta.is_deleted_ || !IsIndexed(tuple, table_schema)) {
+      continue;
+    }
+    InsertEntry(KeyFromTuple(tuple, table_schema), tuple.GetRid(), transaction);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::ScanRange(const IndexKeyRange &range, bool descending)
+    -> std::unique_ptr<IndexScanCursor> {
+  using ForwardCursor = BPlusTreeIndexCursor<KeyType, INDEXITERATOR_TYPE>;
+  using ReverseCursor = BPlusTreeIndexCursor<KeyType, REVERSE_INDEXITERATOR_TYPE>;
+  auto *key_schema = GetKeySchema();
+  // a point lookup of an absent key on a single-column index ends before it reaches the tree
+  if (has_bloom_filter_.load(std::memory_order_acquire) && GetIndexColumnCount() == 1 && range.low_.has_value() &&
+      range.high_.has_value() && range.low_inclusive_ && range.high_inclusive_ &&
+      range.low_->GetTypeId() == key_schema->GetColumn(0).GetType() &&
+      range.low_->CompareEquals(*range.high_) == CmpBool::CmpTrue && !MayContain(Tuple({*range.low_}, key_schema))) {
+    return std::make_unique<ForwardCursor>(container_->End(), nullptr, key_schema);
+  }
+  // the bounds only constrain the first key column, which is also the most significant one in the key order
+  std::function<bool(const KeyType &)> is_before;
+  if (range.low_.has_value()) {
+    is_before = [key_schema, low = *range.low_, inclusive = range.low_inclusive_](const KeyType &key) {
+      auto value = key.ToValue(key_schema, 0);
+      if (value.IsNull()) {
+        return true;
+      }
+      return (inclusive ? value.CompareLessThan(low) : value.CompareLessThanEquals(low)) == CmpBool::CmpTrue;
+    };
+  }
+  std::function<bool(const KeyType &)> is_after;
+  if (range.high_.has_value()) {
+    is_after = [key_schema, high = *range.high_, inclusive = range.high_inclusive_](const KeyType &key) {
+      auto value = key.ToValue(key_schema, 0);
+      if (value.IsNull()) {
+        return false;
+      }
+      return (inclusive ? value.CompareGreaterThan(high) : value.CompareGreaterThanEquals(high)) == CmpBool::CmpTrue;
+    };
+  }
+  if (descending) {
+    auto iter = is_after ? container_->RBeginAt(is_after) : container_->RBegin();
+    return std::make_unique<ReverseCursor>(std::move(iter), std::move(is_before), key_schema);
+  }
+  auto iter = is_before ? container_->BeginAt(is_before) : container_->Begin();
+  return std::make_unique<ForwardCursor>(std::move(iter), std::move(is_after), key_schema);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -63,7 +314,15 @@ auto BPLUSTREE_INDEX_TYPE::GetEndIterator() -> INDEXITERATOR_TYPE { return conta
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class BPlusTreeIndex<GenericKey<24>, RID, GenericComparator<24>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class BPlusTreeIndex<GenericKey<40>, RID, GenericComparator<40>>;
+template class BPlusTreeIndex<GenericKey<48>, RID, GenericComparator<48>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeIndex<GenericKey<96>, RID, GenericComparator<96>>;
+template class BPlusTreeIndex<GenericKey<8>, RID, IntegerComparator<8, int32_t>>;
+template class BPlusTreeIndex<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+template class BPlusTreeIndex<GenericKey<16>, RID, IntegerComparator<16, int32_t>>;
+template class BPlusTreeIndex<GenericKey<16>, RID, IntegerComparator<16, int64_t>>;
 
 }  // namespace bustub
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.cpp
+//
+// Identification: src/storage/index/bloom_filter.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/bloom_filter.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+namespace {
+
+/** The finalizer of murmur3, it spreads the weak column hashes over all 64 bits. */
+auto Mix(uint64_t hash) -> uint64_t {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+}  // namespace
+
+BloomFilter::BloomFilter(size_t expected_keys)
+    : expected_keys_(std::max(expected_keys, MIN_EXPECTED_KEYS)),
+      num_blocks_((expected_keys_ * BITS_PER_KEY + BLOCK_WORDS * 64 - 1) / (BLOCK_WORDS * 64)),
+      words_(num_blocks_ * BLOCK_WORDS) {}
+
+auto BloomFilter::BlockOf(hash_t hash) const -> size_t {
+  // the high half picks the block, the low half the bits within it
+  return static_cast<size_t>(((hash >> 32) * num_blocks_) >> 32) * BLOCK_WORDS;
+}
+
+void BloomFilter::Insert(hash_t hash) {
+  hash = Mix(hash);
+  auto block = BlockOf(hash);
+  auto probe = static_cast<uint32_t>(hash);
+  auto step = (probe >> 16) | 1;
+  for (uint32_t i = 0; i < NUM_PROBES; i++) {
+    auto bit = (probe + i * step) % (BLOCK_WORDS * 64);
+    words_[block + bit / 64].fetch_or(uint64_t{1} << (bit % 64), std::memory_order_relaxed);
+  }
+  insert_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto BloomFilter::MayContain(hash_t hash) const -> bool {
+  hash = Mix(hash);
+  auto block = BlockOf(hash);
+  auto probe = static_cast<uint32_t>(hash);
+  auto step = (probe >> 16) | 1;
+  for (uint32_t i = 0; i < NUM_PROBES; i++) {
+    auto bit = (probe + i * step) % (BLOCK_WORDS * 64);
+    if ((words_[block + bit / 64].load(std::memory_order_relaxed) & (uint64_t{1} << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace bustub
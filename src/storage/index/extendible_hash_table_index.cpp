@@ -1,7 +1,11 @@
+#include <memory>
 #include <vector>
 
 #include "storage/index/extendible_hash_table_index.h"
 
+#include "common/exception.h"
+#include "fmt/format.h"
+
 namespace bustub {
 /*
  * Constructor
@@ -12,10 +16,14 @@ HASH_TABLE_INDEX_TYPE::ExtendibleHashTableIndex(std::unique_ptr<IndexMetadata> &
                                                 const HashFunction<KeyType> &hash_fn)
     : Index(std::move(metadata)),
       comparator_(GetMetadata()->GetKeySchema()),
-      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, hash_fn) {}
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, hash_fn, IsUnique()) {}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  if (!KeyFits(key)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE,
+                    fmt::format("key of {} bytes does not fit into index {}", key.GetLength(), GetName()));
+  }
   // construct insert index key
   KeyType index_key;
   index_key.SetFromKey(key);
@@ -25,6 +33,10 @@ auto HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // a key that does not fit was never inserted
+  if (!KeyFits(key)) {
+    return;
+  }
   // construct delete index key
   KeyType index_key;
   index_key.SetFromKey(key);
@@ -34,16 +46,41 @@ void HASH_TABLE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  if (!KeyFits(key)) {
+    return;
+  }
   // construct scan index key
   KeyType index_key;
   index_key.SetFromKey(key);
 
   container_.GetValue(transaction, index_key, result);
 }
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_INDEX_TYPE::ScanRange(const IndexKeyRange &range, bool descending) -> std::unique_ptr<IndexScanCursor> {
+  if (GetIndexColumnCount() != 1 || !range.low_.has_value() || !range.high_.has_value() || !range.low_inclusive_ ||
+      !range.high_inclusive_ || range.low_->CompareEquals(*range.high_) != CmpBool::CmpTrue) {
+    throw NotImplementedException("hash index only supports point lookups");
+  }
+  // the probe hashes the key bytes, so the value has to be stored exactly like the column stores it
+  std::vector<Value> key_values{range.low_->CastAs(GetKeySchema()->GetColumn(0).GetType())};
+  Tuple key(key_values, GetKeySchema());
+  std::vector<RID> rids;
+  ScanKey(key, &rids, nullptr);
+  return std::make_unique<HashIndexCursor>(std::move(rids), std::move(key_values));
+}
 template class ExtendibleHashTableIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class ExtendibleHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class ExtendibleHashTableIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTableIndex<GenericKey<24>, RID, GenericComparator<24>>;
 template class ExtendibleHashTableIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTableIndex<GenericKey<40>, RID, GenericComparator<40>>;
+template class ExtendibleHashTableIndex<GenericKey<48>, RID, GenericComparator<48>>;
 template class ExtendibleHashTableIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class ExtendibleHashTableIndex<GenericKey<96>, RID, GenericComparator<96>>;
+template class ExtendibleHashTableIndex<GenericKey<8>, RID, IntegerComparator<8, int32_t>>;
+template class ExtendibleHashTableIndex<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+template class ExtendibleHashTableIndex<GenericKey<16>, RID, IntegerComparator<16, int32_t>>;
+template class ExtendibleHashTableIndex<GenericKey<16>, RID, IntegerComparator<16, int64_t>>;
 
 }  // namespace bustub
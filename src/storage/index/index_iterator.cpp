@@ -13,75 +13,226 @@
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
-
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, ReadPageGuard &&guard, ReadPageGuard &&head, int index)
-    : bpm_(bpm), guard_(std::move(guard)), head_(std::move(head)), index_(index) {
-  if (bpm_ != nullptr || index_ != -1) {
-    page_id_ = guard_.PageId();
-  } else {
-    page_id_ = INVALID_PAGE_ID;
-  }
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, const KeyComparator *comparator, ReadPageGuard &&head,
+                                  ReadPageGuard &&guard, int index)
+    : bpm_(bpm), comparator_(comparator), header_page_id_(head.PageId()) {
+  LoadBatch(std::move(head), std::move(guard), index);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { return page_id_ == INVALID_PAGE_ID; }
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return pos_ == batch_.size(); }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
-  auto *leafpage = guard_.As<LeafPage>();
-  return leafpage->KeyValueAt(index_);
-}
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return batch_[pos_]; }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
-  // from the present page to the next
-  if (!IsEnd()) {
-    auto leafpage = guard_.As<LeafPage>();
-    index_++;
-    if (index_ == leafpage->GetSize()) {
-      if (leafpage->GetNextPageId() == INVALID_PAGE_ID) {
-        bpm_ = nullptr;
-        guard_.Drop();
-        head_.Drop();
-        index_ = -1;
-        page_id_ = INVALID_PAGE_ID;
-        return *this;
-      }
-      guard_ = bpm_->FetchPageRead(leafpage->GetNextPageId());
-      index_ = 0;
-      page_id_ = guard_.PageId();
-    }
+  if (IsEnd() || ++pos_ < batch_.size()) {
+    return *this;
+  }
+  if (last_leaf_) {
+    batch_.clear();
+    pos_ = 0;
+    return *this;
   }
+  Reseek();
   return *this;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator==(const IndexIterator &itr) const -> bool {
-  if (page_id_ == INVALID_PAGE_ID) {
-    return itr.page_id_ == INVALID_PAGE_ID;
+  bool is_end = pos_ == batch_.size();
+  bool itr_is_end = itr.pos_ == itr.batch_.size();
+  if (is_end || itr_is_end) {
+    return is_end && itr_is_end;
   }
-  return page_id_ == itr.page_id_ && index_ == itr.index_;
+  return (*comparator_)(batch_[pos_].first, itr.batch_[itr.pos_].first) == 0;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator!=(const IndexIterator &itr) const -> bool { return !this->operator==(itr); }
 
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::LoadBatch(ReadPageGuard head, ReadPageGuard guard, int index) {
+  batch_.clear();
+  pos_ = 0;
+  auto *leaf = guard.As<LeafPage>();
+  // empty leaves only occur as the root of an emptied tree, but a re-seek may also land behind the last key of a leaf
+  while (index == leaf->GetSize() && leaf->GetNextPageId() != INVALID_PAGE_ID) {
+    guard = bpm_->FetchPageRead(leaf->GetNextPageId());
+    leaf = guard.As<LeafPage>();
+    index = 0;
+  }
+  for (int i = index; i < leaf->GetSize(); i++) {
+    batch_.push_back(leaf->KeyValueAt(i));
+  }
+  last_leaf_ = leaf->GetNextPageId() == INVALID_PAGE_ID;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Reseek() {
+  KeyType last_key = batch_.back().first;
+  ReadPageGuard head = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = head.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    batch_.clear();
+    pos_ = 0;
+    return;
+  }
+  ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    auto *internal_page = guard.As<InternalPage>();
+    guard = bpm_->FetchPageRead(internal_page->ValueAt(internal_page->LookupChildIndex(last_key, *comparator_)));
+  }
+  auto *leaf = guard.As<LeafPage>();
+  int left = 0;
+  int right = leaf->GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if ((*comparator_)(leaf->KeyAt(mid), last_key) <= 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  LoadBatch(std::move(head), std::move(guard), left);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+REVERSE_INDEXITERATOR_TYPE::ReverseIndexIterator(BufferPoolManager *bpm, const KeyComparator *comparator,
+                                                 ReadPageGuard &&head, ReadPageGuard &&guard, int count, bool leftmost)
+    : bpm_(bpm), comparator_(comparator), header_page_id_(head.PageId()) {
+  auto *leaf = guard.As<LeafPage>();
+  if (count > 0 || leftmost || leaf->GetSize() == 0) {
+    for (int i = count - 1; i >= 0; i--) {
+      batch_.push_back(leaf->KeyValueAt(i));
+    }
+    first_leaf_ = leftmost;
+    return;
+  }
+  // every key of the leaf is past the range, which ends in an earlier leaf
+  KeyType first_key = leaf->KeyAt(0);
+  guard.Drop();
+  head.Drop();
+  Reseek(first_key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+REVERSE_INDEXITERATOR_TYPE::~ReverseIndexIterator() = default;  // NOLINT
+
+INDEX_TEMPLATE_ARGUMENTS
+auto REVERSE_INDEXITERATOR_TYPE::operator*() -> const MappingType & { return batch_[pos_]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto REVERSE_INDEXITERATOR_TYPE::operator++() -> REVERSE_INDEXITERATOR_TYPE & {
+  if (IsEnd() || ++pos_ < batch_.size()) {
+    return *this;
+  }
+  if (first_leaf_) {
+    batch_.clear();
+    pos_ = 0;
+    return *this;
+  }
+  Reseek(batch_.back().first);
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void REVERSE_INDEXITERATOR_TYPE::Reseek(KeyType key) {
+  while (true) {
+    batch_.clear();
+    pos_ = 0;
+    ReadPageGuard head = bpm_->FetchPageRead(header_page_id_);
+    page_id_t page_id = head.As<BPlusTreeHeaderPage>()->root_page_id_;
+    if (page_id == INVALID_PAGE_ID) {
+      return;
+    }
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    bool leftmost = true;
+    KeyType separator{};
+    while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+      auto *internal_page = guard.As<InternalPage>();
+      // the last child whose separator sorts before `key`
+      int left = 1;
+      int right = internal_page->GetSize();
+      while (left < right) {
+        int mid = left + (right - left) / 2;
+        if ((*comparator_)(internal_page->KeyAt(mid), key) < 0) {
+          left = mid + 1;
+        } else {
+          right = mid;
+        }
+      }
+      if (left > 1) {
+        leftmost = false;
+        separator = internal_page->KeyAt(left - 1);
+      }
+      guard = bpm_->FetchPageRead(internal_page->ValueAt(left - 1));
+    }
+    auto *leaf = guard.As<LeafPage>();
+    int left = 0;
+    int right = leaf->GetSize();
+    while (left < right) {
+      int mid = left + (right - left) / 2;
+      if ((*comparator_)(leaf->KeyAt(mid), key) < 0) {
+        left = mid + 1;
+      } else {
+        right = mid;
+      }
+    }
+    if (left > 0 || leftmost) {
+      for (int i = left - 1; i >= 0; i--) {
+        batch_.push_back(leaf->KeyValueAt(i));
+      }
+      first_leaf_ = leftmost;
+      return;
+    }
+    // the leaf starts after its separator, so the keys before `key` sort before that separator as well
+    key = separator;
+  }
+}
+
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
+template class ReverseIndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
 template class IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
+template class ReverseIndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
 
 template class IndexIterator<GenericKey<16>, RID, GenericComparator<16>>;
+template class ReverseIndexIterator<GenericKey<16>, RID, GenericComparator<16>>;
+
+template class IndexIterator<GenericKey<24>, RID, GenericComparator<24>>;
+template class ReverseIndexIterator<GenericKey<24>, RID, GenericComparator<24>>;
 
 template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
+template class ReverseIndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
+
+template class IndexIterator<GenericKey<40>, RID, GenericComparator<40>>;
+template class ReverseIndexIterator<GenericKey<40>, RID, GenericComparator<40>>;
+
+template class IndexIterator<GenericKey<48>, RID, GenericComparator<48>>;
+template class ReverseIndexIterator<GenericKey<48>, RID, GenericComparator<48>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
+template class ReverseIndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class IndexIterator<GenericKey<96>, RID, GenericComparator<96>>;
+template class ReverseIndexIterator<GenericKey<96>, RID, GenericComparator<96>>;
+
+template class IndexIterator<GenericKey<8>, RID, IntegerComparator<8, int32_t>>;
+template class ReverseIndexIterator<GenericKey<8>, RID, IntegerComparator<8, int32_t>>;
+
+template class IndexIterator<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+template class ReverseIndexIterator<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+
+template class IndexIterator<GenericKey<16>, RID, IntegerComparator<16, int32_t>>;
+template class ReverseIndexIterator<GenericKey<16>, RID, IntegerComparator<16, int32_t>>;
+
+template class IndexIterator<GenericKey<16>, RID, IntegerComparator<16, int64_t>>;
+template class ReverseIndexIterator<GenericKey<16>, RID, IntegerComparator<16, int64_t>>;
 
 }  // namespace bustub
@@ -10,10 +10,12 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/macros.h"
@@ -34,15 +36,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
   SetPageType(IndexPageType::INTERNAL_PAGE);
   SetSize(0);
   SetMaxSize(max_size);
-}
-
-INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetInitVal(int max_size, const ValueType &left, const KeyType &mid,
-                                                const ValueType &right) {
-  Init(max_size);
-  array_[0].second = left;
-  array_[1] = std::make_pair(mid, right);
-  SetSize(2);
+  SetKeyLayout(0, 0);
 }
 
 /*
@@ -50,191 +44,267 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetInitVal(int max_size, const ValueType &l
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
+  KeyType key;
+  auto *bytes = reinterpret_cast<char *>(&key);
+  if (index == 0) {
+    memset(bytes, 0, sizeof(KeyType));
+    return key;
+  }
+  memcpy(bytes, data_, GetPrefixSize());
+  memcpy(bytes + GetPrefixSize(), EntryAt(index), GetKeyWidth());
+  memset(bytes + GetPrefixSize() + GetKeyWidth(), 0, sizeof(KeyType) - GetPrefixSize() - GetKeyWidth());
+  return key;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
-  // BUSTUB_ASSERT(index >= 0 && index < GetSize(), "index out of range");
-  array_[index].first = key;
+  BUSTUB_ASSERT(index > 0 && index < GetSize(), "index out of range");
+  auto layout = LayoutFor(key, GetSize(), index);
+  BUSTUB_ASSERT(layout.has_value(), "no space to store the key");
+  Relayout(*layout);
+  memcpy(EntryAt(index), reinterpret_cast<const char *>(&key) + GetPrefixSize(), GetKeyWidth());
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  memcpy(EntryAt(index) + GetKeyWidth(), &value, sizeof(ValueType));
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
-  auto it = std::find_if(array_, array_ + GetSize(), [&value](const auto &pair) { return pair.second == value; });
-  return std::distance(array_, it);
+  int index = 0;
+  while (index < GetSize() && ValueAt(index) != value) {
+    index++;
+  }
+  return index;
 }
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType {
+  ValueType value;
+  memcpy(&value, EntryAt(index) + GetKeyWidth(), sizeof(ValueType));
+  return value;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomFor(const KeyType &key) const -> bool {
+  return LayoutFor(key, GetSize() + 1).has_value();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomForAnyKey() const -> bool {
+  // no layout is wider than the full keys
+  return GetSize() + 1 <= static_cast<int>(INTERNAL_PAGE_SIZE);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomForKeyAt(int index, const KeyType &key) const -> bool {
+  return LayoutFor(key, GetSize(), index).has_value();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomFor(const BPlusTreeInternalPage *right, const KeyType &separator) const
+    -> bool {
+  KeyLayout<KeyType> layout;
+  for (int i = 1; i < GetSize(); i++) {
+    layout.Add(KeyAt(i));
+  }
+  layout.Add(separator);
+  for (int i = 1; i < right->GetSize(); i++) {
+    layout.Add(right->KeyAt(i));
+  }
+  return layout.Bytes(GetSize() + right->GetSize(), sizeof(ValueType)) <=
+         BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Layout() const -> KeyLayout<KeyType> {
+  if (GetSize() <= 1) {
+    return {};
+  }
+  return {data_, static_cast<size_t>(GetPrefixSize()), static_cast<size_t>(GetKeyWidth())};
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::LayoutFor(const KeyType &key, int count, int skip) const
+    -> std::optional<KeyLayout<KeyType>> {
+  constexpr size_t space = BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE;
+  // usually the key fits the current layout or widens it a little
+  auto layout = Layout();
+  layout.Add(key);
+  if (layout.Bytes(count, sizeof(ValueType)) <= space) {
+    return layout;
+  }
+  // the current layout may still make room for keys that are gone, start over from the keys left
+  layout = KeyLayout<KeyType>();
+  for (int i = 1; i < GetSize(); i++) {
+    if (i != skip) {
+      layout.Add(KeyAt(i));
+    }
+  }
+  layout.Add(key);
+  if (layout.Bytes(count, sizeof(ValueType)) <= space) {
+    return layout;
+  }
+  return std::nullopt;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Relayout(const KeyLayout<KeyType> &layout) {
+  if (GetSize() > 1 && layout == Layout()) {
+    return;
+  }
+  std::vector<std::pair<KeyType, ValueType>> entries;
+  entries.reserve(GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    entries.emplace_back(KeyAt(i), ValueAt(i));
+  }
+  SetKeyLayout(layout.PrefixSize(), layout.KeyWidth());
+  memcpy(data_, layout.Prefix(), layout.PrefixSize());
+  for (int i = 0; i < GetSize(); i++) {
+    memcpy(EntryAt(i), reinterpret_cast<const char *>(&entries[i].first) + GetPrefixSize(), GetKeyWidth());
+    SetValueAt(i, entries[i].second);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::EntryAt(int index) const -> const char * {
+  return data_ + GetPrefixSize() + index * (GetKeyWidth() + sizeof(ValueType));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::EntryAt(int index) -> char * {
+  return data_ + GetPrefixSize() + index * (GetKeyWidth() + sizeof(ValueType));
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::FindValue(const KeyType &key, const KeyComparator &comparator) const
     -> std::pair<ValueType, int> {
-  // use binarysearch to find the answer
-  int left = 1;
-  int right = GetSize() - 1;
-  while (left <= right) {
-    int mid = left + (right - left) / 2;
-    auto res = comparator(key, KeyAt(mid));
-    if (res < 0) {
-      right = mid - 1;
-    } else if (res > 0) {
-      left = mid + 1;
-    } else {
-      // find the answer
-      return std::make_pair(ValueAt(mid), mid);
-    }
+  int index = LookupChildIndex(key, comparator);
+  return std::make_pair(ValueAt(index), index);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::LookupChildIndex(const KeyType &key, const KeyComparator &comparator) const
+    -> int {
+  // the answer is always in [base, base + len), probes never touch index 0 since half >= 1
+  int base = 0;
+  int len = GetSize();
+  while (len > 1) {
+    int half = len / 2;
+    base = comparator(key, KeyAt(base + half)) >= 0 ? base + half : base;
+    len -= half;
   }
-  return std::make_pair(ValueAt(right), right);
+  return base;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertValueAt(const KeyType &key, const ValueType &value, int position) {
   int n = GetSize();
   BUSTUB_ASSERT(n + 1 <= GetMaxSize(), "can not insert data into a full internalpage");
-  BUSTUB_ASSERT(position >= 0 && position <= n, "position error");
-  for (auto i = GetSize(); i > position; i--) {
-    array_[i] = std::move(array_[i - 1]);
+  BUSTUB_ASSERT(position > 0 ? position <= n : n == 0, "position error");
+  if (position > 0) {
+    auto layout = LayoutFor(key, n + 1);
+    BUSTUB_ASSERT(layout.has_value(), "no space to store the data");
+    Relayout(*layout);
   }
-  array_[position] = std::make_pair(key, value);
+  memmove(EntryAt(position + 1), EntryAt(position), EntryAt(n) - EntryAt(position));
   IncreaseSize(1);
+  if (position > 0) {
+    memcpy(EntryAt(position), reinterpret_cast<const char *>(&key) + GetPrefixSize(), GetKeyWidth());
+  }
+  SetValueAt(position, value);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *newpage) {
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *newpage) -> KeyType {
   int size = GetSize() / 2;
   int startsize = GetSize() - size;
-  int newpagecursize = newpage->GetSize();
-  BUSTUB_ASSERT(newpagecursize + size <= newpage->GetMaxSize(), "no enough space to store the data");
-  for (int i = newpagecursize; i < newpagecursize + size; i++) {
-    newpage->array_[i] = std::move(this->array_[i - newpagecursize + startsize]);
+  BUSTUB_ASSERT(newpage->GetSize() == 0 && size > 0, "can only move to an empty page");
+  KeyType separator = KeyAt(startsize);
+  newpage->InsertValueAt(separator, ValueAt(startsize), 0);
+  for (int i = startsize + 1; i < GetSize(); i++) {
+    newpage->InsertValueAt(KeyAt(i), ValueAt(i), newpage->GetSize());
   }
-  newpage->IncreaseSize(size);
   this->IncreaseSize(-size);
+  return separator;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *newpage) {
-  int size = GetSize();
-  int newpagecursize = newpage->GetSize();
-  BUSTUB_ASSERT(newpagecursize + size <= newpage->GetMaxSize(), "no enough space to store the data");
-  for (int i = newpagecursize; i < newpagecursize + size; i++) {
-    newpage->array_[i] = std::move(this->array_[i - newpagecursize]);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *newpage, const KeyType &separator) {
+  for (int i = 0; i < GetSize(); i++) {
+    newpage->InsertValueAt(i == 0 ? separator : KeyAt(i), ValueAt(i), newpage->GetSize());
   }
-  newpage->IncreaseSize(size);
-  this->IncreaseSize(-size);
+  SetSize(0);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveBackToFront(BPlusTreeInternalPage *newpage) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveBackToFront(BPlusTreeInternalPage *newpage, KeyType *separator) {
   int size = GetSize();
   int newpagesize = newpage->GetSize();
-  BUSTUB_ASSERT(size > 0, "can not move any data");
-  BUSTUB_ASSERT(newpagesize + 1 <= newpage->GetMaxSize(), "no enough space to store the data");
-  for (int i = newpagesize; i >= 1; i--) {
-    newpage->array_[i] = std::move(newpage->array_[i - 1]);
+  BUSTUB_ASSERT(size > 1, "can not move any data");
+  if (newpagesize == 0) {
+    // nothing for the separator to go in front of
+    newpage->InsertValueAt(*separator, ValueAt(size - 1), 0);
+    *separator = KeyAt(size - 1);
+    this->IncreaseSize(-1);
+    return;
   }
-  newpage->array_[0] = std::move(this->array_[size - 1]);
+  BUSTUB_ASSERT(newpagesize + 1 <= newpage->GetMaxSize(), "no enough space to store the data");
+  // the separator goes down in front of the old first child of newpage, the key of the moved child comes up
+  auto layout = newpage->LayoutFor(*separator, newpagesize + 1);
+  BUSTUB_ASSERT(layout.has_value(), "no enough space to store the data");
+  newpage->Relayout(*layout);
+  memmove(newpage->EntryAt(1), newpage->EntryAt(0), newpage->EntryAt(newpagesize) - newpage->EntryAt(0));
   newpage->IncreaseSize(1);
+  memcpy(newpage->EntryAt(1), reinterpret_cast<const char *>(separator) + newpage->GetPrefixSize(),
+         newpage->GetKeyWidth());
+  newpage->SetValueAt(0, ValueAt(size - 1));
+  *separator = KeyAt(size - 1);
   this->IncreaseSize(-1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFrontToBack(BPlusTreeInternalPage *newpage) {
-  int size = GetSize();
-  int newpagesize = newpage->GetSize();
-  BUSTUB_ASSERT(size > 0, "can not move any data");
-  BUSTUB_ASSERT(newpagesize + 1 <= newpage->GetMaxSize(), "no enough space to store the data");
-  newpage->array_[newpagesize] = std::move(this->array_[0]);
-  for (int i = 0; i < size - 1; i++) {
-    this->array_[i] = std::move(this->array_[i + 1]);
-  }
-  newpage->IncreaseSize(1);
-  this->IncreaseSize(-1);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFrontToBack(BPlusTreeInternalPage *newpage, KeyType *separator) {
+  BUSTUB_ASSERT(GetSize() > 1, "can not move any data");
+  newpage->InsertValueAt(*separator, ValueAt(0), newpage->GetSize());
+  *separator = KeyAt(1);
+  RemoveByIndex(0);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveByIndex(int remove_index) {
   int size = GetSize();
   BUSTUB_ASSERT(remove_index < size, "index out of range");
-  for (int i = remove_index; i < size - 1; i++) {
-    array_[i] = std::move(array_[i + 1]);
-  }
-  IncreaseSize(-1);
-}
-
-INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::StoleFromLeftSibling(
-    BPlusTreeInternalPage<KeyType, ValueType, KeyComparator> *internal) {
-  for (int index = internal->GetSize(); index > 0; index--) {
-    internal->SetKeyAt(index, internal->KeyAt(index - 1));
-    internal->SetValueAt(index, internal->ValueAt(index - 1));
-  }
-  internal->SetKeyAt(0, KeyAt(GetSize() - 1));
-  internal->SetValueAt(0, ValueAt(GetSize() - 1));
+  memmove(EntryAt(remove_index), EntryAt(remove_index + 1), EntryAt(size) - EntryAt(remove_index + 1));
   IncreaseSize(-1);
-  internal->IncreaseSize(1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::StoleFromRightSibling(
-    BPlusTreeInternalPage<KeyType, ValueType, KeyComparator> *internal) {
-  internal->SetKeyAt(internal->GetSize(), KeyAt(0));
-  internal->SetValueAt(internal->GetSize(), ValueAt(0));
-  for (int index = 0; index < GetSize() - 1; index++) {
-    SetKeyAt(index, KeyAt(index + 1));
-    SetValueAt(index, ValueAt(index + 1));
-  }
-  IncreaseSize(-1);
-  internal->IncreaseSize(1);
-}
-
-INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemovePage(const KeyType &key, page_id_t removed_page, KeyComparator cmp) -> bool {
-  if (cmp(key, KeyAt(1)) < 0 && removed_page == ValueAt(0)) {
-    // we need to remove page zero
-    for (int index = 0; index < GetSize() - 1; index++) {
-      array_[index] = std::move(array_[index + 1]);
-    }
-    IncreaseSize(-1);
-  } else {
-    int index = 1;
-    for (; index < GetSize(); index++) {
-      if (cmp(key, KeyAt(index)) == 0 && ValueAt(index) == removed_page) {
-        break;
-      }
-    }
-    for (; index < GetSize() - 1; index++) {
-      array_[index] = std::move(array_[index + 1]);
-    }
-    IncreaseSize(-1);
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemovePage(page_id_t removed_page) -> bool {
+  int index = ValueIndex(removed_page);
+  if (index == GetSize()) {
+    return false;
   }
+  RemoveByIndex(index);
   return true;
 }
 
-INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CombieWithRightSibling(
-    BPlusTreeInternalPage<KeyType, ValueType, KeyComparator> *right_sibling) {
-  SetKeyAt(GetSize(), right_sibling->KeyAt(0));
-  SetValueAt(GetSize(), right_sibling->ValueAt(0));
-  for (int i = 1; i < right_sibling->GetSize(); i++) {
-    SetKeyAt(GetSize() + i, right_sibling->KeyAt(i));
-    SetValueAt(GetSize() + i, right_sibling->ValueAt(i));
-  }
-  SetSize(GetSize() + right_sibling->GetSize());
-  right_sibling->SetSize(0);
-}
-
-// valuetype for internalNode should be page id_t
 template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
 template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
+template class BPlusTreeInternalPage<GenericKey<24>, page_id_t, GenericComparator<24>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
+template class BPlusTreeInternalPage<GenericKey<40>, page_id_t, GenericComparator<40>>;
+template class BPlusTreeInternalPage<GenericKey<48>, page_id_t, GenericComparator<48>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+template class BPlusTreeInternalPage<GenericKey<96>, page_id_t, GenericComparator<96>>;
+template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, IntegerComparator<8, int32_t>>;
+template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, IntegerComparator<8, int64_t>>;
+template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, IntegerComparator<16, int32_t>>;
+template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, IntegerComparator<16, int64_t>>;
 }  // namespace bustub
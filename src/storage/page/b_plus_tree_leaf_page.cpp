@@ -9,9 +9,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstring>
 #include <set>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -36,6 +38,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(int max_size) {
   SetPageType(IndexPageType::LEAF_PAGE);
   SetSize(0);
   SetMaxSize(max_size);
+  SetKeyLayout(0, 0);
   SetNextPageId(INVALID_PAGE_ID);
 }
 
@@ -55,23 +58,117 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_pa
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
   // BUSTUB_ASSERT(index >= 0 && index < GetSize(), "index out of range");
-  return array_[index].first;
+  KeyType key;
+  auto *bytes = reinterpret_cast<char *>(&key);
+  memcpy(bytes, data_, GetPrefixSize());
+  memcpy(bytes + GetPrefixSize(), EntryAt(index), GetKeyWidth());
+  memset(bytes + GetPrefixSize() + GetKeyWidth(), 0, sizeof(KeyType) - GetPrefixSize() - GetKeyWidth());
+  return key;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType {
   // BUSTUB_ASSERT(index >= 0 && index < GetSize(), "index out of range");
-  return array_[index].second;
+  ValueType value;
+  memcpy(&value, EntryAt(index) + GetKeyWidth(), sizeof(ValueType));
+  return value;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyValueAt(int index) const -> const MappingType & { return array_[index]; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyValueAt(int index) const -> MappingType {
+  return std::make_pair(KeyAt(index), ValueAt(index));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  BUSTUB_ASSERT(index >= 0 && index < GetSize(), "index out of range");
+  auto layout = LayoutFor(key, GetSize(), index);
+  BUSTUB_ASSERT(layout.has_value(), "no space to store the key");
+  Relayout(*layout);
+  memcpy(EntryAt(index), reinterpret_cast<const char *>(&key) + GetPrefixSize(), GetKeyWidth());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  memcpy(EntryAt(index) + GetKeyWidth(), &value, sizeof(ValueType));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomFor(const KeyType &key) const -> bool {
+  return LayoutFor(key, GetSize() + 1).has_value();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomFor(const BPlusTreeLeafPage *other) const -> bool {
+  KeyLayout<KeyType> layout;
+  for (int i = 0; i < GetSize(); i++) {
+    layout.Add(KeyAt(i));
+  }
+  for (int i = 0; i < other->GetSize(); i++) {
+    layout.Add(other->KeyAt(i));
+  }
+  return layout.Bytes(GetSize() + other->GetSize(), sizeof(ValueType)) <= BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Layout() const -> KeyLayout<KeyType> {
+  if (GetSize() == 0) {
+    return {};
+  }
+  return {data_, static_cast<size_t>(GetPrefixSize()), static_cast<size_t>(GetKeyWidth())};
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::LayoutFor(const KeyType &key, int count, int skip) const
+    -> std::optional<KeyLayout<KeyType>> {
+  constexpr size_t space = BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE;
+  // usually the key fits the current layout or widens it a little
+  auto layout = Layout();
+  layout.Add(key);
+  if (layout.Bytes(count, sizeof(ValueType)) <= space) {
+    return layout;
+  }
+  // the current layout may still make room for keys that are gone, start over from the keys left
+  layout = KeyLayout<KeyType>();
+  for (int i = 0; i < GetSize(); i++) {
+    if (i != skip) {
+      layout.Add(KeyAt(i));
+    }
+  }
+  layout.Add(key);
+  if (layout.Bytes(count, sizeof(ValueType)) <= space) {
+    return layout;
+  }
+  return std::nullopt;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Relayout(const KeyLayout<KeyType> &layout) {
+  if (GetSize() > 0 && layout == Layout()) {
+    return;
+  }
+  std::vector<MappingType> entries;
+  entries.reserve(GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    entries.push_back(KeyValueAt(i));
+  }
+  SetKeyLayout(layout.PrefixSize(), layout.KeyWidth());
+  memcpy(data_, layout.Prefix(), layout.PrefixSize());
+  for (int i = 0; i < GetSize(); i++) {
+    memcpy(EntryAt(i), reinterpret_cast<const char *>(&entries[i].first) + GetPrefixSize(), GetKeyWidth());
+    SetValueAt(i, entries[i].second);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::EntryAt(int index) const -> const char * {
+  return data_ + GetPrefixSize() + index * (GetKeyWidth() + sizeof(ValueType));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::EntryAt(int index) -> char * {
+  return data_ + GetPrefixSize() + index * (GetKeyWidth() + sizeof(ValueType));
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::FindValueIndex(const KeyType &key, const KeyComparator &comparator) const
@@ -113,9 +210,8 @@ INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::InsertValue(const KeyType &key, const ValueType &value,
                                              const KeyComparator &comparator) -> bool {
   // insert node into the leaf page
-  int n = GetSize();
   int startindex = 0;
-  if (n != 0) {
+  if (GetSize() != 0) {
     auto findval = FindValueIndex(key, comparator);
     if (findval.second) {
       // if user try to insert duplicate keys return false
@@ -123,13 +219,7 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::InsertValue(const KeyType &key, const ValueType
     }
     startindex = findval.first;
   }
-  // can not insert into a full leaf
-  BUSTUB_ASSERT(n + 1 <= GetMaxSize(), "no space to store the data");
-  for (auto i = GetSize(); i > startindex; i--) {
-    array_[i] = std::move(array_[i - 1]);
-  }
-  array_[startindex] = std::make_pair(key, value);
-  IncreaseSize(1);
+  InsertValueAt(key, value, startindex);
   // std::cout<<"b_plus_tree_leaf_page: insert data successfully"<<std::endl;
   return true;
 }
@@ -139,135 +229,93 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertValueAt(const KeyType &key, const ValueTy
   int n = GetSize();
   BUSTUB_ASSERT(n + 1 <= GetMaxSize(), "can not insert data into a full leafpage");
   BUSTUB_ASSERT(position >= 0 && position <= n, "position error");
-  for (auto i = GetSize(); i > position; i--) {
-    array_[i] = std::move(array_[i - 1]);
-  }
-  array_[position] = std::make_pair(key, value);
+  auto layout = LayoutFor(key, n + 1);
+  BUSTUB_ASSERT(layout.has_value(), "no space to store the data");
+  Relayout(*layout);
+  memmove(EntryAt(position + 1), EntryAt(position), EntryAt(n) - EntryAt(position));
   IncreaseSize(1);
+  memcpy(EntryAt(position), reinterpret_cast<const char *>(&key) + GetPrefixSize(), GetKeyWidth());
+  SetValueAt(position, value);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *newpage) {
   int size = GetSize() / 2;
   int startsize = GetSize() - size;
-  int newpagecursize = newpage->GetSize();
-  BUSTUB_ASSERT(newpagecursize + size <= newpage->GetMaxSize(), "no enough space to store the data");
-  for (int i = newpagecursize; i < newpagecursize + size; i++) {
-    newpage->array_[i] = std::move(this->array_[i - newpagecursize + startsize]);
+  for (int i = startsize; i < GetSize(); i++) {
+    newpage->InsertValueAt(KeyAt(i), ValueAt(i), newpage->GetSize());
   }
-  newpage->IncreaseSize(size);
   this->IncreaseSize(-size);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *newpage) {
-  int size = GetSize();
-  int newpagecursize = newpage->GetSize();
-  BUSTUB_ASSERT(newpagecursize + size <= newpage->GetMaxSize(), "no enough space to store the data");
-  for (int i = newpagecursize; i < newpagecursize + size; i++) {
-    newpage->array_[i] = std::move(this->array_[i - newpagecursize]);
+  for (int i = 0; i < GetSize(); i++) {
+    newpage->InsertValueAt(KeyAt(i), ValueAt(i), newpage->GetSize());
   }
-  newpage->IncreaseSize(size);
-  this->IncreaseSize(-size);
+  SetSize(0);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveByIndex(int remove_index) {
   int size = GetSize();
   BUSTUB_ASSERT(remove_index < size, "index out of range");
-  for (int i = remove_index; i < size - 1; i++) {
-    array_[i] = std::move(array_[i + 1]);
-  }
+  memmove(EntryAt(remove_index), EntryAt(remove_index + 1), EntryAt(size) - EntryAt(remove_index + 1));
   IncreaseSize(-1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveBackToFront(BPlusTreeLeafPage *newpage) {
-  int size = GetSize();
-  int newpagesize = newpage->GetSize();
-  BUSTUB_ASSERT(size > 0, "can not move any data");
-  BUSTUB_ASSERT(newpagesize + 1 <= newpage->GetMaxSize(), "no enough space to store the data");
-  for (int i = newpagesize; i >= 1; i--) {
-    newpage->array_[i] = std::move(newpage->array_[i - 1]);
-  }
-  newpage->array_[0] = std::move(this->array_[size - 1]);
-  newpage->IncreaseSize(1);
+  BUSTUB_ASSERT(GetSize() > 0, "can not move any data");
+  newpage->InsertValueAt(KeyAt(GetSize() - 1), ValueAt(GetSize() - 1), 0);
   this->IncreaseSize(-1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFrontToBack(BPlusTreeLeafPage *newpage) {
-  int size = GetSize();
-  int newpagesize = newpage->GetSize();
-  BUSTUB_ASSERT(size > 0, "can not move any data");
-  BUSTUB_ASSERT(newpagesize + 1 <= newpage->GetMaxSize(), "no enough space to store the data");
-  newpage->array_[newpagesize] = std::move(this->array_[0]);
-  for (int i = 0; i < size - 1; i++) {
-    this->array_[i] = std::move(this->array_[i + 1]);
-  }
-  newpage->IncreaseSize(1);
-  this->IncreaseSize(-1);
+  BUSTUB_ASSERT(GetSize() > 0, "can not move any data");
+  newpage->InsertValueAt(KeyAt(0), ValueAt(0), newpage->GetSize());
+  RemoveByIndex(0);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::DeleteKeyFromNode(const KeyType &key, KeyComparator cmp) -> bool {
-  int index = -1;
-  for (int i = 0; i < GetSize(); i++) {
-    if (cmp(key, KeyAt(i)) == 0) {
-      index = i;
-    }
-  }
-  if (index == -1) {
+  auto findval = FindValueIndex(key, cmp);
+  if (!findval.second) {
     return false;
   }
-  while (index < GetSize() - 1) {
-    SetKeyAt(index, KeyAt(index + 1));
-    SetValueAt(index, ValueAt(index + 1));
-    index++;
-  }
-  SetSize(GetSize() - 1);
+  RemoveByIndex(findval.first);
   return true;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::StoleLastElement(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *thief) {
-  for (int index = thief->GetSize(); index > 0; index--) {
-    thief->SetKeyAt(index, thief->KeyAt(index - 1));
-    thief->SetValueAt(index, thief->ValueAt(index - 1));
-  }
-  thief->SetKeyAt(0, KeyAt(GetSize() - 1));
-  thief->SetValueAt(0, ValueAt(GetSize() - 1));
-  SetSize(GetSize() - 1);
-  thief->SetSize(thief->GetSize() + 1);
+  MoveBackToFront(thief);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::StoleFirstElement(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *thief) {
-  thief->SetKeyAt(thief->GetSize(), KeyAt(0));
-  thief->SetValueAt(thief->GetSize(), ValueAt(0));
-  for (int index = 0; index < GetSize() - 1; index++) {
-    SetKeyAt(index, KeyAt(index + 1));
-    SetValueAt(index, ValueAt(index + 1));
-  }
-  SetSize(GetSize() - 1);
-  thief->SetSize(thief->GetSize() + 1);
+  MoveFrontToBack(thief);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::CombineWithRightSibling(
     BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *right_sibling) {
-  for (int index = 0; index < right_sibling->GetSize(); index++) {
-    SetKeyAt(GetSize() + index, right_sibling->KeyAt(index));
-    SetValueAt(GetSize() + index, right_sibling->ValueAt(index));
-  }
-  SetSize(GetSize() + right_sibling->GetSize());
-  right_sibling->SetSize(0);
+  right_sibling->MoveAllTo(this);
   SetNextPageId(right_sibling->GetNextPageId());
 }
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BPlusTreeLeafPage<GenericKey<24>, RID, GenericComparator<24>>;
 template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BPlusTreeLeafPage<GenericKey<40>, RID, GenericComparator<40>>;
+template class BPlusTreeLeafPage<GenericKey<48>, RID, GenericComparator<48>>;
 template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeLeafPage<GenericKey<96>, RID, GenericComparator<96>>;
+template class BPlusTreeLeafPage<GenericKey<8>, RID, IntegerComparator<8, int32_t>>;
+template class BPlusTreeLeafPage<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+template class BPlusTreeLeafPage<GenericKey<16>, RID, IntegerComparator<16, int32_t>>;
+template class BPlusTreeLeafPage<GenericKey<16>, RID, IntegerComparator<16, int64_t>>;
 }  // namespace bustub
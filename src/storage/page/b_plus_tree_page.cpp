@@ -40,4 +40,14 @@ void BPlusTreePage::SetMaxSize(int size) { max_size_ = size; }
  */
 auto BPlusTreePage::GetMinSize() const -> int { return max_size_ / 2; }
 
+/*
+ * Helper methods to get/set how the keys of the page are stored
+ */
+auto BPlusTreePage::GetPrefixSize() const -> int { return prefix_size_; }
+auto BPlusTreePage::GetKeyWidth() const -> int { return key_width_; }
+void BPlusTreePage::SetKeyLayout(int prefix_size, int key_width) {
+  prefix_size_ = prefix_size;
+  key_width_ = key_width;
+}
+
 }  // namespace bustub
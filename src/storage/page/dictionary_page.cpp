@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// dictionary_page.cpp
+//
+// Identification: src/storage/page/dictionary_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/dictionary_page.h"
+
+#include <cstring>
+
+namespace bustub {
+
+void DictionaryPage::Init() {
+  next_page_id_ = INVALID_PAGE_ID;
+  num_entries_ = 0;
+  free_space_offset_ = DICTIONARY_PAGE_HEADER_SIZE;
+}
+
+auto DictionaryPage::AppendEntry(std::string_view entry) -> bool {
+  auto size = static_cast<uint32_t>(entry.size());
+  if (free_space_offset_ + sizeof(uint32_t) + size > BUSTUB_PAGE_SIZE) {
+    return false;
+  }
+  memcpy(page_start_ + free_space_offset_, &size, sizeof(uint32_t));
+  memcpy(page_start_ + free_space_offset_ + sizeof(uint32_t), entry.data(), size);
+  free_space_offset_ += sizeof(uint32_t) + size;
+  num_entries_++;
+  return true;
+}
+
+auto DictionaryPage::GetEntries() const -> std::vector<std::string> {
+  std::vector<std::string> entries;
+  entries.reserve(num_entries_);
+  uint32_t offset = DICTIONARY_PAGE_HEADER_SIZE;
+  for (uint32_t i = 0; i < num_entries_; i++) {
+    uint32_t size;
+    memcpy(&size, page_start_ + offset, sizeof(uint32_t));
+    entries.emplace_back(page_start_ + offset + sizeof(uint32_t), size);
+    offset += sizeof(uint32_t) + size;
+  }
+  return entries;
+}
+
+}  // namespace bustub
@@ -11,71 +11,190 @@
 //===----------------------------------------------------------------------===//
 
 #include "storage/page/hash_table_bucket_page.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "common/logger.h"
 #include "common/util/hash_util.h"
+#include "murmur3/MurmurHash3.h"
 #include "storage/index/generic_key.h"
 #include "storage/index/hash_comparator.h"
 #include "storage/table/tmp_tuple.h"
 
 namespace bustub {
 
+namespace {
+
+/** @return a mask with bit i set if the i-th of the 16 control bytes at `ctrls` equals `ctrl` */
+inline auto MatchGroup(const uint8_t *ctrls, uint8_t ctrl) -> uint32_t {
+#ifdef __SSE2__
+  __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrls));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(ctrl))));
+#else
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < BUCKET_CTRL_GROUP_SIZE; i++) {
+    mask |= static_cast<uint32_t>(ctrls[i] == ctrl) << i;
+  }
+  return mask;
+#endif
+}
+
+/** @return a mask with bit i set if the i-th of the 16 control bytes at `ctrls` has its high bit set */
+inline auto FullGroup(const uint8_t *ctrls) -> uint32_t {
+#ifdef __SSE2__
+  return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrls)));
+#else
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < BUCKET_CTRL_GROUP_SIZE; i++) {
+    mask |= static_cast<uint32_t>(ctrls[i] >> 7) << i;
+  }
+  return mask;
+#endif
+}
+
+}  // namespace
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
+auto HASH_TABLE_BUCKET_TYPE::TagOf(const KeyType &key) -> uint8_t {
+  // the directory indexes by the low bits of the table's hash, the tag comes from an unrelated hash
+  auto hash = static_cast<uint32_t>(murmur3::MurmurHash3_x86_32(&key, sizeof(KeyType), 0));
+  return CTRL_FULL | static_cast<uint8_t>(hash >> 25);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+auto HASH_TABLE_BUCKET_TYPE::MatchCtrl(uint8_t ctrl, Visitor &&visit) const -> bool {
+  for (uint32_t group = 0; group < BUCKET_CTRL_SIZE; group += BUCKET_CTRL_GROUP_SIZE) {
+    uint32_t match = MatchGroup(ctrl_ + group, ctrl);
+    uint32_t empty = MatchGroup(ctrl_ + group, CTRL_EMPTY);
+    if (empty != 0) {
+      // slots are taken front to back, so the first never-used slot ends the bucket
+      match &= (empty & (~empty + 1)) - 1;
+    }
+    for (; match != 0; match &= match - 1) {
+      if (visit(group + __builtin_ctz(match))) {
+        return true;
+      }
+    }
+    if (empty != 0) {
+      break;
+    }
+  }
   return false;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
+  bool found = false;
+  MatchCtrl(TagOf(key), [&](uint32_t bucket_idx) {
+    if (cmp(array_[bucket_idx].first, key) == 0) {
+      result->push_back(array_[bucket_idx].second);
+      found = true;
+    }
+    return false;
+  });
+  return found;
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool {
-  return true;
+  uint8_t tag = TagOf(key);
+  bool duplicate = MatchCtrl(tag, [&](uint32_t bucket_idx) {
+    return cmp(array_[bucket_idx].first, key) == 0 && array_[bucket_idx].second == value;
+  });
+  if (duplicate) {
+    return false;
+  }
+  // reuse the first tombstone or never-used slot
+  for (uint32_t group = 0; group < BUCKET_CTRL_SIZE; group += BUCKET_CTRL_GROUP_SIZE) {
+    uint32_t free = ~FullGroup(ctrl_ + group) & ((1U << BUCKET_CTRL_GROUP_SIZE) - 1);
+    if (free == 0) {
+      continue;
+    }
+    uint32_t bucket_idx = group + __builtin_ctz(free);
+    if (bucket_idx >= BUCKET_ARRAY_SIZE) {
+      break;
+    }
+    array_[bucket_idx] = MappingType(key, value);
+    ctrl_[bucket_idx] = tag;
+    return true;
+  }
+  return false;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool {
-  return false;
+  return MatchCtrl(TagOf(key), [&](uint32_t bucket_idx) {
+    if (cmp(array_[bucket_idx].first, key) == 0 && array_[bucket_idx].second == value) {
+      RemoveAt(bucket_idx);
+      return true;
+    }
+    return false;
+  });
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::KeyAt(uint32_t bucket_idx) const -> KeyType {
-  return {};
+  return array_[bucket_idx].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::ValueAt(uint32_t bucket_idx) const -> ValueType {
-  return {};
+  return array_[bucket_idx].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
+  // the slot stays occupied as a tombstone so that scans keep going past it
+  ctrl_[bucket_idx] = CTRL_DELETED;
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsOccupied(uint32_t bucket_idx) const -> bool {
-  return false;
+  return ctrl_[bucket_idx] != CTRL_EMPTY;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {
+  if (ctrl_[bucket_idx] == CTRL_EMPTY) {
+    ctrl_[bucket_idx] = CTRL_DELETED;
+  }
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsReadable(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (ctrl_[bucket_idx] & CTRL_FULL) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {
+  ctrl_[bucket_idx] = TagOf(array_[bucket_idx].first);
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsFull() -> bool {
-  return false;
+  return NumReadable() == BUCKET_ARRAY_SIZE;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::NumReadable() -> uint32_t {
-  return 0;
+  uint32_t count = 0;
+  for (uint32_t group = 0; group < BUCKET_CTRL_SIZE; group += BUCKET_CTRL_GROUP_SIZE) {
+    count += __builtin_popcount(FullGroup(ctrl_ + group));
+  }
+  return count;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsEmpty() -> bool {
-  return false;
+  for (uint32_t group = 0; group < BUCKET_CTRL_SIZE; group += BUCKET_CTRL_GROUP_SIZE) {
+    if (FullGroup(ctrl_ + group) != 0) {
+      return false;
+    }
+  }
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -106,8 +225,16 @@ template class HashTableBucketPage<int, int, IntComparator>;
 template class HashTableBucketPage<GenericKey<4>, RID, GenericComparator<4>>;
 template class HashTableBucketPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class HashTableBucketPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class HashTableBucketPage<GenericKey<24>, RID, GenericComparator<24>>;
 template class HashTableBucketPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class HashTableBucketPage<GenericKey<40>, RID, GenericComparator<40>>;
+template class HashTableBucketPage<GenericKey<48>, RID, GenericComparator<48>>;
 template class HashTableBucketPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class HashTableBucketPage<GenericKey<96>, RID, GenericComparator<96>>;
+template class HashTableBucketPage<GenericKey<8>, RID, IntegerComparator<8, int32_t>>;
+template class HashTableBucketPage<GenericKey<8>, RID, IntegerComparator<8, int64_t>>;
+template class HashTableBucketPage<GenericKey<16>, RID, IntegerComparator<16, int32_t>>;
+template class HashTableBucketPage<GenericKey<16>, RID, IntegerComparator<16, int64_t>>;
 
 // template class HashTableBucketPage<hash_t, TmpTuple, HashComparator>;
 
@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_dictionary.cpp
+//
+// Identification: src/storage/table/table_dictionary.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/table_dictionary.h"
+
+#include <mutex>  // NOLINT
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/page/dictionary_page.h"
+#include "storage/page/page_guard.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** Encoded VARCHAR columns are stored as INTEGER codes, everything else keeps its type. */
+auto MakeStorageSchema(const Schema &schema) -> Schema {
+  std::vector<Column> columns;
+  columns.reserve(schema.GetColumnCount());
+  for (const auto &column : schema.GetColumns()) {
+    if (column.IsDictionaryEncoded()) {
+      columns.emplace_back(column.GetName(), TypeId::INTEGER);
+    } else {
+      columns.push_back(column);
+    }
+  }
+  return Schema{columns};
+}
+
+}  // namespace
+
+TableDictionary::TableDictionary(BufferPoolManager *bpm, const Schema &schema)
+    : bpm_(bpm), schema_(schema), storage_schema_(MakeStorageSchema(schema)), encoded_(schema.GetColumnCount()) {
+  for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+    encoded_[i] = schema_.GetColumn(i).IsDictionaryEncoded();
+  }
+  auto guard = bpm_->NewPageGuarded(&first_page_id_);
+  BUSTUB_ENSURE(first_page_id_ != INVALID_PAGE_ID, "cannot allocate dictionary page");
+  guard.AsMut<DictionaryPage>()->Init();
+  last_page_id_ = first_page_id_;
+}
+
+TableDictionary::TableDictionary(BufferPoolManager *bpm, const Schema &schema, page_id_t first_page_id)
+    : bpm_(bpm),
+      schema_(schema),
+      storage_schema_(MakeStorageSchema(schema)),
+      encoded_(schema.GetColumnCount()),
+      first_page_id_(first_page_id) {
+  for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+    encoded_[i] = schema_.GetColumn(i).IsDictionaryEncoded();
+  }
+  // entries are stored in code order, so replaying the chain rebuilds the exact same codes
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = bpm_->FetchPageRead(page_id);
+    const auto *page = guard.As<DictionaryPage>();
+    for (auto &entry : page->GetEntries()) {
+      codes_.emplace(entry, static_cast<int32_t>(strings_.size()));
+      strings_.push_back(std::move(entry));
+    }
+    last_page_id_ = page_id;
+    page_id = page->GetNextPageId();
+  }
+}
+
+auto TableDictionary::Size() const -> size_t {
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  return strings_.size();
+}
+
+auto TableDictionary::Encode(const std::string &str) -> int32_t {
+  {
+    std::shared_lock<std::shared_mutex> guard(latch_);
+    auto iter = codes_.find(str);
+    if (iter != codes_.end()) {
+      return iter->second;
+    }
+  }
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  // another writer may have added it between the two latches
+  auto iter = codes_.find(str);
+  if (iter != codes_.end()) {
+    return iter->second;
+  }
+  if (str.size() > DictionaryPage::MAX_ENTRY_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "string is too large for a dictionary encoded column");
+  }
+  PersistEntry(str);
+  auto code = static_cast<int32_t>(strings_.size());
+  codes_.emplace(str, code);
+  strings_.push_back(str);
+  return code;
+}
+
+auto TableDictionary::Lookup(const std::string &str) const -> std::optional<int32_t> {
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  auto iter = codes_.find(str);
+  if (iter == codes_.end()) {
+    return std::nullopt;
+  }
+  return iter->second;
+}
+
+auto TableDictionary::Decode(int32_t code) const -> std::string {
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  BUSTUB_ASSERT(code >= 0 && static_cast<size_t>(code) < strings_.size(), "unknown dictionary code");
+  return strings_[code];
+}
+
+auto TableDictionary::EncodeTuple(const Tuple &tuple) -> Tuple {
+  std::vector<Value> values;
+  values.reserve(schema_.GetColumnCount());
+  for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+    auto value = tuple.GetValue(&schema_, i);
+    if (!encoded_[i]) {
+      values.push_back(std::move(value));
+    } else if (value.IsNull()) {
+      values.push_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+    } else {
+      values.push_back(ValueFactory::GetIntegerValue(Encode(value.ToString())));
+    }
+  }
+  return {values, &storage_schema_};
+}
+
+auto TableDictionary::DecodeTuple(const Tuple &tuple) const -> Tuple {
+  std::vector<Value> values;
+  values.reserve(schema_.GetColumnCount());
+  for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+    auto value = tuple.GetValue(&storage_schema_, i);
+    if (!encoded_[i]) {
+      values.push_back(std::move(value));
+    } else if (value.IsNull()) {
+      values.push_back(ValueFactory::GetNullValueByType(TypeId::VARCHAR));
+    } else {
+      values.push_back(ValueFactory::GetVarcharValue(Decode(value.GetAs<int32_t>())));
+    }
+  }
+  Tuple decoded{values, &schema_};
+  decoded.rid_ = tuple.rid_;
+  return decoded;
+}
+
+void TableDictionary::PersistEntry(const std::string &str) {
+  auto guard = bpm_->FetchPageWrite(last_page_id_);
+  if (guard.AsMut<DictionaryPage>()->AppendEntry(str)) {
+    return;
+  }
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  auto next_guard = bpm_->NewPageGuarded(&next_page_id);
+  BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate dictionary page");
+  auto next_page = next_guard.AsMut<DictionaryPage>();
+  next_page->Init();
+  BUSTUB_ENSURE(next_page->AppendEntry(str), "dictionary entry does not fit in an empty page");
+  guard.AsMut<DictionaryPage>()->SetNextPageId(next_page_id);
+  last_page_id_ = next_page_id;
+}
+
+}  // namespace bustub
@@ -38,11 +38,15 @@ TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
 
 auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr, Transaction *txn,
                             table_oid_t oid) -> std::optional<RID> {
+  // encode outside of the heap latch, a new string may need a dictionary page of its own
+  auto stored = dictionary_ != nullptr ? dictionary_->EncodeTuple(tuple) : Tuple{};
+  const auto &stored_tuple = dictionary_ != nullptr ? stored : tuple;
+
   std::unique_lock<std::mutex> guard(latch_);
   auto page_guard = bpm_->FetchPageWrite(last_page_id_);
   while (true) {
     auto page = page_guard.AsMut<TablePage>();
-    if (page->GetNextTupleOffset(meta, tuple) != std::nullopt) {
+    if (page->GetNextTupleOffset(meta, stored_tuple) != std::nullopt) {
       break;
     }
 
@@ -70,7 +74,11 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
   auto last_page_id = last_page_id_;
 
   auto page = page_guard.AsMut<TablePage>();
-  auto slot_id = *page->InsertTuple(meta, tuple);
+  auto slot_id = *page->InsertTuple(meta, stored_tuple);
+  // update the zone before the page becomes visible to scans
+  if (zone_map_ != nullptr) {
+    zone_map_->Insert(last_page_id, tuple);
+  }
 
   // only allow one insertion at a time, otherwise it will deadlock.
   guard.unlock();
@@ -95,10 +103,20 @@ auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
   auto page = page_guard.As<TablePage>();
   auto [meta, tuple] = page->GetTuple(rid);
+  page_guard.Drop();
+  if (dictionary_ != nullptr) {
+    tuple = dictionary_->DecodeTuple(tuple);
+  }
   tuple.rid_ = rid;
   return std::make_pair(meta, std::move(tuple));
 }
 
+auto TableHeap::GetTupleView(RID rid, ReadPageGuard *guard) -> std::pair<TupleMeta, TupleView> {
+  *guard = bpm_->FetchPageRead(rid.GetPageId());
+  auto page = guard->As<TablePage>();
+  return page->GetTupleView(rid);
+}
+
 auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
   auto page = page_guard.As<TablePage>();
@@ -118,9 +136,13 @@ auto TableHeap::MakeIterator() -> TableIterator {
 auto TableHeap::MakeEagerIterator() -> TableIterator { return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}}; }
 
 void TableHeap::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
+  auto stored = dictionary_ != nullptr ? dictionary_->EncodeTuple(tuple) : Tuple{};
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
   auto page = page_guard.AsMut<TablePage>();
-  page->UpdateTupleInPlaceUnsafe(meta, tuple, rid);
+  page->UpdateTupleInPlaceUnsafe(meta, dictionary_ != nullptr ? stored : tuple, rid);
+  if (zone_map_ != nullptr) {
+    zone_map_->Insert(rid.GetPageId(), tuple);
+  }
 }
 
 }  // namespace bustub
@@ -33,6 +33,10 @@ TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
 
 auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_); }
 
+auto TableIterator::GetTupleView(ReadPageGuard *guard) -> std::pair<TupleMeta, TupleView> {
+  return table_heap_->GetTupleView(rid_, guard);
+}
+
 auto TableIterator::GetRID() -> RID { return rid_; }
 
 auto TableIterator::IsEnd() -> bool { return rid_.GetPageId() == INVALID_PAGE_ID; }
@@ -67,4 +71,20 @@ auto TableIterator::operator++() -> TableIterator & {
   return *this;
 }
 
+auto TableIterator::SkipPage() -> TableIterator & {
+  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+  auto page = page_guard.As<TablePage>();
+
+  if (stop_at_rid_.GetPageId() != INVALID_PAGE_ID && rid_.GetPageId() == stop_at_rid_.GetPageId()) {
+    // the stop tuple is on this page, nothing after it is part of the scan
+    rid_ = RID{INVALID_PAGE_ID, 0};
+  } else {
+    rid_ = RID{page->GetNextPageId(), 0};
+  }
+
+  page_guard.Drop();
+
+  return *this;
+}
+
 }  // namespace bustub
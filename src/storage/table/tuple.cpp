@@ -12,6 +12,7 @@
 
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -20,8 +21,27 @@
 
 namespace bustub {
 
+namespace {
+
+// Locate the start of column `column_idx` inside serialized tuple bytes.
+auto ColumnDataPtr(const char *data, const Schema *schema, const uint32_t column_idx) -> const char * {
+  assert(schema);
+  const auto &col = schema->GetColumn(column_idx);
+  bool is_inlined = col.IsInlined();
+  // For inline type, data is stored where it is.
+  if (is_inlined) {
+    return (data + col.GetOffset());
+  }
+  // We read the relative offset from the tuple data.
+  int32_t offset = *reinterpret_cast<const int32_t *>(data + col.GetOffset());
+  // And return the beginning address of the real data for the VARCHAR type.
+  return (data + offset);
+}
+
+}  // namespace
+
 // TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
-Tuple::Tuple(std::vector<Value> values, const Schema *schema) {
+Tuple::Tuple(std::vector<Value> values, const Schema *schema, TupleArena *arena) {
   assert(values.size() == schema->GetColumnCount());
 
   // 1. Calculate the size of the tuple.
@@ -35,8 +55,8 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) {
   }
 
   // 2. Allocate memory.
-  data_.resize(tuple_size);
-  std::fill(data_.begin(), data_.end(), 0);
+  data_.Allocate(tuple_size, arena);
+  memset(data_.Data(), 0, tuple_size);
 
   // 3. Serialize each attribute based on the input value.
   uint32_t column_count = schema->GetColumnCount();
@@ -46,16 +66,16 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) {
     const auto &col = schema->GetColumn(i);
     if (!col.IsInlined()) {
       // Serialize relative offset, where the actual varchar data is stored.
-      *reinterpret_cast<uint32_t *>(data_.data() + col.GetOffset()) = offset;
+      *reinterpret_cast<uint32_t *>(data_.Data() + col.GetOffset()) = offset;
       // Serialize varchar value, in place (size+data).
-      values[i].SerializeTo(data_.data() + offset);
+      values[i].SerializeTo(data_.Data() + offset);
       auto len = values[i].GetLength();
       if (len == BUSTUB_VALUE_NULL) {
         len = 0;
       }
       offset += (len + sizeof(uint32_t));
     } else {
-      values[i].SerializeTo(data_.data() + col.GetOffset());
+      values[i].SerializeTo(data_.Data() + col.GetOffset());
     }
   }
 }
@@ -68,7 +88,7 @@ auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> V
   return Value::DeserializeFrom(data_ptr, column_type);
 }
 
-auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs)
+auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const
     -> Tuple {
   std::vector<Value> values;
   values.reserve(key_attrs.size());
@@ -79,17 +99,7 @@ auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const s
 }
 
 auto Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) const -> const char * {
-  assert(schema);
-  const auto &col = schema->GetColumn(column_idx);
-  bool is_inlined = col.IsInlined();
-  // For inline type, data is stored where it is.
-  if (is_inlined) {
-    return (data_.data() + col.GetOffset());
-  }
-  // We read the relative offset from the tuple data.
-  int32_t offset = *reinterpret_cast<const int32_t *>(data_.data() + col.GetOffset());
-  // And return the beginning address of the real data for the VARCHAR type.
-  return (data_.data() + offset);
+  return ColumnDataPtr(data_.Data(), schema, column_idx);
 }
 
 auto Tuple::ToString(const Schema *schema) const -> std::string {
@@ -112,21 +122,32 @@ auto Tuple::ToString(const Schema *schema) const -> std::string {
     }
   }
   os << ")";
-  os << " Tuple size is " << data_.size();
+  os << " Tuple size is " << data_.Size();
 
   return os.str();
 }
 
+auto TupleView::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
+  assert(schema);
+  const TypeId column_type = schema->GetColumn(column_idx).GetType();
+  return Value::DeserializeFrom(ColumnDataPtr(data_, schema, column_idx), column_type);
+}
+
+auto TupleView::Materialize(TupleArena *arena) const -> Tuple {
+  Tuple tuple(rid_);
+  tuple.data_.Assign(data_, size_, arena);
+  return tuple;
+}
+
 void Tuple::SerializeTo(char *storage) const {
-  int32_t sz = data_.size();
+  int32_t sz = data_.Size();
   memcpy(storage, &sz, sizeof(int32_t));
-  memcpy(storage + sizeof(int32_t), data_.data(), sz);
+  memcpy(storage + sizeof(int32_t), data_.Data(), sz);
 }
 
 void Tuple::DeserializeFrom(const char *storage) {
   uint32_t size = *reinterpret_cast<const uint32_t *>(storage);
-  this->data_.resize(size);
-  memcpy(this->data_.data(), storage + sizeof(int32_t), size);
+  this->data_.Assign(storage + sizeof(int32_t), size);
 }
 
 }  // namespace bustub
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.cpp
+//
+// Identification: src/storage/table/zone_map.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/zone_map.h"
+
+#include <mutex>  // NOLINT
+
+namespace bustub {
+
+ZoneMap::ZoneMap(const Schema &schema) : schema_(schema), tracked_(schema.GetColumnCount(), false) {
+  for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+    // only fixed-width columns are summarized, min/max of strings would not prune much anyway
+    tracked_[i] = schema_.GetColumn(i).IsInlined();
+  }
+}
+
+void ZoneMap::Insert(page_id_t page_id, const Tuple &tuple) {
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  auto &zones = zones_[page_id];
+  if (zones.empty()) {
+    zones.resize(schema_.GetColumnCount());
+  }
+  for (uint32_t i = 0; i < schema_.GetColumnCount(); i++) {
+    if (!tracked_[i]) {
+      continue;
+    }
+    auto &zone = zones[i];
+    auto value = tuple.GetValue(&schema_, i);
+    if (value.IsNull()) {
+      zone.null_count_++;
+      continue;
+    }
+    if (!zone.has_range_) {
+      zone.min_ = value;
+      zone.max_ = value;
+      zone.has_range_ = true;
+      continue;
+    }
+    if (value.CompareLessThan(zone.min_) == CmpBool::CmpTrue) {
+      zone.min_ = value;
+    }
+    if (value.CompareGreaterThan(zone.max_) == CmpBool::CmpTrue) {
+      zone.max_ = value;
+    }
+  }
+}
+
+auto ZoneMap::GetColumnZone(page_id_t page_id, uint32_t column_idx) const -> std::optional<ColumnZone> {
+  if (!tracked_[column_idx]) {
+    return std::nullopt;
+  }
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  auto iter = zones_.find(page_id);
+  if (iter == zones_.end()) {
+    return std::nullopt;
+  }
+  return iter->second[column_idx];
+}
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #include "binder/binder.h"
 #include <memory>
 #include "binder/bound_statement.h"
+#include "binder/statement/index_statement.h"
 #include "catalog/catalog.h"
 #include "gtest/gtest.h"
 
@@ -143,6 +144,18 @@ TEST(BinderTest, FailBindUnknownColumn) {
 
 TEST(BinderTest, BindCreateTable) { TryBind("CREATE TABLE tablex (v1 int)"); }
 
+TEST(BinderTest, BindCreateIndex) {
+  // the index type comes from the USING clause of each statement, a B+ tree without one
+  auto statements = TryBind(
+      "CREATE INDEX i1 ON y (x); CREATE INDEX i2 ON y USING art (z); CREATE INDEX i3 ON y (a) WHERE c = 1;"
+      "CREATE INDEX i4 ON y USING hash (b); CREATE INDEX i5 ON c (x) WHERE y = 'using'");
+  std::vector<std::string> index_types;
+  for (const auto &statement : statements) {
+    index_types.push_back(dynamic_cast<const IndexStatement &>(*statement).index_type_);
+  }
+  EXPECT_EQ((std::vector<std::string>{"btree", "art", "btree", "hash", "btree"}), index_types);
+}
+
 TEST(BinderTest, BindInsert) { TryBind("INSERT INTO y VALUES (1,2,3,4,5), (6,7,8,9,10)"); }
 
 TEST(BinderTest, BindInsertSelect) { TryBind("INSERT INTO y SELECT * FROM y WHERE x < 500"); }
@@ -147,4 +147,115 @@ TEST(BufferPoolManagerTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PageReuseTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t k = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, k);
+
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < 8; i++) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(i, page_id_temp);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", i);
+    EXPECT_TRUE(bpm->UnpinPage(i, true));
+  }
+
+  // Scenario: a pinned page cannot be deleted and is not handed out again.
+  ASSERT_NE(nullptr, bpm->FetchPage(3));
+  EXPECT_FALSE(bpm->DeletePage(3));
+
+  // Scenario: deleted pages are reused lowest first, whether they were still buffered or only on disk. Deleting a page
+  // twice frees it once.
+  EXPECT_TRUE(bpm->DeletePage(5));
+  EXPECT_TRUE(bpm->DeletePage(1));
+  EXPECT_TRUE(bpm->DeletePage(5));
+  EXPECT_TRUE(bpm->UnpinPage(3, false));
+  auto *page = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(1, page_id_temp);
+  EXPECT_EQ(0, strcmp(page->GetData(), ""));
+  EXPECT_TRUE(bpm->UnpinPage(1, true));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(5, page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(5, true));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(8, page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(8, true));
+
+  // Scenario: freeing the last pages shrinks the file instead of remembering them.
+  EXPECT_TRUE(bpm->DeletePage(8));
+  EXPECT_TRUE(bpm->DeletePage(7));
+  EXPECT_EQ(7, disk_manager->GetNumPages());
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(7, page_id_temp);
+
+  // Scenario: pages that were not deleted keep their content.
+  page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, strcmp(page->GetData(), "page 0"));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, StaleFetchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t k = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, k);
+
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < 3; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(i, true));
+  }
+
+  // Scenario: a deleted page cannot be fetched, neither from the middle nor from the end of the file.
+  EXPECT_TRUE(bpm->DeletePage(1));
+  EXPECT_TRUE(bpm->DeletePage(2));
+  EXPECT_EQ(nullptr, bpm->FetchPage(1));
+  EXPECT_EQ(nullptr, bpm->FetchPage(2));
+  EXPECT_FALSE(bpm->UnpinPage(1, false));
+
+  // Scenario: the reused ids get exactly one frame, the new owner's.
+  auto *page = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(1, page_id_temp);
+  snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "owner 1");
+  EXPECT_EQ(page, bpm->FetchPage(1));
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+  EXPECT_TRUE(bpm->UnpinPage(1, true));
+  EXPECT_FALSE(bpm->UnpinPage(1, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(2, page_id_temp);
+  EXPECT_TRUE(bpm->UnpinPage(2, false));
+
+  // Scenario: the new owner's content survives eviction.
+  for (int i = 0; i < 5; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  page = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, strcmp(page->GetData(), "owner 1"));
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
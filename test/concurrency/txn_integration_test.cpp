@@ -84,4 +84,30 @@ TEST(IsolationLevelTest, DeleteTestA) {
                ExpectedOutcome::BlockOnRead);
 }
 
+// NOLINTNEXTLINE
+TEST(IsolationLevelTest, IndexScanLockTest) {
+  auto db = GetDbForVisibilityTest("IndexScanLockTest");
+  auto writer = bustub::SimpleStreamWriter(std::cout, true);
+  db->ExecuteSql("CREATE INDEX t1_v1 ON t1(v1);", writer);
+  auto oid = db->catalog_->GetTable("t1")->oid_;
+  for (auto level : {IsolationLevel::REPEATABLE_READ, IsolationLevel::READ_COMMITTED}) {
+    auto txn = Begin(*db, level);
+    std::stringstream plan;
+    auto plan_writer = bustub::SimpleStreamWriter(plan, true);
+    db->ExecuteSqlTxn("EXPLAIN (o) SELECT * FROM t1 WHERE v1 = 234", plan_writer, txn);
+    ASSERT_NE(plan.str().find("IndexScan"), std::string::npos) << plan.str();
+    std::stringstream result;
+    auto result_writer = bustub::SimpleStreamWriter(result, true, ",");
+    db->ExecuteSqlTxn("SELECT * FROM t1 WHERE v1 = 234", result_writer, txn);
+    EXPECT_TRUE(ExpectResult(result.str(), "234,1,\n234,2,\n234,3,\n"));
+    // repeatable read keeps the rows it returned locked, read committed releases them right after reading
+    auto row_locks = txn->GetSharedRowLockSet();
+    size_t locked_rows = row_locks->count(oid) == 0 ? 0 : row_locks->at(oid).size();
+    bool repeatable = level == IsolationLevel::REPEATABLE_READ;
+    EXPECT_EQ(locked_rows, repeatable ? 3 : 0);
+    EXPECT_EQ(txn->GetIntentionSharedTableLockSet()->count(oid), repeatable ? 1 : 0);
+    Commit(*db, txn);
+  }
+}
+
 }  // namespace bustub
@@ -23,7 +23,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
+TEST(HashTablePageTest, DirectoryPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -56,7 +56,7 @@ TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
+TEST(HashTablePageTest, BucketPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -113,4 +113,46 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageFullTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  auto bucket_page =
+      reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(bpm->NewPage(&bucket_page_id)->GetData());
+  const auto capacity =
+      static_cast<int>((BUSTUB_PAGE_SIZE - 16 - sizeof(page_id_t)) / (sizeof(std::pair<int, int>) + 1));
+
+  // fill every slot, with many keys sharing a tag and every key stored twice
+  EXPECT_TRUE(bucket_page->IsEmpty());
+  for (int i = 0; i < capacity; i++) {
+    ASSERT_TRUE(bucket_page->Insert(i / 2, i, IntComparator()));
+  }
+  EXPECT_TRUE(bucket_page->IsFull());
+  EXPECT_EQ(capacity, bucket_page->NumReadable());
+  EXPECT_FALSE(bucket_page->Insert(capacity, capacity, IntComparator()));
+  for (int key = 0; key < capacity / 2; key++) {
+    std::vector<int> result;
+    ASSERT_TRUE(bucket_page->GetValue(key, IntComparator(), &result));
+    ASSERT_EQ((std::vector<int>{2 * key, 2 * key + 1}), result);
+  }
+
+  // a tombstone is reused by the next insert and the other copy of the key stays visible
+  ASSERT_TRUE(bucket_page->Remove(7, 14, IntComparator()));
+  EXPECT_FALSE(bucket_page->IsReadable(14));
+  std::vector<int> result;
+  ASSERT_TRUE(bucket_page->GetValue(7, IntComparator(), &result));
+  EXPECT_EQ(std::vector<int>{15}, result);
+  ASSERT_TRUE(bucket_page->Insert(capacity, capacity, IntComparator()));
+  EXPECT_TRUE(bucket_page->IsReadable(14));
+  EXPECT_EQ(capacity, bucket_page->KeyAt(14));
+
+  bpm->UnpinPage(bucket_page_id, true);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -24,7 +26,7 @@ namespace bustub {
 // NOLINTNEXTLINE
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(50, disk_manager);
   DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
@@ -117,4 +119,243 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, SplitMergeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // enough keys to overflow a bucket many times over, every key also gets a second value
+  const int num_keys = 5000;
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    ASSERT_TRUE(ht.Insert(nullptr, i, -i - 1));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_LT(0, ht.GetGlobalDepth());
+
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    ASSERT_EQ((std::vector<int>{-i - 1, i}), res);
+  }
+
+  // emptying the table merges all buckets back into one
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+    ASSERT_TRUE(ht.Remove(nullptr, i, -i - 1));
+    ASSERT_FALSE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 0, &res));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, OverflowChainTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // several buckets worth of values for one key, no split can separate them
+  const int num_values = 2000;
+  const int num_keys = 5000;
+  auto check_values = [&]() {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, 7, &res));
+    std::sort(res.begin(), res.end());
+    ASSERT_EQ(num_values, res.size());
+    for (int i = 0; i < num_values; i++) {
+      ASSERT_EQ(i, res[i]);
+    }
+  };
+  for (int i = 0; i < num_values; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, 7, i));
+  }
+  ASSERT_FALSE(ht.Insert(nullptr, 7, num_values / 2));
+  ht.VerifyIntegrity();
+  check_values();
+
+  // other keys split the buckets around the chained one, removing them merges those buckets into it, so inserting
+  // them again splits a bucket that still has overflow pages
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < num_keys; i++) {
+      ASSERT_TRUE(ht.Insert(nullptr, 100 + i, i));
+    }
+    ht.VerifyIntegrity();
+    check_values();
+    for (int i = 0; i < num_keys; i++) {
+      std::vector<int> res;
+      ASSERT_TRUE(ht.GetValue(nullptr, 100 + i, &res));
+      ASSERT_EQ((std::vector<int>{i}), res);
+    }
+    for (int i = 0; i < num_keys; i++) {
+      ASSERT_TRUE(ht.Remove(nullptr, 100 + i, i));
+    }
+    ht.VerifyIntegrity();
+    check_values();
+  }
+
+  // emptying the chain unlinks its overflow pages, after which the buckets merge back into one
+  for (int i = 0; i < num_values; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, 7, i));
+  }
+  ASSERT_FALSE(ht.Remove(nullptr, 7, 0));
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 7, &res));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentInsertTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // each thread inserts a disjoint set of keys, forcing splits while the others probe
+  const int num_threads = 4;
+  const int keys_per_thread = 2000;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&ht, tid]() {
+      for (int i = tid; i < num_threads * keys_per_thread; i += num_threads) {
+        ht.Insert(nullptr, i, i);
+        std::vector<int> res;
+        ht.GetValue(nullptr, i, &res);
+        EXPECT_EQ(1, res.size());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ht.VerifyIntegrity();
+
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(std::vector<int>{i}, res);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentReadDuringSplitMergeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  const int num_stable = 1000;
+  for (int i = 0; i < num_stable; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+
+  // writers grow and shrink the table over and over, readers must always find every stable key exactly once
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < 2; tid++) {
+    threads.emplace_back([&ht, tid]() {
+      for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 3000; i++) {
+          EXPECT_TRUE(ht.Insert(nullptr, num_stable + 2 * i + tid, i));
+        }
+        for (int i = 0; i < 3000; i++) {
+          EXPECT_TRUE(ht.Remove(nullptr, num_stable + 2 * i + tid, i));
+        }
+      }
+    });
+  }
+  for (int tid = 0; tid < 2; tid++) {
+    threads.emplace_back([&ht, &done, tid]() {
+      while (!done) {
+        for (int i = tid; i < num_stable; i += 2) {
+          std::vector<int> res;
+          ht.GetValue(nullptr, i, &res);
+          ASSERT_EQ(std::vector<int>{i}, res);
+        }
+      }
+    });
+  }
+  threads[0].join();
+  threads[1].join();
+  done = true;
+  threads[2].join();
+  threads[3].join();
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentReadDuringMergeChurnTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // the table grows from one bucket and merges all the way back every round, so the deleted bucket pages get reused
+  // by the next splits while readers probe the very keys that move around
+  const int num_keys = 2000;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  threads.emplace_back([&ht]() {
+    for (int round = 0; round < 8; round++) {
+      for (int i = 0; i < num_keys; i++) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+      }
+      for (int i = 0; i < num_keys; i++) {
+        EXPECT_TRUE(ht.Remove(nullptr, i, i));
+      }
+    }
+  });
+  for (int tid = 0; tid < 3; tid++) {
+    threads.emplace_back([&ht, &done, tid]() {
+      while (!done) {
+        for (int i = tid; i < num_keys; i += 3) {
+          std::vector<int> res;
+          if (ht.GetValue(nullptr, i, &res)) {
+            ASSERT_EQ(std::vector<int>{i}, res);
+          }
+        }
+      }
+    });
+  }
+  threads[0].join();
+  done = true;
+  for (size_t i = 1; i < threads.size(); i++) {
+    threads[i].join();
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  // every merged bucket was deleted, none was left behind pinned by a reader
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_GT(3, page_id);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -0,0 +1,218 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index_test.cpp
+//
+// Identification: test/storage/art_index_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/art_index.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the RIDs of every entry of `cursor`, in cursor order */
+auto Drain(IndexScanCursor *cursor) -> std::vector<RID> {
+  std::vector<RID> rids;
+  for (; !cursor->IsEnd(); cursor->Next()) {
+    rids.push_back(cursor->GetRID());
+  }
+  return rids;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(ArtIndexTest, InsertScanTest) {
+  auto table_schema = ParseCreateStatement("a bigint");
+  auto metadata = std::make_unique<IndexMetadata>("foo_pk", "foo", table_schema.get(), std::vector<uint32_t>{0});
+  ArtIndex index(std::move(metadata));
+  auto make_key = [&](int64_t key) { return Tuple({ValueFactory::GetBigIntValue(key)}, index.GetKeySchema()); };
+
+  // enough keys in a shuffled order to grow nodes through every size, negative ones included
+  std::vector<int64_t> keys;
+  for (int64_t key = -5000; key < 5000; key++) {
+    keys.push_back(key * 7);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    ASSERT_TRUE(index.InsertEntry(make_key(key), RID(0, key + 35000), nullptr));
+  }
+  EXPECT_FALSE(index.InsertEntry(make_key(7), RID(1, 0), nullptr));
+
+  std::vector<RID> rids;
+  for (int64_t key = -35010; key < 35010; key++) {
+    rids.clear();
+    index.ScanKey(make_key(key), &rids, nullptr);
+    if (key % 7 == 0 && key >= -35000 && key < 35000) {
+      ASSERT_EQ(std::vector<RID>{RID(0, key + 35000)}, rids) << key;
+    } else {
+      ASSERT_TRUE(rids.empty()) << key;
+    }
+  }
+
+  // delete every other key, which shrinks and merges nodes again
+  for (auto key : keys) {
+    if (key % 2 == 0) {
+      index.DeleteEntry(make_key(key), RID(), nullptr);
+    }
+  }
+  auto all = Drain(index.ScanRange({}, false).get());
+  ASSERT_EQ(5000U, all.size());
+  for (size_t i = 0; i < all.size(); i++) {
+    ASSERT_EQ(static_cast<uint32_t>(7 + 14 * i), all[i].GetSlotNum());
+  }
+
+  IndexKeyRange range{ValueFactory::GetBigIntValue(-7), false, ValueFactory::GetBigIntValue(35), true};
+  EXPECT_EQ((std::vector<RID>{RID(0, 35007), RID(0, 35021), RID(0, 35035)}),
+            Drain(index.ScanRange(range, false).get()));
+  EXPECT_EQ((std::vector<RID>{RID(0, 35035), RID(0, 35021), RID(0, 35007)}),
+            Drain(index.ScanRange(range, true).get()));
+
+  // a bound of another type than the key column is compared on values
+  IndexKeyRange int_range{ValueFactory::GetIntegerValue(20), true, std::nullopt, true};
+  auto cursor = index.ScanRange(int_range, false);
+  ASSERT_FALSE(cursor->IsEnd());
+  EXPECT_EQ(21, cursor->GetKeyValues()[0].GetAs<int64_t>());
+}
+
+// NOLINTNEXTLINE
+TEST(ArtIndexTest, NonUniqueVarcharTest) {
+  auto table_schema = ParseCreateStatement("a varchar(16),b integer");
+  auto metadata =
+      std::make_unique<IndexMetadata>("foo_ab", "foo", table_schema.get(), std::vector<uint32_t>{0, 1}, false);
+  ArtIndex index(std::move(metadata));
+  auto make_key = [&](const std::string &a, int32_t b) {
+    return Tuple({ValueFactory::GetVarcharValue(a), ValueFactory::GetIntegerValue(b)}, index.GetKeySchema());
+  };
+
+  // strings that are prefixes of each other, and duplicates that only the RID tells apart
+  ASSERT_TRUE(index.InsertEntry(make_key("abc", 1), RID(0, 0), nullptr));
+  ASSERT_TRUE(index.InsertEntry(make_key("ab", 1), RID(0, 1), nullptr));
+  ASSERT_TRUE(index.InsertEntry(make_key("abd", -1), RID(0, 2), nullptr));
+  ASSERT_TRUE(index.InsertEntry(make_key("ab", 1), RID(0, 3), nullptr));
+  ASSERT_TRUE(index.InsertEntry(make_key("", 2), RID(0, 4), nullptr));
+  ASSERT_TRUE(index.InsertEntry(make_key("ab", 0), RID(0, 5), nullptr));
+  EXPECT_FALSE(index.InsertEntry(make_key("ab", 1), RID(0, 3), nullptr));
+
+  std::vector<RID> rids;
+  index.ScanKey(make_key("ab", 1), &rids, nullptr);
+  EXPECT_EQ((std::vector<RID>{RID(0, 1), RID(0, 3)}), rids);
+
+  EXPECT_EQ((std::vector<RID>{RID(0, 4), RID(0, 5), RID(0, 1), RID(0, 3), RID(0, 0), RID(0, 2)}),
+            Drain(index.ScanRange({}, false).get()));
+  IndexKeyRange range{ValueFactory::GetVarcharValue("ab"), false, ValueFactory::GetVarcharValue("abd"), false};
+  EXPECT_EQ(std::vector<RID>{RID(0, 0)}, Drain(index.ScanRange(range, false).get()));
+  range.high_inclusive_ = true;
+  EXPECT_EQ((std::vector<RID>{RID(0, 0), RID(0, 2)}), Drain(index.ScanRange(range, false).get()));
+
+  index.DeleteEntry(make_key("ab", 1), RID(0, 1), nullptr);
+  rids.clear();
+  index.ScanKey(make_key("ab", 1), &rids, nullptr);
+  EXPECT_EQ(std::vector<RID>{RID(0, 3)}, rids);
+}
+
+// NOLINTNEXTLINE
+TEST(ArtIndexTest, ScanChangesAheadTest) {
+  auto table_schema = ParseCreateStatement("a bigint");
+  auto metadata = std::make_unique<IndexMetadata>("foo_pk", "foo", table_schema.get(), std::vector<uint32_t>{0});
+  ArtIndex index(std::move(metadata));
+  auto make_key = [&](int64_t key) { return Tuple({ValueFactory::GetBigIntValue(key)}, index.GetKeySchema()); };
+  auto drain_keys = [](IndexScanCursor *cursor) {
+    std::vector<int64_t> keys;
+    for (; !cursor->IsEnd(); cursor->Next()) {
+      keys.push_back(cursor->GetKeyValues()[0].GetAs<int64_t>());
+    }
+    return keys;
+  };
+
+  std::vector<int64_t> expected_ascending;
+  std::vector<int64_t> expected_descending;
+  for (int64_t key = 0; key < 1000; key += 2) {
+    ASSERT_TRUE(index.InsertEntry(make_key(key), RID(0, key + 1), nullptr));
+    if (key < 998) {
+      expected_ascending.push_back(key);
+    }
+    if (key > 0) {
+      expected_descending.push_back(1000 - key);
+    }
+  }
+  expected_ascending.push_back(1001);
+  expected_descending.push_back(-1);
+
+  // cursors copy out only the entries next to them, changes further along the range show up in the scan
+  auto ascending = index.ScanRange({}, false);
+  auto descending = index.ScanRange({}, true);
+  ASSERT_TRUE(index.InsertEntry(make_key(1001), RID(0, 1002), nullptr));
+  ASSERT_TRUE(index.InsertEntry(make_key(-1), RID(0, 0), nullptr));
+  index.DeleteEntry(make_key(998), RID(), nullptr);
+  index.DeleteEntry(make_key(0), RID(), nullptr);
+  EXPECT_EQ(expected_ascending, drain_keys(ascending.get()));
+  EXPECT_EQ(expected_descending, drain_keys(descending.get()));
+}
+
+// NOLINTNEXTLINE
+TEST(ArtIndexTest, ConcurrentTest) {
+  auto table_schema = ParseCreateStatement("a bigint");
+  auto metadata = std::make_unique<IndexMetadata>("foo_pk", "foo", table_schema.get(), std::vector<uint32_t>{0});
+  ArtIndex index(std::move(metadata));
+  auto make_key = [&](int64_t key) { return Tuple({ValueFactory::GetBigIntValue(key)}, index.GetKeySchema()); };
+
+  const int64_t keys_per_thread = 5000;
+  const int num_threads = 4;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      // interleaved keys, so that the threads write into the same nodes
+      for (int64_t i = 0; i < keys_per_thread; i++) {
+        auto key = i * num_threads + t;
+        ASSERT_TRUE(index.InsertEntry(make_key(key), RID(0, key), nullptr));
+      }
+      for (int64_t i = 0; i < keys_per_thread; i += 2) {
+        auto key = i * num_threads + t;
+        index.DeleteEntry(make_key(key), RID(), nullptr);
+      }
+    });
+  }
+  // readers never see a key whose entry is not its own
+  threads.emplace_back([&] {
+    std::vector<RID> rids;
+    for (int round = 0; round < 3; round++) {
+      for (int64_t key = 0; key < keys_per_thread * num_threads; key += 3) {
+        rids.clear();
+        index.ScanKey(make_key(key), &rids, nullptr);
+        ASSERT_LE(rids.size(), 1U);
+        if (!rids.empty()) {
+          ASSERT_EQ(static_cast<uint32_t>(key), rids[0].GetSlotNum());
+        }
+      }
+      auto scanned = Drain(index.ScanRange({}, false).get());
+      ASSERT_TRUE(std::is_sorted(scanned.begin(), scanned.end(),
+                                 [](const RID &a, const RID &b) { return a.GetSlotNum() < b.GetSlotNum(); }));
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  auto all = Drain(index.ScanRange({}, false).get());
+  ASSERT_EQ(static_cast<size_t>(keys_per_thread * num_threads / 2), all.size());
+  for (const auto &rid : all) {
+    EXPECT_EQ(1U, (rid.GetSlotNum() / num_threads) % 2);
+  }
+}
+
+}  // namespace bustub
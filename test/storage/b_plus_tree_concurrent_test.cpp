@@ -402,4 +402,143 @@ TEST(BPlusTreeConcurrentTest, MixTest2) {
   delete bpm;
 }
 
+TEST(BPlusTreeConcurrentTest, MixTest3) {
+  // small nodes, so that concurrent inserts and removes keep splitting and merging pages while other threads take the
+  // optimistic path through the same inner pages
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(100, disk_manager.get());
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 5, 5);
+
+  std::vector<int64_t> perserved_keys;
+  std::vector<int64_t> dynamic_keys;
+  int64_t total_keys = 2000;
+  int64_t sieve = 4;
+  for (int64_t i = 1; i <= total_keys; i++) {
+    if (i % sieve == 0) {
+      perserved_keys.push_back(i);
+    } else {
+      dynamic_keys.push_back(i);
+    }
+  }
+  InsertHelper(&tree, perserved_keys, 1);
+
+  size_t num_threads = 4;
+  auto insert_task = [&](int tid) { InsertHelperSplit(&tree, dynamic_keys, num_threads, tid); };
+  auto delete_task = [&](int tid) { DeleteHelperSplit(&tree, dynamic_keys, num_threads, tid); };
+  auto lookup_task = [&](int tid) { LookupHelper(&tree, perserved_keys, tid); };
+
+  // every thread inserts its share of the dynamic keys, then removes it again
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, i] {
+      insert_task(i);
+      lookup_task(i);
+      delete_task(i);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // only the perserved keys are left, in order
+  int64_t expected = sieve;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    ASSERT_EQ(expected, (*iter).first.ToString());
+    expected += sieve;
+  }
+  ASSERT_EQ(expected, total_keys + sieve);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeConcurrentTest, RangeDeleteTest) {
+  // range and bulk removes of the upper half run against inserts, lookups and scans of the lower half
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(100, disk_manager.get());
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 5, 5);
+
+  int64_t total_keys = 2000;
+  std::vector<int64_t> lower_keys;
+  std::vector<int64_t> upper_keys;
+  for (int64_t i = 1; i <= total_keys; i++) {
+    (i <= total_keys / 2 ? lower_keys : upper_keys).push_back(i);
+  }
+  std::vector<int64_t> preserved_keys;
+  std::vector<int64_t> dynamic_keys;
+  for (auto key : lower_keys) {
+    (key % 2 == 0 ? preserved_keys : dynamic_keys).push_back(key);
+  }
+  InsertHelper(&tree, preserved_keys, 1);
+  InsertHelper(&tree, upper_keys, 1);
+
+  size_t num_threads = 2;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, i] {
+      InsertHelperSplit(&tree, dynamic_keys, num_threads, i);
+      LookupHelper(&tree, preserved_keys, i);
+    });
+  }
+  threads.emplace_back([&] {
+    for (int round = 0; round < 3; round++) {
+      int64_t previous = 0;
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+        ASSERT_LT(previous, (*iter).first.ToString());
+        previous = (*iter).first.ToString();
+      }
+    }
+  });
+  threads.emplace_back([&] {
+    // ranges of 100 keys over the first half of the upper keys, single keys over the second half
+    GenericKey<8> low_key;
+    GenericKey<8> high_key;
+    for (int64_t low = total_keys / 2 + 1; low <= total_keys * 3 / 4; low += 100) {
+      low_key.SetFromInteger(low);
+      high_key.SetFromInteger(low + 100);
+      ASSERT_EQ(100, tree.RemoveRange([&](const GenericKey<8> &key) { return comparator(key, low_key) < 0; },
+                                      [&](const GenericKey<8> &key) { return comparator(key, high_key) >= 0; }));
+    }
+    std::vector<GenericKey<8>> remove_keys;
+    GenericKey<8> index_key;
+    for (int64_t key = total_keys * 3 / 4 + 1; key <= total_keys; key++) {
+      index_key.SetFromInteger(key);
+      remove_keys.push_back(index_key);
+    }
+    ASSERT_EQ(remove_keys.size(), tree.RemoveKeys(remove_keys));
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // only the lower half is left, in order
+  int64_t expected = 1;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    ASSERT_EQ(expected, (*iter).first.ToString());
+    expected++;
+  }
+  ASSERT_EQ(expected, total_keys / 2 + 1);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
 }  // namespace bustub
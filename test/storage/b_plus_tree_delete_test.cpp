@@ -13,6 +13,8 @@
 #include <algorithm>
 #include <cstdio>
 #include <numeric>
+#include <random>
+#include <set>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -24,6 +26,33 @@ namespace bustub {
 
 using bustub::DiskManagerUnlimitedMemory;
 
+namespace {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+/** Check that the tree holds exactly `expected`, in both iteration orders and by point lookups. */
+void CheckTreeHolds(Tree *tree, const std::set<int64_t> &expected, int64_t key_limit) {
+  std::vector<int64_t> forward;
+  for (auto iter = tree->Begin(); !iter.IsEnd(); ++iter) {
+    forward.push_back((*iter).second.GetSlotNum());
+  }
+  ASSERT_EQ(std::vector<int64_t>(expected.begin(), expected.end()), forward);
+  std::vector<int64_t> backward;
+  for (auto iter = tree->RBegin(); !iter.IsEnd(); ++iter) {
+    backward.push_back((*iter).second.GetSlotNum());
+  }
+  ASSERT_EQ(std::vector<int64_t>(expected.rbegin(), expected.rend()), backward);
+  GenericKey<8> index_key;
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < key_limit; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_EQ(expected.count(key) == 1, tree->GetValue(index_key, &rids)) << key;
+  }
+}
+
+}  // namespace
+
 TEST(BPlusTreeTests, DeleteTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
@@ -263,4 +292,166 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest4) {
   std::cout << "get value successfully" << std::endl;
 }
 
+TEST(BPlusTreeTests, PageReuseTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 3, 3);
+  GenericKey<8> index_key;
+  auto *transaction = new Transaction(0);
+
+  // pages merged away by removes are reused by later inserts, so the same keys need no more pages the second time
+  std::vector<page_id_t> num_pages;
+  for (int round = 0; round < 3; round++) {
+    for (int64_t key = 0; key < 500; key++) {
+      index_key.SetFromInteger(key);
+      ASSERT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+    }
+    num_pages.push_back(disk_manager->GetNumPages());
+    for (int64_t key = 0; key < 500; key++) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, transaction);
+    }
+    ASSERT_TRUE(tree.Begin().IsEnd());
+  }
+  EXPECT_EQ(num_pages[0], num_pages[1]);
+  EXPECT_EQ(num_pages[0], num_pages[2]);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, RangeDeleteTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t key_limit = 600;
+
+  // small pages make the tree deep, so that ranges free whole subtrees and cross many parents
+  for (auto [leaf_max_size, internal_max_size] : {std::pair{3, 3}, std::pair{4, 5}, std::pair{2, 3}}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto *bpm = new BufferPoolManager(50, disk_manager.get());
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, leaf_max_size, internal_max_size);
+    GenericKey<8> index_key;
+    auto *transaction = new Transaction(0);
+    std::mt19937 gen(15445);
+
+    std::vector<int64_t> keys(key_limit);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::set<int64_t> expected(keys.begin(), keys.end());
+    std::shuffle(keys.begin(), keys.end(), gen);
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, key), transaction);
+    }
+
+    for (int round = 0; round < 30; round++) {
+      // remove [low, high), then put some keys back so that later ranges meet both full and thinned out leaves
+      auto low = static_cast<int64_t>(gen() % key_limit);
+      auto high = std::min(key_limit, low + static_cast<int64_t>(gen() % 120));
+      GenericKey<8> low_key;
+      GenericKey<8> high_key;
+      low_key.SetFromInteger(low);
+      high_key.SetFromInteger(high);
+      auto removed = tree.RemoveRange([&](const GenericKey<8> &key) { return comparator(key, low_key) < 0; },
+                                      [&](const GenericKey<8> &key) { return comparator(key, high_key) >= 0; },
+                                      transaction);
+      size_t expected_removed = 0;
+      for (auto key = low; key < high; key++) {
+        expected_removed += expected.erase(key);
+      }
+      ASSERT_EQ(expected_removed, removed);
+      CheckTreeHolds(&tree, expected, key_limit);
+      for (int i = 0; i < 20; i++) {
+        auto key = static_cast<int64_t>(gen() % key_limit);
+        index_key.SetFromInteger(key);
+        ASSERT_EQ(expected.insert(key).second, tree.Insert(index_key, RID(0, key), transaction));
+      }
+      CheckTreeHolds(&tree, expected, key_limit);
+    }
+
+    // open ends remove everything below or above a key, and then the rest
+    GenericKey<8> mid_key;
+    mid_key.SetFromInteger(key_limit / 2);
+    tree.RemoveRange(nullptr, [&](const GenericKey<8> &key) { return comparator(key, mid_key) >= 0; }, transaction);
+    expected.erase(expected.begin(), expected.lower_bound(key_limit / 2));
+    CheckTreeHolds(&tree, expected, key_limit);
+    EXPECT_EQ(expected.size(), tree.RemoveRange(nullptr, nullptr, transaction));
+    EXPECT_TRUE(tree.IsEmpty());
+    index_key.SetFromInteger(7);
+    ASSERT_TRUE(tree.Insert(index_key, RID(0, 7), transaction));
+    CheckTreeHolds(&tree, {7}, key_limit);
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete transaction;
+    delete bpm;
+  }
+}
+
+TEST(BPlusTreeTests, BulkDeleteTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t key_limit = 600;
+
+  for (auto [leaf_max_size, internal_max_size] : {std::pair{3, 3}, std::pair{4, 5}, std::pair{2, 3}}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto *bpm = new BufferPoolManager(50, disk_manager.get());
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    Tree tree("foo_pk", header_page->GetPageId(), bpm, comparator, leaf_max_size, internal_max_size);
+    GenericKey<8> index_key;
+    auto *transaction = new Transaction(0);
+    std::mt19937 gen(15445);
+
+    std::set<int64_t> expected;
+    for (int64_t key = 0; key < key_limit; key += 2) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, key), transaction);
+      expected.insert(key);
+    }
+
+    for (int round = 0; round < 30; round++) {
+      // unsorted keys clustered around a few spots, with repeats and keys that are not in the tree
+      std::vector<GenericKey<8>> remove_keys;
+      size_t expected_removed = 0;
+      for (int cluster = 0; cluster < 3; cluster++) {
+        auto center = static_cast<int64_t>(gen() % key_limit);
+        for (int i = 0; i < 25; i++) {
+          auto key = std::clamp<int64_t>(center + static_cast<int64_t>(gen() % 41) - 20, 0, key_limit - 1);
+          index_key.SetFromInteger(key);
+          remove_keys.push_back(index_key);
+          expected_removed += expected.erase(key);
+        }
+      }
+      ASSERT_EQ(expected_removed, tree.RemoveKeys(remove_keys, transaction));
+      CheckTreeHolds(&tree, expected, key_limit);
+      for (int i = 0; i < 40; i++) {
+        auto key = static_cast<int64_t>(gen() % key_limit);
+        index_key.SetFromInteger(key);
+        ASSERT_EQ(expected.insert(key).second, tree.Insert(index_key, RID(0, key), transaction));
+      }
+      CheckTreeHolds(&tree, expected, key_limit);
+    }
+
+    // removing every key empties the tree
+    std::vector<GenericKey<8>> remove_keys;
+    for (auto key : expected) {
+      index_key.SetFromInteger(key);
+      remove_keys.push_back(index_key);
+    }
+    EXPECT_EQ(expected.size(), tree.RemoveKeys(remove_keys, transaction));
+    EXPECT_TRUE(tree.IsEmpty());
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete transaction;
+    delete bpm;
+  }
+}
+
 }  // namespace bustub
@@ -12,12 +12,21 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager_memory.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/table/table_heap.h"
 #include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -194,4 +203,504 @@ TEST(BPlusTreeTests, InsertTest3) {
   delete transaction;
   delete bpm;
 }
+
+TEST(BPlusTreeTests, InternalLookupTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto guard = bpm->NewPageGuarded(&page_id);
+  auto *internal = guard.AsMut<BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>>();
+
+  // every size from a lone child up to a full page, separators are 10, 20, ...
+  GenericKey<8> index_key;
+  for (int size = 1; size <= 20; size++) {
+    internal->Init(20);
+    for (int i = 0; i < size; i++) {
+      index_key.SetFromInteger(i * 10);
+      internal->InsertValueAt(index_key, i, i);
+    }
+    for (int64_t key = -5; key <= size * 10 + 5; key++) {
+      index_key.SetFromInteger(key);
+      int expected = std::clamp(static_cast<int>(key < 0 ? 0 : key / 10), 0, size - 1);
+      ASSERT_EQ(expected, internal->LookupChildIndex(index_key, comparator)) << "size " << size << " key " << key;
+      ASSERT_EQ(expected, internal->FindValue(index_key, comparator).first);
+    }
+  }
+}
+
+TEST(BPlusTreeTests, IntegerComparatorTest) {
+  auto one_int = ParseCreateStatement("a integer");
+  auto two_int = ParseCreateStatement("a integer,b integer");
+  auto big_int = ParseCreateStatement("a bigint");
+  ASSERT_TRUE((IntegerComparator<8, int32_t>::Supports(*one_int)));
+  ASSERT_TRUE((IntegerComparator<8, int32_t>::Supports(*two_int)));
+  ASSERT_FALSE((IntegerComparator<8, int32_t>::Supports(*big_int)));
+  ASSERT_TRUE((IntegerComparator<8, int64_t>::Supports(*big_int)));
+  ASSERT_FALSE((IntegerComparator<8, int64_t>::Supports(*two_int)));
+
+  // the raw comparators must order keys exactly like the Value based one, negative numbers included
+  GenericComparator<8> generic_two(two_int.get());
+  IntegerComparator<8, int32_t> raw_two(two_int.get());
+  GenericComparator<8> generic_big(big_int.get());
+  IntegerComparator<8, int64_t> raw_big(big_int.get());
+  std::vector<int32_t> samples{std::numeric_limits<int32_t>::max(), -1, 0, 1, -256, 255, 65536, -65537};
+  for (auto a1 : samples) {
+    for (auto b1 : samples) {
+      for (auto a2 : samples) {
+        for (auto b2 : samples) {
+          Tuple lhs{{ValueFactory::GetIntegerValue(a1), ValueFactory::GetIntegerValue(b1)}, two_int.get()};
+          Tuple rhs{{ValueFactory::GetIntegerValue(a2), ValueFactory::GetIntegerValue(b2)}, two_int.get()};
+          GenericKey<8> lhs_key;
+          GenericKey<8> rhs_key;
+          lhs_key.SetFromKey(lhs);
+          rhs_key.SetFromKey(rhs);
+          ASSERT_EQ(generic_two(lhs_key, rhs_key), raw_two(lhs_key, rhs_key));
+        }
+      }
+      GenericKey<8> lhs_key;
+      GenericKey<8> rhs_key;
+      lhs_key.SetFromInteger(static_cast<int64_t>(a1) * b1);
+      rhs_key.SetFromInteger(static_cast<int64_t>(b1) - a1);
+      ASSERT_EQ(generic_big(lhs_key, rhs_key), raw_big(lhs_key, rhs_key));
+    }
+  }
+
+  // a tree built on the raw comparator iterates in signed order
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<8>, RID, IntegerComparator<8, int64_t>> tree("foo_pk", header_page->GetPageId(), bpm.get(),
+                                                                     raw_big, 3, 5);
+  GenericKey<8> index_key;
+  for (int64_t key = 50; key >= -50; key--) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, static_cast<uint32_t>(key + 50)));
+  }
+  int64_t current_key = -50;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ(current_key, (*iterator).first.ToString());
+    current_key++;
+  }
+  EXPECT_EQ(51, current_key);
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  GenericKey<8> index_key;
+
+  for (double fill_factor : {0.1, 0.5, 0.75, 1.0}) {
+    for (int64_t key_cnt : {1, 2, 7, 500}) {
+      page_id_t page_id;
+      bpm->NewPageGuarded(&page_id).Drop();
+      BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm.get(), comparator, 4, 5);
+
+      // every odd key, shuffled, with key 1 twice where the earlier value has to win
+      std::vector<std::pair<GenericKey<8>, RID>> entries;
+      for (int64_t key = 1; key < 2 * key_cnt; key += 2) {
+        index_key.SetFromInteger(key);
+        entries.emplace_back(index_key, RID(0, key));
+      }
+      std::shuffle(entries.begin(), entries.end(), std::mt19937(key_cnt));
+      index_key.SetFromInteger(1);
+      entries.emplace_back(index_key, RID(1, 1));
+      ASSERT_TRUE(tree.BulkLoad(entries, fill_factor));
+      ASSERT_FALSE(tree.BulkLoad(entries, fill_factor));
+
+      int64_t current_key = 1;
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+        ASSERT_EQ(current_key, (*iter).first.ToString());
+        ASSERT_EQ(0, (*iter).second.GetPageId());
+        current_key += 2;
+      }
+      ASSERT_EQ(2 * key_cnt + 1, current_key);
+
+      // the loaded tree must keep working for regular inserts, lookups and removals
+      for (int64_t key = 0; key <= 2 * key_cnt; key += 2) {
+        index_key.SetFromInteger(key);
+        ASSERT_TRUE(tree.Insert(index_key, RID(0, key)));
+      }
+      std::vector<RID> rids;
+      for (int64_t key = 0; key <= 2 * key_cnt; key++) {
+        rids.clear();
+        index_key.SetFromInteger(key);
+        ASSERT_TRUE(tree.GetValue(index_key, &rids)) << key;
+      }
+      for (int64_t key = 0; key <= 2 * key_cnt; key++) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key, nullptr);
+        rids.clear();
+        ASSERT_FALSE(tree.GetValue(index_key, &rids)) << key;
+      }
+      ASSERT_TRUE(tree.Begin().IsEnd());
+    }
+  }
+}
+
+TEST(BPlusTreeTests, BulkLoadIndexTest) {
+  Schema schema{{Column{"id", TypeId::INTEGER}, Column{"v", TypeId::INTEGER}}};
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  TableHeap table(bpm.get());
+
+  // two rows for every v, the first of them is the one a unique index keeps
+  std::vector<RID> rids;
+  for (int id = 0; id < 200; id++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(id), ValueFactory::GetIntegerValue(id / 2)};
+    auto rid = table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, Tuple{values, &schema});
+    ASSERT_TRUE(rid.has_value());
+    rids.push_back(*rid);
+  }
+
+  // beyond `max_keys` the tuples are inserted one at a time, which has to end in the same index
+  for (size_t max_keys : {size_t{0}, size_t{1}, size_t{57}, size_t{200}, INDEX_BULK_LOAD_MAX_KEYS}) {
+    BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(
+        std::make_unique<IndexMetadata>("t_v", "t", &schema, std::vector<uint32_t>{1}), bpm.get());
+    index.BulkLoad(&table, schema, 0.5, nullptr, max_keys);
+    std::vector<RID> result;
+    for (int v = 0; v < 100; v++) {
+      result.clear();
+      index.ScanKey(Tuple{{ValueFactory::GetIntegerValue(v)}, index.GetKeySchema()}, &result, nullptr);
+      ASSERT_EQ(1, result.size()) << max_keys << " " << v;
+      ASSERT_EQ(rids[2 * v], result[0]) << max_keys << " " << v;
+    }
+  }
+}
+
+TEST(BPlusTreeTests, BeginAtTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id).Drop();
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm.get(), comparator, 3, 4);
+  GenericKey<8> index_key;
+
+  auto before = [](int64_t bound) {
+    return [bound](const GenericKey<8> &key) { return key.ToString() < bound; };
+  };
+  ASSERT_TRUE(tree.BeginAt(before(0)).IsEnd());
+
+  // odd keys only, so every even bound falls between two keys
+  for (int64_t key = 1; key < 200; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+  for (int64_t bound = 0; bound <= 200; bound++) {
+    int64_t current_key = bound % 2 == 0 ? bound + 1 : bound;
+    for (auto iter = tree.BeginAt(before(bound)); !iter.IsEnd(); ++iter) {
+      ASSERT_EQ(current_key, (*iter).first.ToString());
+      current_key += 2;
+    }
+    ASSERT_EQ(201, current_key) << bound;
+  }
+}
+
+TEST(BPlusTreeTests, ReverseIteratorTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id).Drop();
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm.get(), comparator, 3, 4);
+  GenericKey<8> index_key;
+
+  auto after = [](int64_t bound) {
+    return [bound](const GenericKey<8> &key) { return key.ToString() > bound; };
+  };
+  ASSERT_TRUE(tree.RBegin().IsEnd());
+  ASSERT_TRUE(tree.RBeginAt(after(0)).IsEnd());
+
+  // odd keys only, so every even bound falls between two keys
+  for (int64_t key = 1; key < 200; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+  int64_t current_key = 199;
+  for (auto iter = tree.RBegin(); !iter.IsEnd(); ++iter) {
+    ASSERT_EQ(current_key, (*iter).first.ToString());
+    ASSERT_EQ(current_key, (*iter).second.GetSlotNum());
+    current_key -= 2;
+  }
+  ASSERT_EQ(-1, current_key);
+
+  for (int64_t bound = 0; bound <= 200; bound++) {
+    current_key = bound % 2 == 0 ? bound - 1 : bound;
+    for (auto iter = tree.RBeginAt(after(bound)); !iter.IsEnd(); ++iter) {
+      ASSERT_EQ(current_key, (*iter).first.ToString());
+      current_key -= 2;
+    }
+    ASSERT_EQ(-1, current_key) << bound;
+  }
+
+  // separators may outlive their keys, stepping back must still find the previous leaf
+  for (int64_t key = 51; key < 150; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, nullptr);
+  }
+  current_key = 49;
+  for (auto iter = tree.RBeginAt(after(148)); !iter.IsEnd(); ++iter) {
+    ASSERT_EQ(current_key, (*iter).first.ToString());
+    current_key -= 2;
+  }
+  ASSERT_EQ(-1, current_key);
+}
+
+TEST(BPlusTreeTests, IteratorReseekTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id).Drop();
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm.get(), comparator, 3, 4);
+  GenericKey<8> index_key;
+
+  for (int64_t key = 1; key < 200; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+
+  // the iterator holds no latch between steps, so the tree can be changed around it from the same thread: every
+  // visited odd key is removed and its even successor inserted, which splits and merges the leaves under the iterator
+  std::vector<int64_t> visited;
+  for (auto iter = tree.Begin(); !iter.IsEnd(); ++iter) {
+    int64_t key = (*iter).first.ToString();
+    ASSERT_TRUE(visited.empty() || visited.back() < key);
+    visited.push_back(key);
+    if (key % 2 == 1) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, nullptr);
+      index_key.SetFromInteger(key + 1);
+      ASSERT_TRUE(tree.Insert(index_key, RID(0, key + 1)));
+    }
+  }
+  for (int64_t key = 1; key < 200; key += 2) {
+    ASSERT_TRUE(std::binary_search(visited.begin(), visited.end(), key)) << key;
+  }
+
+  int64_t current_key = 2;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    ASSERT_EQ(current_key, (*iter).first.ToString());
+    current_key += 2;
+  }
+  ASSERT_EQ(202, current_key);
+}
+
+TEST(BPlusTreeTests, BatchLookupTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id).Drop();
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm.get(), comparator, 3, 4);
+  GenericKey<8> index_key;
+
+  // probes: every key in [0, 400] twice, shuffled, half of them missing from the tree
+  std::vector<GenericKey<8>> probes;
+  for (int64_t key = 0; key <= 400; key++) {
+    index_key.SetFromInteger(key);
+    probes.push_back(index_key);
+    probes.push_back(index_key);
+  }
+  std::shuffle(probes.begin(), probes.end(), std::mt19937(0));
+  std::vector<std::vector<RID>> result;
+  tree.GetValues(probes, &result);
+  ASSERT_EQ(probes.size(), result.size());
+  for (const auto &rids : result) {
+    ASSERT_TRUE(rids.empty());
+  }
+
+  for (int64_t key = 1; key < 400; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+  // removals leave separators behind whose keys are gone
+  for (int64_t key = 101; key < 200; key += 4) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, nullptr);
+  }
+  tree.GetValues(probes, &result);
+  ASSERT_EQ(probes.size(), result.size());
+  for (size_t i = 0; i < probes.size(); i++) {
+    std::vector<RID> expected;
+    tree.GetValue(probes[i], &expected);
+    ASSERT_EQ(expected, result[i]) << probes[i].ToString();
+  }
+}
+
+TEST(BPlusTreeTests, DuplicateKeyTest) {
+  auto key_schema = ParseCreateStatement("a integer");
+  IntegerComparator<16, int32_t> comparator(key_schema.get(), true);
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id).Drop();
+  BPlusTree<GenericKey<16>, RID, IntegerComparator<16, int32_t>> tree("foo_pk", page_id, bpm.get(), comparator, 3, 4);
+
+  // ten copies of each of the keys 0..19, told apart only by their RIDs
+  GenericKey<16> index_key;
+  for (int32_t copy = 0; copy < 10; copy++) {
+    for (int32_t key = 19; key >= 0; key--) {
+      Tuple tuple{{ValueFactory::GetIntegerValue(key)}, key_schema.get()};
+      RID rid(key, copy);
+      index_key.SetFromKey(tuple);
+      index_key.SetRid(rid);
+      ASSERT_TRUE(tree.Insert(index_key, rid));
+    }
+  }
+  // the same key and RID is still a duplicate
+  ASSERT_FALSE(tree.Insert(index_key, index_key.GetRid()));
+
+  // the iterator yields every copy, grouped by key and ordered by RID within a key
+  int count = 0;
+  for (auto iter = tree.Begin(); !iter.IsEnd(); ++iter, ++count) {
+    RID expected(count / 10, count % 10);
+    ASSERT_EQ(expected, (*iter).second);
+    ASSERT_EQ(expected, (*iter).first.GetRid());
+  }
+  ASSERT_EQ(200, count);
+
+  // removing one copy keeps the others
+  Tuple tuple{{ValueFactory::GetIntegerValue(7)}, key_schema.get()};
+  index_key.SetFromKey(tuple);
+  index_key.SetRid(RID(7, 3));
+  tree.Remove(index_key, nullptr);
+  std::vector<RID> rids;
+  ASSERT_FALSE(tree.GetValue(index_key, &rids));
+  index_key.SetRid(RID(7, 4));
+  ASSERT_TRUE(tree.GetValue(index_key, &rids));
+}
+
+TEST(BPlusTreeTests, KeyCompressionTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  using Tree = BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+  using InternalPage = BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+  // entries a page holds at the full key width
+  const size_t leaf_page_size = (BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (sizeof(GenericKey<64>) + sizeof(RID));
+
+  // visit every page below `page_id`
+  std::function<void(page_id_t, const std::function<void(const BPlusTreePage *)> &)> visit =
+      [&](page_id_t page_id, const std::function<void(const BPlusTreePage *)> &fn) {
+        auto guard = bpm->FetchPageRead(page_id);
+        auto *page = guard.As<BPlusTreePage>();
+        fn(page);
+        if (!page->IsLeafPage()) {
+          auto *internal = guard.As<InternalPage>();
+          for (int i = 0; i < internal->GetSize(); i++) {
+            visit(internal->ValueAt(i), fn);
+          }
+        }
+      };
+
+  // small integers leave most of a 64 byte key zero, leaves store the few bytes that differ
+  {
+    auto key_schema = ParseCreateStatement("a bigint");
+    GenericComparator<64> comparator(key_schema.get());
+    page_id_t page_id;
+    bpm->NewPageGuarded(&page_id).Drop();
+    Tree tree("foo_pk", page_id, bpm.get(), comparator);
+    std::vector<int64_t> keys(2000);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(34));
+    GenericKey<64> index_key;
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      ASSERT_TRUE(tree.Insert(index_key, RID(0, key)));
+    }
+    size_t max_leaf_size = 0;
+    visit(tree.GetRootPageId(), [&](const BPlusTreePage *page) {
+      if (page->IsLeafPage()) {
+        ASSERT_LE(page->GetKeyWidth(), 2);
+        max_leaf_size = std::max(max_leaf_size, static_cast<size_t>(page->GetSize()));
+      }
+    });
+    ASSERT_GT(max_leaf_size, leaf_page_size);
+    int64_t current_key = 0;
+    for (auto iter = tree.Begin(); iter != tree.End(); ++iter, ++current_key) {
+      ASSERT_EQ(current_key, (*iter).first.ToString());
+    }
+    ASSERT_EQ(2000, current_key);
+  }
+
+  // strings sharing a long prefix and differing early: leaves drop the prefix, separators the rest of the string
+  auto key_schema = ParseCreateStatement("a varchar(40)");
+  GenericComparator<64> comparator(key_schema.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id).Drop();
+  Tree tree("foo_pk", page_id, bpm.get(), comparator);
+  auto make_key = [&key_schema](int i) {
+    char name[16];
+    snprintf(name, sizeof(name), "user_%05d_", i);
+    Tuple tuple{{ValueFactory::GetVarcharValue(std::string(name) + std::string(25, 'x'))}, key_schema.get()};
+    GenericKey<64> key;
+    key.SetFromKey(tuple);
+    return key;
+  };
+  const int key_cnt = 5000;
+  const size_t key_size = KeyLayout<GenericKey<64>>::SignificantSize(make_key(0));
+  std::vector<int> keys(key_cnt);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(340));
+  for (auto i : keys) {
+    ASSERT_TRUE(tree.Insert(make_key(i), RID(0, i)));
+  }
+  ASSERT_FALSE(tree.Insert(make_key(17), RID(1, 17)));
+
+  int internal_cnt = 0;
+  visit(tree.GetRootPageId(), [&](const BPlusTreePage *page) {
+    if (page->IsLeafPage()) {
+      // the offset and length of the string and "user_" at least
+      ASSERT_GE(page->GetPrefixSize(), 13);
+      return;
+    }
+    internal_cnt++;
+    auto *internal = reinterpret_cast<const InternalPage *>(page);
+    ASSERT_LT(internal->GetPrefixSize() + internal->GetKeyWidth(), key_size);
+    for (int i = 1; i < internal->GetSize(); i++) {
+      ASSERT_LT(KeyLayout<GenericKey<64>>::SignificantSize(internal->KeyAt(i)), key_size);
+    }
+  });
+  ASSERT_GT(internal_cnt, 0);
+
+  // lookups, scans and removals see the keys the way they were inserted
+  std::vector<RID> rids;
+  for (int i = 0; i < key_cnt; i++) {
+    rids.clear();
+    ASSERT_TRUE(tree.GetValue(make_key(i), &rids)) << i;
+    ASSERT_EQ(RID(0, i), rids[0]);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(3400));
+  for (int i = 0; i < key_cnt / 2; i++) {
+    tree.Remove(make_key(keys[i]), nullptr);
+  }
+  std::sort(keys.begin() + key_cnt / 2, keys.end());
+  int pos = key_cnt / 2;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter, ++pos) {
+    ASSERT_LT(pos, key_cnt);
+    ASSERT_EQ(0, comparator((*iter).first, make_key(keys[pos])));
+    ASSERT_EQ(RID(0, keys[pos]), (*iter).second);
+  }
+  ASSERT_EQ(key_cnt, pos);
+  for (int i = 0; i < key_cnt / 2; i++) {
+    rids.clear();
+    ASSERT_FALSE(tree.GetValue(make_key(keys[i]), &rids));
+    ASSERT_TRUE(tree.Insert(make_key(keys[i]), RID(0, keys[i])));
+  }
+  for (int i = 0; i < key_cnt; i++) {
+    tree.Remove(make_key(i), nullptr);
+  }
+  ASSERT_TRUE(tree.Begin().IsEnd());
+}
 }  // namespace bustub
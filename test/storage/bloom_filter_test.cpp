@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter_test.cpp
+//
+// Identification: test/storage/bloom_filter_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/index/bloom_filter.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BloomFilterTest, FalsePositiveTest) {
+  BloomFilter filter(10000);
+  for (int64_t key = 0; key < 10000; key++) {
+    filter.Insert(static_cast<hash_t>(key));
+  }
+  EXPECT_FALSE(filter.IsOverloaded());
+  for (int64_t key = 0; key < 10000; key++) {
+    ASSERT_TRUE(filter.MayContain(static_cast<hash_t>(key))) << key;
+  }
+  // about 1% at 10 bits per key, the blocking costs a little on top of that
+  int false_positives = 0;
+  for (int64_t key = 10000; key < 110000; key++) {
+    false_positives += filter.MayContain(static_cast<hash_t>(key)) ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, 3000);
+
+  filter.Insert(hash_t{110000});
+  EXPECT_TRUE(filter.IsOverloaded());
+}
+
+// NOLINTNEXTLINE
+TEST(BloomFilterTest, IndexScanKeyTest) {
+  auto table_schema = ParseCreateStatement("a bigint");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto metadata = std::make_unique<IndexMetadata>("foo_pk", "foo", table_schema.get(), std::vector<uint32_t>{0});
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(std::move(metadata), bpm.get());
+  auto make_key = [&](int64_t key) { return Tuple({ValueFactory::GetBigIntValue(key)}, index.GetKeySchema()); };
+
+  // even keys before the filter is enabled, odd ones after, enough of them to outgrow the first filter
+  for (int64_t key = 0; key < 1000; key += 2) {
+    ASSERT_TRUE(index.InsertEntry(make_key(key), RID(0, key), nullptr));
+  }
+  index.EnableBloomFilter();
+  for (int64_t key = 1; key < 6000; key += 2) {
+    ASSERT_TRUE(index.InsertEntry(make_key(key), RID(0, key), nullptr));
+  }
+  index.DeleteEntry(make_key(500), RID(0, 500), nullptr);
+
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < 12000; key++) {
+    rids.clear();
+    index.ScanKey(make_key(key), &rids, nullptr);
+    bool present = key < 6000 && (key % 2 == 1 || key < 1000) && key != 500;
+    ASSERT_EQ(present ? 1U : 0U, rids.size()) << key;
+  }
+
+  std::vector<Tuple> keys{make_key(3), make_key(500), make_key(7000), make_key(998)};
+  std::vector<std::vector<RID>> results;
+  index.ScanKeys(keys, &results, nullptr);
+  ASSERT_EQ(4U, results.size());
+  EXPECT_EQ(std::vector<RID>{RID(0, 3)}, results[0]);
+  EXPECT_TRUE(results[1].empty());
+  EXPECT_TRUE(results[2].empty());
+  EXPECT_EQ(std::vector<RID>{RID(0, 998)}, results[3]);
+}
+
+}  // namespace bustub
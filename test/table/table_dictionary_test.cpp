@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_dictionary_test.cpp
+//
+// Identification: test/table/table_dictionary_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_dictionary.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TableDictionaryTest, EncodeDecodeTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"status", TypeId::VARCHAR, 128};
+  col2.SetDictionaryEncoded(true);
+  Column col3{"comment", TypeId::VARCHAR, 128};
+  Schema schema{{col1, col2, col3}};
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  TableDictionary dictionary(bpm.get(), schema);
+  EXPECT_FALSE(dictionary.IsEncoded(0));
+  EXPECT_TRUE(dictionary.IsEncoded(1));
+  EXPECT_FALSE(dictionary.IsEncoded(2));
+  EXPECT_EQ(TypeId::INTEGER, dictionary.GetStorageSchema().GetColumn(1).GetType());
+  EXPECT_TRUE(dictionary.GetStorageSchema().GetColumn(1).IsInlined());
+
+  // the same string always gets the same code
+  EXPECT_EQ(0, dictionary.Encode("open"));
+  EXPECT_EQ(1, dictionary.Encode("closed"));
+  EXPECT_EQ(0, dictionary.Encode("open"));
+  EXPECT_EQ(2, dictionary.Size());
+  EXPECT_EQ("closed", dictionary.Decode(1));
+  EXPECT_EQ(1, dictionary.Lookup("closed"));
+  EXPECT_FALSE(dictionary.Lookup("pending").has_value());
+
+  std::vector<Value> values{ValueFactory::GetIntegerValue(42), ValueFactory::GetVarcharValue("pending"),
+                            ValueFactory::GetVarcharValue("hello")};
+  Tuple tuple{values, &schema};
+  auto stored = dictionary.EncodeTuple(tuple);
+  EXPECT_EQ(2, stored.GetValue(&dictionary.GetStorageSchema(), 1).GetAs<int32_t>());
+  auto decoded = dictionary.DecodeTuple(stored);
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    EXPECT_EQ(CmpBool::CmpTrue, decoded.GetValue(&schema, i).CompareEquals(values[i]));
+  }
+
+  // nulls stay nulls and never take a code
+  std::vector<Value> null_values{ValueFactory::GetIntegerValue(1), ValueFactory::GetNullValueByType(TypeId::VARCHAR),
+                                 ValueFactory::GetVarcharValue("x")};
+  auto null_decoded = dictionary.DecodeTuple(dictionary.EncodeTuple(Tuple{null_values, &schema}));
+  EXPECT_TRUE(null_decoded.GetValue(&schema, 1).IsNull());
+  EXPECT_EQ(3, dictionary.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(TableDictionaryTest, PersistTest) {
+  Column col{"name", TypeId::VARCHAR, 1024};
+  col.SetDictionaryEncoded(true);
+  Schema schema{{col}};
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  page_id_t first_page_id;
+  {
+    TableDictionary dictionary(bpm.get(), schema);
+    first_page_id = dictionary.GetFirstPageId();
+    // long entries so that the dictionary spans several pages
+    for (int i = 0; i < 100; i++) {
+      EXPECT_EQ(i, dictionary.Encode(std::to_string(i) + std::string(200, 'x')));
+    }
+  }
+
+  TableDictionary reopened(bpm.get(), schema, first_page_id);
+  EXPECT_EQ(100, reopened.Size());
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(std::to_string(i) + std::string(200, 'x'), reopened.Decode(i));
+  }
+  EXPECT_EQ(100, reopened.Encode("new"));
+}
+
+// NOLINTNEXTLINE
+TEST(TableDictionaryTest, TableHeapTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"country", TypeId::VARCHAR, 128};
+  col2.SetDictionaryEncoded(true);
+  Schema schema{{col1, col2}};
+  std::vector<std::string> countries{"Germany", "France", "Japan"};
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  table->EnableDictionary(schema);
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 1000; ++i) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(countries[i % 3])};
+    auto rid = table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, Tuple{values, &schema});
+    ASSERT_TRUE(rid.has_value());
+    rids.push_back(*rid);
+  }
+  EXPECT_EQ(3, table->GetDictionary()->Size());
+
+  // reads go through the dictionary, views expose the stored codes
+  for (int i = 0; i < 1000; ++i) {
+    auto [meta, tuple] = table->GetTuple(rids[i]);
+    EXPECT_EQ(rids[i], tuple.GetRid());
+    EXPECT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(countries[i % 3], tuple.GetValue(&schema, 1).ToString());
+
+    ReadPageGuard guard;
+    auto [view_meta, view] = table->GetTupleView(rids[i], &guard);
+    EXPECT_EQ(i % 3, view.GetValue(&table->GetDictionary()->GetStorageSchema(), 1).GetAs<int32_t>());
+  }
+}
+
+}  // namespace bustub
@@ -12,15 +12,21 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_arena.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -61,4 +67,74 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, TupleViewTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::VARCHAR, 16};
+  Column col3{"c", TypeId::BIGINT};
+  Schema schema{{col1, col2, col3}};
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 100; ++i) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i)),
+                              ValueFactory::GetBigIntValue(i * 10)};
+    auto rid = table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, Tuple{values, &schema});
+    ASSERT_TRUE(rid.has_value());
+    rids.push_back(*rid);
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    ReadPageGuard guard;
+    auto [meta, view] = table->GetTupleView(rids[i], &guard);
+    EXPECT_FALSE(meta.is_deleted_);
+    EXPECT_EQ(rids[i], view.GetRid());
+    EXPECT_EQ(i, view.GetValue(&schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(std::to_string(i), view.GetValue(&schema, 1).ToString());
+    EXPECT_EQ(i * 10, view.GetValue(&schema, 2).GetAs<int64_t>());
+
+    // the materialized tuple is byte-for-byte the tuple stored in the heap
+    auto tuple = view.Materialize();
+    auto expected = table->GetTuple(rids[i]).second;
+    ASSERT_EQ(expected.GetLength(), tuple.GetLength());
+    EXPECT_EQ(0, memcmp(expected.GetData(), tuple.GetData(), tuple.GetLength()));
+    EXPECT_EQ(rids[i], tuple.GetRid());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TupleStorageTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::VARCHAR, 128};
+  Schema schema{{col1, col2}};
+  TupleArena arena;
+
+  // short tuples are stored inline and never touch the arena
+  Tuple small{{ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue("x")}, &schema, &arena};
+  EXPECT_EQ(0, arena.BytesAllocated());
+  EXPECT_EQ("x", small.GetValue(&schema, 1).ToString());
+
+  // long tuples go to the arena when one is given
+  std::string long_str(100, 'y');
+  Tuple large{{ValueFactory::GetIntegerValue(2), ValueFactory::GetVarcharValue(long_str)}, &schema, &arena};
+  EXPECT_GE(arena.BytesAllocated(), large.GetLength());
+  EXPECT_EQ(long_str, large.GetValue(&schema, 1).ToString());
+
+  // moves keep the arena backing, copies own their bytes and survive an arena reset
+  Tuple moved = std::move(large);
+  EXPECT_EQ(long_str, moved.GetValue(&schema, 1).ToString());
+  Tuple copied = moved;
+  Tuple copied_small = small;
+  arena.Reset();
+  EXPECT_EQ(0, arena.BytesAllocated());
+  Tuple overwrite{{ValueFactory::GetIntegerValue(3), ValueFactory::GetVarcharValue(std::string(100, 'z'))}, &schema,
+                  &arena};
+  EXPECT_EQ(2, copied.GetValue(&schema, 0).GetAs<int32_t>());
+  EXPECT_EQ(long_str, copied.GetValue(&schema, 1).ToString());
+  EXPECT_EQ("x", copied_small.GetValue(&schema, 1).ToString());
+}
+
 }  // namespace bustub
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map_test.cpp
+//
+// Identification: test/table/zone_map_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/zone_map.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ZoneMapTest, InsertTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::VARCHAR, 128};
+  Column col3{"c", TypeId::BIGINT};
+  Schema schema{{col1, col2, col3}};
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(10, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  table->EnableZoneMap(schema);
+  const auto *zone_map = table->GetZoneMap();
+  ASSERT_NE(nullptr, zone_map);
+  EXPECT_TRUE(zone_map->IsTracked(0));
+  EXPECT_FALSE(zone_map->IsTracked(1));
+  EXPECT_TRUE(zone_map->IsTracked(2));
+
+  // insert ascending keys until they spill over several pages, every 10th c is NULL
+  std::vector<RID> rids;
+  for (int i = 0; i < 1000; ++i) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(64, 'x')),
+                              i % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                                          : ValueFactory::GetBigIntValue(-i)};
+    auto rid = table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, Tuple{values, &schema});
+    ASSERT_TRUE(rid.has_value());
+    rids.push_back(*rid);
+  }
+  ASSERT_NE(rids.front().GetPageId(), rids.back().GetPageId());
+
+  // the zone of each page is exactly the range of keys inserted into it
+  page_id_t page_id = rids.front().GetPageId();
+  int first = 0;
+  for (int i = 0; i <= 1000; ++i) {
+    if (i != 1000 && rids[i].GetPageId() == page_id) {
+      continue;
+    }
+    auto zone = zone_map->GetColumnZone(page_id, 0);
+    ASSERT_TRUE(zone.has_value());
+    EXPECT_TRUE(zone->has_range_);
+    EXPECT_EQ(first, zone->min_.GetAs<int32_t>());
+    EXPECT_EQ(i - 1, zone->max_.GetAs<int32_t>());
+    EXPECT_EQ(0, zone->null_count_);
+
+    auto nullable_zone = zone_map->GetColumnZone(page_id, 2);
+    ASSERT_TRUE(nullable_zone.has_value());
+    EXPECT_EQ(static_cast<uint32_t>((i - 1) / 10 - (first + 9) / 10 + 1), nullable_zone->null_count_);
+    EXPECT_LE(nullable_zone->max_.GetAs<int64_t>(), -first);
+
+    EXPECT_FALSE(zone_map->GetColumnZone(page_id, 1).has_value());
+    if (i != 1000) {
+      page_id = rids[i].GetPageId();
+      first = i;
+    }
+  }
+
+  EXPECT_FALSE(zone_map->GetColumnZone(INVALID_PAGE_ID, 0).has_value());
+}
+
+}  // namespace bustub
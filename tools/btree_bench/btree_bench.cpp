@@ -20,9 +20,12 @@
 #include "common/util/string_util.h"
 #include "fmt/format.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/index/art_index.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/index/generic_key.h"
 #include "test_util.h"
+#include "type/value_factory.h"
 
 #include <sys/time.h>
 
@@ -110,51 +113,70 @@ auto KeyWillVanish(size_t key) -> bool { return key % 7 == 0; }
 // These keys will be overwritten to a new value
 auto KeyWillChange(size_t key) -> bool { return key % 5 == 0; }
 
-// NOLINTNEXTLINE
-auto main(int argc, char **argv) -> int {
-  using bustub::AccessType;
-  using bustub::BufferPoolManager;
-  using bustub::DiskManagerUnlimitedMemory;
-  using bustub::page_id_t;
+/** The bare B+ tree, probed with GenericKey<8> directly. */
+class BPlusTreeBench {
+ public:
+  explicit BPlusTreeBench(bustub::BufferPoolManager *bpm, bustub::Schema *key_schema)
+      : comparator_(key_schema), tree_("foo_pk", NewHeaderPage(bpm), bpm, comparator_) {}
 
-  argparse::ArgumentParser program("bustub-btree-bench");
-  program.add_argument("--duration").help("run btree bench for n milliseconds");
+  void Insert(size_t key, bustub::RID rid) {
+    bustub::GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    tree_.Insert(index_key, rid, nullptr);
+  }
 
-  try {
-    program.parse_args(argc, argv);
-  } catch (const std::runtime_error &err) {
-    std::cerr << err.what() << std::endl;
-    std::cerr << program;
-    return 1;
+  void Remove(size_t key) {
+    bustub::GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    tree_.Remove(index_key, nullptr);
   }
 
-  uint64_t duration_ms = 30000;
-  if (program.present("--duration")) {
-    duration_ms = std::stoi(program.get("--duration"));
+  void GetValue(size_t key, std::vector<bustub::RID> *rids) {
+    bustub::GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    tree_.GetValue(index_key, rids);
   }
 
-  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
-  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+ private:
+  static auto NewHeaderPage(bustub::BufferPoolManager *bpm) -> bustub::page_id_t {
+    bustub::page_id_t page_id;
+    auto header_page = bpm->NewPageGuarded(&page_id);
+    return page_id;
+  }
 
-  fmt::print(stderr, "[info] total_keys={}, duration_ms={}, lru_k_size={}, bpm_size={}\n", TOTAL_KEYS, duration_ms,
-             LRU_K_SIZE, BUSTUB_BPM_SIZE);
+  bustub::IntegerComparator<8, int64_t> comparator_;
+  bustub::BPlusTree<bustub::GenericKey<8>, bustub::RID, bustub::IntegerComparator<8, int64_t>> tree_;
+};
 
-  auto key_schema = bustub::ParseCreateStatement("a bigint");
-  bustub::GenericComparator<8> comparator(key_schema.get());
+/** An index probed through the Index interface with key tuples, the way executors use it. */
+class IndexBench {
+ public:
+  explicit IndexBench(std::unique_ptr<bustub::Index> index) : index_(std::move(index)) {}
+
+  void Insert(size_t key, bustub::RID rid) { index_->InsertEntry(MakeKey(key), rid, nullptr); }
 
-  page_id_t page_id;
-  auto header_page = bpm->NewPageGuarded(&page_id);
+  void Remove(size_t key) { index_->DeleteEntry(MakeKey(key), bustub::RID(), nullptr); }
 
-  bustub::BPlusTree<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>> index("foo_pk", page_id,
-                                                                                            bpm.get(), comparator);
+  void GetValue(size_t key, std::vector<bustub::RID> *rids) { index_->ScanKey(MakeKey(key), rids, nullptr); }
+
+ private:
+  auto MakeKey(size_t key) -> bustub::Tuple {
+    return bustub::Tuple({bustub::ValueFactory::GetBigIntValue(key)}, index_->GetKeySchema());
+  }
+
+  std::unique_ptr<bustub::Index> index_;
+};
+
+/** Load TOTAL_KEYS keys into `index`, then run the read and write threads against it for `duration_ms`. */
+template <typename BenchIndex>
+void RunBench(BenchIndex &index, uint64_t duration_ms) {
+  using bustub::RID;
 
   for (size_t key = 0; key < TOTAL_KEYS; key++) {
-    bustub::GenericKey<8> index_key;
-    bustub::RID rid;
+    RID rid;
     uint32_t value = key;
     rid.Set(value, value);
-    index_key.SetFromInteger(key);
-    index.Insert(index_key, rid, nullptr);
+    index.Insert(key, rid);
   }
 
   fmt::print(stderr, "[info] benchmark start\n");
@@ -175,16 +197,14 @@ auto main(int argc, char **argv) -> int {
       std::default_random_engine gen(r());
       std::uniform_int_distribution<size_t> dis(key_start, key_end - 1);
 
-      bustub::GenericKey<8> index_key;
-      std::vector<bustub::RID> rids;
+      std::vector<RID> rids;
 
       while (!metrics.ShouldFinish()) {
         auto base_key = dis(gen);
         size_t cnt = 0;
         for (auto key = base_key; key < key_end && cnt < KEY_MODIFY_RANGE; key++, cnt++) {
           rids.clear();
-          index_key.SetFromInteger(key);
-          index.GetValue(index_key, &rids);
+          index.GetValue(key, &rids);
 
           if (!KeyWillVanish(key) && rids.empty()) {
             std::string msg = fmt::format("key not found: {}", key);
@@ -221,8 +241,7 @@ auto main(int argc, char **argv) -> int {
       std::default_random_engine gen(r());
       std::uniform_int_distribution<size_t> dis(key_start, key_end - 1);
 
-      bustub::GenericKey<8> index_key;
-      bustub::RID rid;
+      RID rid;
 
       bool do_insert = false;
 
@@ -233,19 +252,17 @@ auto main(int argc, char **argv) -> int {
           if (KeyWillVanish(key)) {
             uint32_t value = key;
             rid.Set(value, value);
-            index_key.SetFromInteger(key);
             if (do_insert) {
-              index.Insert(index_key, rid, nullptr);
+              index.Insert(key, rid);
             } else {
-              index.Remove(index_key, nullptr);
+              index.Remove(key);
             }
             metrics.Tick();
             metrics.Report();
           } else if (KeyWillChange(key)) {
             uint32_t value = key;
             rid.Set(value, dis(gen));
-            index_key.SetFromInteger(key);
-            index.Insert(index_key, rid, nullptr);
+            index.Insert(key, rid);
             metrics.Tick();
             metrics.Report();
           }
@@ -262,6 +279,63 @@ auto main(int argc, char **argv) -> int {
   }
 
   total_metrics.Report();
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  using bustub::AccessType;
+  using bustub::BufferPoolManager;
+  using bustub::DiskManagerUnlimitedMemory;
+  using bustub::page_id_t;
+
+  argparse::ArgumentParser program("bustub-btree-bench");
+  program.add_argument("--duration").help("run btree bench for n milliseconds");
+  program.add_argument("--index")
+      .help("bplustree (the bare tree), btree (BPlusTreeIndex) or art (ArtIndex), the last two through Index")
+      .default_value(std::string("bplustree"));
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t duration_ms = 30000;
+  if (program.present("--duration")) {
+    duration_ms = std::stoi(program.get("--duration"));
+  }
+  auto index_kind = program.get<std::string>("--index");
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+
+  fmt::print(stderr, "[info] index={}, total_keys={}, duration_ms={}, lru_k_size={}, bpm_size={}\n", index_kind,
+             TOTAL_KEYS, duration_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE);
+
+  auto key_schema = bustub::ParseCreateStatement("a bigint");
+
+  if (index_kind == "bplustree") {
+    BPlusTreeBench index(bpm.get(), key_schema.get());
+    RunBench(index, duration_ms);
+    return 0;
+  }
+
+  auto metadata = std::make_unique<bustub::IndexMetadata>("foo_pk", "foo", key_schema.get(), std::vector<uint32_t>{0});
+  std::unique_ptr<bustub::Index> index;
+  if (index_kind == "btree") {
+    index = std::make_unique<
+        bustub::BPlusTreeIndex<bustub::GenericKey<8>, bustub::RID, bustub::IntegerComparator<8, int64_t>>>(
+        std::move(metadata), bpm.get());
+  } else if (index_kind == "art") {
+    index = std::make_unique<bustub::ArtIndex>(std::move(metadata));
+  } else {
+    std::cerr << "unknown index " << index_kind << std::endl;
+    return 1;
+  }
+  IndexBench bench(std::move(index));
+  RunBench(bench, duration_ms);
 
   return 0;
 }
@@ -0,0 +1,122 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "common/bustub_instance.h"
+#include "common/exception.h"
+#include "fmt/core.h"
+
+/*
+ * Counts heap allocations made while running the p3 leaderboard queries. The global allocation functions are
+ * replaced in this binary only, so the numbers include every allocation made by the planner, optimizer and
+ * executors for the measured statement.
+ */
+
+static std::atomic<uint64_t> alloc_cnt{0};    // NOLINT
+static std::atomic<uint64_t> alloc_bytes{0};  // NOLINT
+
+auto operator new(std::size_t size) -> void * {
+  alloc_cnt.fetch_add(1, std::memory_order_relaxed);
+  alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size); ptr != nullptr) {  // NOLINT
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+auto operator new[](std::size_t size) -> void * { return operator new(size); }
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }  // NOLINT
+
+void operator delete[](void *ptr) noexcept { std::free(ptr); }  // NOLINT
+
+void operator delete(void *ptr, std::size_t size) noexcept { std::free(ptr); }  // NOLINT
+
+void operator delete[](void *ptr, std::size_t size) noexcept { std::free(ptr); }  // NOLINT
+
+namespace {
+
+struct Query {
+  std::string name_;
+  std::vector<std::string> setup_;
+  std::string sql_;
+};
+
+auto LeaderboardQueries() -> std::vector<Query> {
+  return {
+      {"q1",
+       {"create table t1(x int, y int, z int);", "create index t1xy on t1(x, y);",
+        "INSERT INTO t1 SELECT * FROM __mock_t1;"},
+       "select * from t1 where x >= 90 and y = 10;"},
+      {"q2",
+       {},
+       "select count(*), max(__mock_t4_1m.x), max(__mock_t4_1m.y), max(__mock_t5_1m.x), max(__mock_t5_1m.y), "
+       "max(__mock_t6_1m.x), max(__mock_t6_1m.y) from __mock_t4_1m, __mock_t5_1m, __mock_t6_1m "
+       "where (__mock_t4_1m.x = __mock_t5_1m.x) and (__mock_t6_1m.y = __mock_t5_1m.y) "
+       "and (__mock_t4_1m.y >= 1000000) and (__mock_t4_1m.y < 1500000) "
+       "and (__mock_t6_1m.x < 150000) and (__mock_t6_1m.x >= 100000);"},
+      {"q3",
+       {},
+       "select v, d1, d2 from (select v, max(v1) as d1, max(v1) + max(v1) + max(v2) as d2, "
+       "min(v1), max(v2), min(v2), max(v1) + min(v1), max(v2) + min(v2), min(v1), max(v2), min(v2), "
+       "max(v1) + min(v1), max(v2) + min(v2), min(v1), max(v2), min(v2), max(v1) + min(v1), max(v2) + min(v2), "
+       "min(v1), max(v2), min(v2), max(v1) + min(v1), max(v2) + min(v2), min(v1), max(v2), min(v2), "
+       "max(v1) + min(v1), max(v2) + min(v2), min(v1), max(v2), min(v2), max(v1) + min(v1), max(v2) + min(v2), "
+       "min(v1), max(v2), min(v2), max(v1) + min(v1), max(v2) + min(v2), min(v1), max(v2), min(v2), "
+       "max(v1) + min(v1), max(v2) + min(v2) "
+       "from __mock_t7 left join (select v4 from __mock_t8 where 1 == 2) on v < v4 group by v);"},
+  };
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-tuple-bench");
+  program.add_argument("--rounds").help("run each query n times");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t rounds = 1;
+  if (program.present("--rounds")) {
+    rounds = std::stoi(program.get("--rounds"));
+  }
+
+  auto bustub = std::make_unique<bustub::BustubInstance>();
+  bustub->GenerateMockTable();
+
+  fmt::print("<<< BEGIN\n");
+  for (const auto &query : LeaderboardQueries()) {
+    bustub::NoopWriter writer;
+    for (const auto &sql : query.setup_) {
+      bustub->ExecuteSql(sql, writer);
+    }
+
+    auto start_cnt = alloc_cnt.load();
+    auto start_bytes = alloc_bytes.load();
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < rounds; i++) {
+      bustub->ExecuteSql(query.sql_, writer);
+    }
+    auto elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    fmt::print("{}: allocs={} bytes={} time={}ms\n", query.name_, (alloc_cnt.load() - start_cnt) / rounds,
+               (alloc_bytes.load() - start_bytes) / rounds, elapsed / static_cast<int64_t>(rounds));
+  }
+  fmt::print(">>> END\n");
+
+  return 0;
+}